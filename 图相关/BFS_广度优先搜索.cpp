@@ -18,7 +18,6 @@
 #include "vertex.h"
 #include <cassert>
 #include <queue>
-typedef void (*Callback)(vertex*);
 
 // 假设一个无向图是连通的，给定一个图的顶点，进行广度优先搜索, 就可以把所有顶点都遍历完成。
 void BreadthFirstSearch(vertex* pVertex_, Callback pFunc_)
@@ -26,15 +25,16 @@ void BreadthFirstSearch(vertex* pVertex_, Callback pFunc_)
 	if (!pVertex_)
 		return;
 
+	// 顶点在入队时就标记为已搜索，否则一个顶点可能被多个邻居重复加入队列中。
 	std::queue<vertex*> _queue;
 	_queue.push(pVertex_);
+	pVertex_->m_bSearched = true;
 
 	while (!_queue.empty())
 	{
 		// 获取队列元素, 并使用回调函数进行处理。
 		vertex* _pCurrent = _queue.front();
 		pFunc_(_pCurrent);
-		_pCurrent->m_bSearched = true;
 		_queue.pop();
 
 		// 把与该顶点相连的顶点添加至队列中。
@@ -43,15 +43,21 @@ void BreadthFirstSearch(vertex* pVertex_, Callback pFunc_)
 		{
 			// 如果没有被遍历，则加入到队列中。
 			if (!(*_it)->m_bSearched)
+			{
+				(*_it)->m_bSearched = true;
 				_queue.push(*_it);
+			}
 		}
 	}
 }
 
 
 /**********************    测试程序     *************************/
+// 编译时定义宏GRAPH_NO_MAIN可以去掉测试程序，以便与其它程序链接在一起
+#ifndef GRAPH_NO_MAIN
 int main(int argc, char* argv[])
 {
 	return 0;
 }
+#endif	// GRAPH_NO_MAIN
 
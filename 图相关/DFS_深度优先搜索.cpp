@@ -17,7 +17,6 @@
 ***********************************************************************/
 #include "vertex.h"
 #include <cassert>
-typedef void (*Callback)(vertex*);
 
 // 假设一个无向图是连通的，给定一个图的顶点，进行深度优先搜索, 就可以把所有顶点都遍历完成。
 // 为了程序简单，使用递归来完成。
@@ -41,8 +40,11 @@ void DepthFirstSearch(vertex* pVertex_, Callback pFunc_)
 }
 
 /**********************    测试程序     *************************/
+// 编译时定义宏GRAPH_NO_MAIN可以去掉测试程序，以便与其它程序链接在一起
+#ifndef GRAPH_NO_MAIN
 int main(int argc, char* argv[])
 {
 	return 0;
 }
+#endif	// GRAPH_NO_MAIN
 
@@ -24,3 +24,9 @@ struct vertex
 	bool m_bSearched;			// 该结点是否被搜索过
 	std::list<vertex*> m_listAdjacent;		// 与该顶点相连的邻居顶点
 };
+
+// BFS_广度优先搜索.cpp与DFS_深度优先搜索.cpp中的搜索函数，编译时定义宏GRAPH_NO_MAIN可以去掉其中
+// 的测试程序，以便与其它程序链接在一起。
+typedef void (*Callback)(vertex*);
+void BreadthFirstSearch(vertex* pVertex_, Callback pFunc_);
+void DepthFirstSearch(vertex* pVertex_, Callback pFunc_);
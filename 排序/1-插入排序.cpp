@@ -17,6 +17,7 @@
 ***********************************************************************/
 
 #include <iostream>
+#include "sort_stats.h"
 // 插入排序的实现(insertion-sort)
 // 思想：1. 首先从待排序的数组中选择一个数作为初始有序状态的序列；
 //       2. 然后再从数组中选择下一个数，插入到有序序列中的合适位置，使新的序列也是有序的;
@@ -35,20 +36,24 @@ void insertion_sort(int array[], size_t nLength_)
 	for (size_t i = 1; i < nLength_; ++i)	// 注意：i是从1开始
 	{
 		int _nCurrent = array[i];		// 当前待排序的数字
+		SORT_COUNT_MOVE(1);
 
 		// 此时，下标为 0 ~ i-1的数字是有序的. 向后移动比当前序数字大的所有数，为该数腾出一个位置来。
 		int _nLessEqualIndex = i - 1;
-		while (_nLessEqualIndex >= 0 && array[_nLessEqualIndex] > _nCurrent)
+		while (_nLessEqualIndex >= 0 && SORT_COMPARE(array[_nLessEqualIndex] > _nCurrent))
 		{
 			array[_nLessEqualIndex + 1] = array[_nLessEqualIndex];
+			SORT_COUNT_MOVE(1);
 			--_nLessEqualIndex;
 		}
 		// 把新数插入到合适的位置
 		array[_nLessEqualIndex + 1] = _nCurrent;
+		SORT_COUNT_MOVE(1);
 	}
 }
 
 
+#ifndef SORT_NO_MAIN
 // 该函数实现输出数组内的元素。
 void PrintArray(int array[], size_t nLength_)
 {
@@ -73,7 +78,8 @@ int main(int argc, char* argv[])
 
 	std::cout << "排序后：" << std::endl;
 	PrintArray(array, 10);
+	SORT_PRINT_STATS(std::cout);
 
 	return 0;
 }
-
+#endif	// SORT_NO_MAIN
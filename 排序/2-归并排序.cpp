@@ -36,6 +36,7 @@
 //
 #include <cstring>
 #include <iostream>
+#include "sort_stats.h"
 typedef bool(*CompareFunc)(int, int);
 
 // 下面函数实现合并功能，输入三个下标参数表示了两个子数组, :[nStart_, nMiddle)和[nMiddle, nEnd)
@@ -44,9 +45,12 @@ void Merge(int array[], int nStart_, int nMiddle_, int nEnd_, CompareFunc comp)
 	if (array == nullptr || nStart_ >= nMiddle_ || nMiddle_ >= nEnd_)
 		return;
 
+	SORT_PHASE_TIMER(dMergeSeconds);
+
 	// 建立一个临时数组存放中间数据
 	int _nIndex = 0;
 	int* _pTempArray = new int[nEnd_ - nStart_];
+	SORT_COUNT_ALLOCATION(sizeof(int) * (nEnd_ - nStart_));
 
 	// 对两个子数组进行合并
 	int _nStartChange = nStart_;
@@ -54,7 +58,7 @@ void Merge(int array[], int nStart_, int nMiddle_, int nEnd_, CompareFunc comp)
 	while (_nStartChange < nMiddle_ && _nMiddleChange < nEnd_)
 	{
 		// 此处的if中比较语句的安排可以保持稳定排序的特性。
-		if (comp(array[_nMiddleChange],  array[_nStartChange]))
+		if (SORT_COMPARE(comp(array[_nMiddleChange],  array[_nStartChange])))
 		{
 			_pTempArray[_nIndex] = array[_nMiddleChange];
 			++_nMiddleChange;
@@ -81,8 +85,9 @@ void Merge(int array[], int nStart_, int nMiddle_, int nEnd_, CompareFunc comp)
 		/* do noting */
 	}
 
-	// 数据交换
+	// 数据交换, 每个元素先拷贝到临时数组再拷贝回来，共移动两次
 	memcpy(array + nStart_, _pTempArray, sizeof(int) * (nEnd_ - nStart_));
+	SORT_COUNT_MOVE(2 * (nEnd_ - nStart_));
 
 	delete [] _pTempArray;
 	_pTempArray = nullptr;
@@ -104,6 +109,7 @@ void MergeSort(int array[], int nStart_, int nEnd_, CompareFunc comp)
 	Merge(array, nStart_, _nMiddle, nEnd_, comp);
 }
 
+#ifndef SORT_NO_MAIN
 // 比较函数
 bool less(int lhs, int rhs)
 {
@@ -144,7 +150,8 @@ int main(int argc, char* argv[])
 	PrintArray(array3, 2);
 	MergeSort(array3, 0, 2, less);
 	PrintArray(array3, 2);
+	SORT_PRINT_STATS(std::cout);
 
 	return 0;
 }
-
+#endif	// SORT_NO_MAIN
@@ -50,12 +50,14 @@
 //
 //
 /**************************     代码如下      ****************************/
+#include "sort_stats.h"
 
 // 定义三个宏，分别用于求左孩子/右孩子/父结点的下标。
 #define LEFT(i) (((i) << 1) + 1)
 #define RIGHT(i) (((i) + 1) << 1)
 #define PARENT(i) (((i) - 1) >> 1)
 
+#ifndef SORT_NO_MAIN
 // 小于比较函数
 bool less(int lhs, int rhs)
 {
@@ -67,11 +69,13 @@ bool greate(int lhs, int rhs)
 {
 	return lhs > rhs;
 }
+#endif	// SORT_NO_MAIN
 typedef bool (*Comp)(int, int);
 
 // 交换两个元素的值
 static inline void swap(int& lhs, int & rhs)
 {
+	SORT_COUNT_SWAP();
 	int _nTemp = lhs;
 	lhs = rhs;
 	rhs = _nTemp;
@@ -91,11 +95,11 @@ void Heapify(int array[], int nLength_, int nIndex_, Comp CompFunc)
 
 	// 初始化最大值节点的下标;
 	int _nLargest = nIndex_;
-	if ( _nLeft < nLength_ && !CompFunc(array[_nLargest], array[_nLeft]))
+	if ( _nLeft < nLength_ && !SORT_COMPARE(CompFunc(array[_nLargest], array[_nLeft])))
 	{
 		_nLargest = _nLeft;
 	}
-	if (_nRight < nLength_ && !CompFunc(array[_nLargest], array[_nRight]))
+	if (_nRight < nLength_ && !SORT_COMPARE(CompFunc(array[_nLargest], array[_nRight])))
 	{
 		_nLargest = _nRight;
 	}
@@ -144,15 +148,20 @@ void HeapSort(int array[], int nLength_, Comp CompFunc)
 	if (array == nullptr || nLength_ <=1 || CompFunc == nullptr) 
 		return;
 
-	BulidHeap(array, nLength_, CompFunc);
+	{
+		SORT_PHASE_TIMER(dHeapifySeconds);
+		BulidHeap(array, nLength_, CompFunc);
+	}
 	for (int i = nLength_; i >= 2; /* 循环内 */)		// i表示当前堆的大小
 	{
 		swap(array[0], array[--i]);
+		SORT_PHASE_TIMER(dHeapifySeconds);
 		Heapify(array, i, 0, CompFunc);
 	}
 }
 
 
+#ifndef SORT_NO_MAIN
 /************    测试     *****************/
 #include <iostream>
 
@@ -178,6 +187,8 @@ int main(int argc, char* argv[])
 	PrintArray(array, 10);
 	HeapSort(array, 10, greate);
 	PrintArray(array, 10);
+	SORT_PRINT_STATS(std::cout);
 
 	return 0;
 }
+#endif	// SORT_NO_MAIN
@@ -39,12 +39,25 @@
 //       2. 冒泡排序为原址排序，不需要借额外的空间；
 //       3. 冒泡排序通常见到的都是通过循环来实现的，其实通过递归来实现更简洁。 
 //       4. 冒泡排序的时间复杂度为O(N*N)
+//       5. 递归版本每一层只排好一个元素，递归深度为N, 数据量大时会栈溢出，只适合演示。
 //
 //
+#include "sort_stats.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#ifndef SORT_NO_MAIN
 bool less(int lhs, int rhs);
 bool greate(int lhs, int rhs);
-static inline void swap(int& lhs, int & rhs);
 void PrintArray(int array[], int nLength_);
+#endif	// SORT_NO_MAIN
+static inline void swap(int& lhs, int & rhs);
 typedef bool (*Comp)(int, int);
 
 //  基于循环来实现的冒泡排序:
@@ -59,7 +72,7 @@ void BubbleSort_Loop(int array[], int nLength_, Comp CompFunc)
 		// 如果要使下标为i的元素变成有序的，需要从数组尾部开始两两交换，直至交换到i
 		for (int j = nLength_ - 1; j > i; --j)
 		{
-			if (!CompFunc(array[j-1], array[j]))
+			if (!SORT_COMPARE(CompFunc(array[j-1], array[j])))
 			{
 				swap(array[j-1], array[j]);
 			}
@@ -76,7 +89,7 @@ void BubbleSort_Recursion(int array[], int nLength_, Comp CompFunc)
 	// 从数组尾部向前，对不符合要求的元素进行两两交换，从而使数组头部的元素为最小或最大
 	for (int i = nLength_ - 1; i > 0;  --i)
 	{
-		if (!CompFunc(array[i-1], array[i]))
+		if (!SORT_COMPARE(CompFunc(array[i-1], array[i])))
 		{
 			swap(array[i-1], array[i]);
 		}
@@ -86,6 +99,206 @@ void BubbleSort_Recursion(int array[], int nLength_, Comp CompFunc)
 	BubbleSort_Recursion(array + 1, nLength_ - 1, CompFunc);
 }
 
+/****************  数据无关的并行版本        ***************/
+// 对敏感的键进行排序时，比较与交换的顺序不能依赖于数据，否则可以通过时间或者内存访问的模式
+// 推测出数据(旁路攻击)。冒泡排序中是否交换依赖于数据，下面两种排序是数据无关(data-oblivious)
+// 的：比较哪两个位置只取决于数组的长度，每次比较之后总是写回两个元素(是否交换通过掩码计算,
+// 没有分支), 所以无论数据是什么，执行的指令序列与访问的内存地址都完全相同。
+//
+// 1. 奇偶换位排序(odd-even transposition sort): 冒泡排序的并行版本，共N轮，第偶数轮比较
+// (0,1), (2,3), (4,5)..., 第奇数轮比较(1,2), (3,4), (5,6)..., 同一轮中的比较互不相关，可以
+// 分给多个线程并行执行，每轮结束时所有线程同步一次。时间复杂度为O(N*N), 适合较小的数组。
+// 2. 双调排序(bitonic sort): 元素个数必须为2的幂，共logN*(logN+1)/2轮，每轮比较N/2对元素,
+// 时间复杂度为O(N*logN*logN).
+//
+// 说明：
+// 1. 为了保证每次比较都是常数时间的，这里不使用比较函数指针，而是由bAscending_指定从小到大
+// 还是从大到小排序。
+// 2. 有SSE2时一次比较与交换4对元素。
+// 3. nThreads_为0时使用所有的CPU核，线程的个数只取决于数组的长度，与数据无关。
+
+// 所有线程都到达之后才能一起进入下一轮。
+class PhaseBarrier
+{
+public:
+	explicit PhaseBarrier(int nThreads_) : m_nThreads(nThreads_), m_nArrived(0), m_nGeneration(0) {}
+
+	void Wait()
+	{
+		int _nGeneration = m_nGeneration.load(std::memory_order_acquire);
+		if (m_nArrived.fetch_add(1, std::memory_order_acq_rel) + 1 == m_nThreads)
+		{
+			m_nArrived.store(0, std::memory_order_relaxed);
+			m_nGeneration.fetch_add(1, std::memory_order_release);
+			return;
+		}
+
+		// 每一轮的时间很短，先自旋等待，等待的时间较长时再让出CPU
+		for (int _nSpins = 0; m_nGeneration.load(std::memory_order_acquire) == _nGeneration; ++_nSpins)
+		{
+			if (_nSpins > 1000)
+				std::this_thread::yield();
+		}
+	}
+
+private:
+	const int m_nThreads;
+	std::atomic<int> m_nArrived;
+	std::atomic<int> m_nGeneration;
+};
+
+// 比较并交换两个元素：先根据比较结果算出全0或全1的掩码，再通过异或交换，没有分支。
+// 多个线程同时执行比较，这里不使用SORT_COMPARE, 比较次数由调用者按照元素的对数统计。
+static inline void ObliviousCompareExchange(int& lhs, int& rhs, bool bAscending_)
+{
+	int _nMask = -static_cast<int>(bAscending_ ? lhs > rhs : lhs < rhs);
+	int _nDiff = (lhs ^ rhs) & _nMask;
+	lhs ^= _nDiff;
+	rhs ^= _nDiff;
+}
+
+#if defined(__SSE2__)
+// 一次比较并交换4对元素
+static inline void ObliviousCompareExchange(__m128i& lhs, __m128i& rhs, bool bAscending_)
+{
+	__m128i _mask = bAscending_ ? _mm_cmpgt_epi32(lhs, rhs) : _mm_cmpgt_epi32(rhs, lhs);
+	__m128i _diff = _mm_and_si128(_mm_xor_si128(lhs, rhs), _mask);
+	lhs = _mm_xor_si128(lhs, _diff);
+	rhs = _mm_xor_si128(rhs, _diff);
+}
+#endif
+
+// 比较并交换相邻的nPairs_对元素：(nFirst_, nFirst_+1), (nFirst_+2, nFirst_+3), ...
+static void CompareExchangeAdjacent(int array[], int nFirst_, int nPairs_, bool bAscending_)
+{
+	int k = 0;
+#if defined(__SSE2__)
+	// 8个相邻的元素拆分为偶数下标与奇数下标两组，比较之后再交错地合并回去
+	for (; k + 4 <= nPairs_; k += 4)
+	{
+		int* _pBase = array + nFirst_ + 2 * k;
+		__m128 _first = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i*>(_pBase)));
+		__m128 _second = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i*>(_pBase + 4)));
+		__m128i _even = _mm_castps_si128(_mm_shuffle_ps(_first, _second, _MM_SHUFFLE(2, 0, 2, 0)));
+		__m128i _odd = _mm_castps_si128(_mm_shuffle_ps(_first, _second, _MM_SHUFFLE(3, 1, 3, 1)));
+		ObliviousCompareExchange(_even, _odd, bAscending_);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(_pBase), _mm_unpacklo_epi32(_even, _odd));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(_pBase + 4), _mm_unpackhi_epi32(_even, _odd));
+	}
+#endif
+	for (; k < nPairs_; ++k)
+		ObliviousCompareExchange(array[nFirst_ + 2 * k], array[nFirst_ + 2 * k + 1], bAscending_);
+}
+
+// 比较并交换nCount_对距离为nDistance_的元素：(nFirst_, nFirst_+nDistance_), ..., nCount_不大于nDistance_
+static void CompareExchangeStride(int array[], int nFirst_, int nCount_, int nDistance_, bool bAscending_)
+{
+	int m = 0;
+#if defined(__SSE2__)
+	if (nDistance_ >= 4)
+	{
+		for (; m + 4 <= nCount_; m += 4)
+		{
+			__m128i* _pLow = reinterpret_cast<__m128i*>(array + nFirst_ + m);
+			__m128i* _pHigh = reinterpret_cast<__m128i*>(array + nFirst_ + m + nDistance_);
+			__m128i _low = _mm_loadu_si128(_pLow);
+			__m128i _high = _mm_loadu_si128(_pHigh);
+			ObliviousCompareExchange(_low, _high, bAscending_);
+			_mm_storeu_si128(_pLow, _low);
+			_mm_storeu_si128(_pHigh, _high);
+		}
+	}
+#endif
+	for (; m < nCount_; ++m)
+		ObliviousCompareExchange(array[nFirst_ + m], array[nFirst_ + m + nDistance_], bAscending_);
+}
+
+// 线程的个数：每个线程至少处理4096对元素，否则同步的开销比比较本身还大
+static int ThreadCount(int nLength_, int nThreads_)
+{
+	if (nThreads_ <= 0)
+		nThreads_ = std::max(1u, std::thread::hardware_concurrency());
+	return std::max(1, std::min(nThreads_, nLength_ / 8192));
+}
+
+// 在nThreads_个线程(包括当前线程)上执行Worker(nThreadIndex)
+template <typename Worker>
+static void RunOnThreads(int nThreads_, Worker worker_)
+{
+	std::vector<std::thread> _vecThreads;
+	for (int t = 1; t < nThreads_; ++t)
+		_vecThreads.push_back(std::thread(worker_, t));
+	worker_(0);
+	for (size_t t = 0; t < _vecThreads.size(); ++t)
+		_vecThreads[t].join();
+}
+
+// 奇偶换位排序
+void OddEvenTranspositionSort(int array[], int nLength_, bool bAscending_, int nThreads_)
+{
+	if (array == nullptr || nLength_ <= 1)
+		return;
+
+	const int _nThreads = ThreadCount(nLength_, nThreads_);
+	PhaseBarrier _barrier(_nThreads);
+	std::vector<long long> _vecCompares(_nThreads);
+	RunOnThreads(_nThreads, [&](int nThreadIndex_) {
+		long long _nCompares = 0;
+		for (int _nPhase = 0; _nPhase < nLength_; ++_nPhase)
+		{
+			// 本轮第一对元素的下标为0或1, 每个线程负责连续的一段
+			int _nFirst = _nPhase & 1;
+			long long _nPairs = (nLength_ - _nFirst) / 2;
+			int _nBegin = static_cast<int>(_nPairs * nThreadIndex_ / _nThreads);
+			int _nEnd = static_cast<int>(_nPairs * (nThreadIndex_ + 1) / _nThreads);
+			CompareExchangeAdjacent(array, _nFirst + 2 * _nBegin, _nEnd - _nBegin, bAscending_);
+			_nCompares += _nEnd - _nBegin;
+			_barrier.Wait();
+		}
+		_vecCompares[nThreadIndex_] = _nCompares;
+	});
+	SORT_COUNT_COMPARES(std::accumulate(_vecCompares.begin(), _vecCompares.end(), 0LL));
+}
+
+// 双调排序, 元素个数不是2的幂时抛出std::invalid_argument
+void BitonicSort(int array[], int nLength_, bool bAscending_, int nThreads_)
+{
+	if (array == nullptr || nLength_ <= 1)
+		return;
+	if ((nLength_ & (nLength_ - 1)) != 0)
+		throw std::invalid_argument("双调排序要求元素的个数为2的幂！");
+
+	const int _nThreads = ThreadCount(nLength_, nThreads_);
+	PhaseBarrier _barrier(_nThreads);
+	std::vector<long long> _vecCompares(_nThreads);
+	RunOnThreads(_nThreads, [&](int nThreadIndex_) {
+		long long _nCompares = 0;
+		// 长度为k的双调序列合并为有序序列，每轮比较距离为j的元素。第q对元素位于第q/j个长度为
+		// 2j的块中，块内的下标为i = (q/j)*2j + q%j, 与i+j比较，i & k为0的块从小到大排序。
+		for (int k = 2; k <= nLength_; k <<= 1)
+		{
+			for (int j = k >> 1; j > 0; j >>= 1)
+			{
+				int _nPairs = nLength_ / 2;
+				int _nBegin = static_cast<int>(static_cast<long long>(_nPairs) * nThreadIndex_ / _nThreads);
+				int _nEnd = static_cast<int>(static_cast<long long>(_nPairs) * (nThreadIndex_ + 1) / _nThreads);
+				for (int q = _nBegin; q < _nEnd; )
+				{
+					int i = (q / j) * 2 * j + q % j;
+					int _nCount = std::min(j - q % j, _nEnd - q);
+					CompareExchangeStride(array, i, _nCount, j, ((i & k) == 0) == bAscending_);
+					q += _nCount;
+				}
+				_nCompares += _nEnd - _nBegin;
+				_barrier.Wait();
+			}
+		}
+		_vecCompares[nThreadIndex_] = _nCompares;
+	});
+	SORT_COUNT_COMPARES(std::accumulate(_vecCompares.begin(), _vecCompares.end(), 0LL));
+}
+
+#ifndef SORT_NO_MAIN
 // 小小的测试
 #include <iostream>
 /***************    main.c     *********************/
@@ -101,6 +314,7 @@ int main(int argc, char* argv[])
 	std::cout << "基于循环的从大到小排序：" << std::endl;
 	BubbleSort_Loop(test1, 10, greate);
 	PrintArray(test1, 10);
+	SORT_PRINT_STATS(std::cout);
 
 	std::cout << "基于递归的从小到大排序：" << std::endl;
 	BubbleSort_Recursion(test1, 10, less);
@@ -109,6 +323,15 @@ int main(int argc, char* argv[])
 	BubbleSort_Recursion(test1, 10, greate);
 	PrintArray(test1, 10);
 
+	std::cout << "奇偶换位排序，从小到大：" << std::endl;
+	OddEvenTranspositionSort(test1, 10, true, 0);
+	PrintArray(test1, 10);
+
+	int test2[16] = {7, -3, 12, 0, 99, 5, 5, -40, 18, 2, 61, -7, 0, 33, 8, 1};
+	std::cout << "双调排序，从大到小：" << std::endl;
+	BitonicSort(test2, 16, false, 0);
+	PrintArray(test2, 16);
+
 	return 0;
 }
 
@@ -123,15 +346,18 @@ bool greate(int lhs, int rhs)
 {
 	return lhs > rhs;
 }
+#endif	// SORT_NO_MAIN
 
 // 交换两个元素的值
 static inline void swap(int& lhs, int & rhs)
 {
+	SORT_COUNT_SWAP();
 	int _nTemp = lhs;
 	lhs = rhs;
 	rhs = _nTemp;
 }
 
+#ifndef SORT_NO_MAIN
 // 打印数组函数
 void PrintArray(int array[], int nLength_)
 {
@@ -145,4 +371,4 @@ void PrintArray(int array[], int nLength_)
 
 	std::cout << std::endl;
 }
-
+#endif	// SORT_NO_MAIN
@@ -35,10 +35,14 @@
 #include<cassert>
 #include <stdexcept>
 #include <iostream>
+#include "sort.h"
+#include "sort_stats.h"
 static inline void swap(int&, int&);
+#ifndef SORT_NO_MAIN
 static bool less(int lhs, int rhs);
 static bool greate(int lhs, int rhs);
 static void PrintArray(int array[], int nLength_);
+#endif	// SORT_NO_MAIN
 typedef bool (*Compare)(int, int);
 
 /****************  版本一：使用数组的长度作为参数        ***************/
@@ -53,11 +57,12 @@ int Partition(int array[], int nLength_, Compare CompFunc)
 		throw std::invalid_argument("参数不合法！");
 	}
 
+	SORT_PHASE_TIMER(dPartitionSeconds);
 	int _nBoundValue = array[0];		// 划分区间的边界值
 	int _nBoundIndex = 0;				// 指向边界的下标, 即第二部分第一个元素的下标;
 	for (int i = 1; i < nLength_; ++i)
 	{
-		if (CompFunc(array[i], _nBoundValue))
+		if (SORT_COMPARE(CompFunc(array[i], _nBoundValue)))
 		{
 			swap(array[i], array[_nBoundIndex]);
 			++_nBoundIndex;
@@ -95,11 +100,12 @@ int Partition_Version2(int array[], int nStart_, int nEnd_, Compare CompFunc)
 		throw std::invalid_argument("参数不合法！");
 	}
 
+	SORT_PHASE_TIMER(dPartitionSeconds);
 	int _nBoundValue = array[nStart_];		// 划分区间的边界值
 	int _nBoundIndex = nStart_;				// 指向边界的下标, 即第二部分第一个元素的下标;
 	for (int i = nStart_ + 1; i < nEnd_; ++i)
 	{
-		if (CompFunc(array[i], _nBoundValue))
+		if (SORT_COMPARE(CompFunc(array[i], _nBoundValue)))
 		{
 			swap(array[i], array[_nBoundIndex]);
 			++_nBoundIndex;
@@ -124,6 +130,98 @@ void QuickSort_Version2(int array[], int nStart_, int nEnd_, Compare CompFunc)
 	QuickSort_Version2(array, _nPartionIndex, nEnd_, CompFunc);
 }
 
+/****************  增量快速排序        ***************/
+// 分页查询时通常只需要排序结果的前几页，完整的排序浪费了大部分的时间。增量快速排序的思想：
+// 1. 要输出下标为m_nIndex的元素时，只对包含它的区间[m_nIndex, end)进行划分，划分之后第一
+// 部分的元素都排在第二部分的前面，所以只需要继续划分第一部分，第二部分的结束位置(即划分点)
+// 压入栈中留到以后处理;
+// 2. 区间只剩下一个元素时，它就是剩余元素中最小的那一个，输出它，并且弹出栈顶;
+// 3. 栈中保存的划分点从栈顶到栈底是递增的，任何时候都可以从栈顶的区间继续。
+//
+// 每次划分使用Partition_Version2, 划分之前把首/中/尾三个元素的中位数换到区间的开头, 这样在
+// 已经有序或者逆序的数据上也可以均匀地划分，栈的深度期望为O(logN). 划分值为区间中最小的元素
+// 时，所有与它相等的元素一次性地放到前面，避免大量重复元素时退化为O(N*N).
+
+// 把nStart_, 中间, nEnd_ - 1三个位置上的中位数交换到nStart_.
+static void MoveMedianToFront(int array[], int nStart_, int nEnd_, Compare CompFunc)
+{
+	int _nMiddle = nStart_ + (nEnd_ - nStart_) / 2;
+	int _nLast = nEnd_ - 1;
+	if (CompFunc(array[_nMiddle], array[nStart_]))
+		swap(array[_nMiddle], array[nStart_]);
+	if (CompFunc(array[_nLast], array[_nMiddle]))
+	{
+		swap(array[_nLast], array[_nMiddle]);
+		if (CompFunc(array[_nMiddle], array[nStart_]))
+			swap(array[_nMiddle], array[nStart_]);
+	}
+	swap(array[nStart_], array[_nMiddle]);
+}
+
+IncrementalQuickSort::IncrementalQuickSort(int array[], int nLength_, Compare CompFunc)
+	: m_pArray(array), m_nLength(nLength_), m_nIndex(0), m_nEqualEnd(0), m_CompFunc(CompFunc)
+{
+	if ((array == nullptr && nLength_ > 0) || nLength_ < 0 || CompFunc == nullptr)
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+	m_vecBounds.push_back(nLength_);
+}
+
+bool IncrementalQuickSort::HasNext() const
+{
+	return m_nIndex < m_nLength;
+}
+
+int IncrementalQuickSort::Next()
+{
+	if (!HasNext())
+		throw std::out_of_range("没有更多的元素！");
+
+	// 一直划分包含m_nIndex的区间，直到它只剩下一个元素或者只剩下相等的元素
+	while (m_nIndex >= m_nEqualEnd && m_vecBounds.back() - m_nIndex > 1)
+	{
+		int _nEnd = m_vecBounds.back();
+		MoveMedianToFront(m_pArray, m_nIndex, _nEnd, m_CompFunc);
+		int _nBound = Partition_Version2(m_pArray, m_nIndex, _nEnd, m_CompFunc);
+
+		// 划分值是区间中最小的元素时，第一部分只有它自己，有大量重复元素时每次只能前进一个元素。
+		// 此时把与它相等的元素都换到前面, 它们都已经在最终的位置上了。
+		if (_nBound == m_nIndex + 1)
+		{
+			int _nBoundValue = m_pArray[m_nIndex];
+			for (int i = _nBound; i < _nEnd; ++i)
+			{
+				if (!SORT_COMPARE(m_CompFunc(_nBoundValue, m_pArray[i])))
+					swap(m_pArray[i], m_pArray[_nBound++]);
+			}
+			m_nEqualEnd = _nBound;
+		}
+		if (_nBound < _nEnd)
+			m_vecBounds.push_back(_nBound);
+	}
+
+	int _nValue = m_pArray[m_nIndex++];
+	if (m_vecBounds.back() == m_nIndex)
+		m_vecBounds.pop_back();
+	return _nValue;
+}
+
+int IncrementalQuickSort::NextBatch(int arrayOut[], int nCount_)
+{
+	int _nCount = 0;
+	while (_nCount < nCount_ && HasNext())
+		arrayOut[_nCount++] = Next();
+	return _nCount;
+}
+
+int IncrementalQuickSort::SortedCount() const
+{
+	return m_nIndex;
+}
+
+#ifndef SORT_NO_MAIN
 // 测试函数
 /***************    main.c     *********************/
 int main(int argc, char* argv[])
@@ -149,18 +247,35 @@ int main(int argc, char* argv[])
 	std::cout << "从大到小：" << std::endl;
 	QuickSort_Version2(array2, 0, 10, greate);
 	PrintArray(array2, 10);
+	std::cout << std::endl;
+
+	int array3[10] = {-12, 23, 443, 112, 12, -9098, 3432, 0, 0, 0};
+	std::cout << "增量快速排序，只取出前4个元素：" << std::endl;
+	IncrementalQuickSort _sorter(array3, 10, less);
+	int _nFirstPage[4];
+	PrintArray(_nFirstPage, _sorter.NextBatch(_nFirstPage, 4));
+	std::cout << "此时的数组为：" << std::endl;
+	PrintArray(array3, 10);
+	std::cout << "继续取出剩余的元素：" << std::endl;
+	while (_sorter.HasNext())
+		std::cout << _sorter.Next() << " ";
+	std::cout << std::endl;
+	SORT_PRINT_STATS(std::cout);
 
 	return 0;
 }
+#endif	// SORT_NO_MAIN
 
 
 inline void swap(int& lhs, int& rhs)
 {
+	SORT_COUNT_SWAP();
 	int _nTemp = lhs;
 	lhs = rhs;
 	rhs = _nTemp;
 }
 
+#ifndef SORT_NO_MAIN
 // 小于比较函数
 static bool less(int lhs, int rhs)
 {
@@ -186,4 +301,4 @@ static void PrintArray(int array[], int nLength_)
 
 	std::cout << std::endl;
 }
-
+#endif	// SORT_NO_MAIN
@@ -17,6 +17,7 @@
 ***********************************************************************/
 #include<string.h>
 #include<iostream>
+#include "sort_stats.h"
 
 // 任何比较排序算法的时间复杂度的上限为O(NlogN), 不存在比o(nlgN)更少的比较排序算法。
 // 如果想要在时间复杂度上超过O(NlogN)的时间复杂度，肯定需要加入其它条件。计数排序就加入
@@ -45,6 +46,7 @@ void CountingSort(int array[], int nLength_, int nMaxNumber_)
 	// 统计待排序数组中每一个元素的个数
 	// 注意：此处new出来的数组的大小为nMaxNumber_ + 1, 用于统计[0, nMaxNumber_]范围内的元素
 	int* ArrayCount = new int[nMaxNumber_ + 1]{0};
+	SORT_COUNT_ALLOCATION(sizeof(int) * (nMaxNumber_ + 1));
 	for (int i = 0; i < nLength_; ++i)
 	{
 		++ArrayCount[array[i]];
@@ -59,10 +61,12 @@ void CountingSort(int array[], int nLength_, int nMaxNumber_)
 
 	// 把待排序的数组放到输出数组中, 为了保持排序的稳定性，从后向前添加元素
 	int* ArrayResult = new int[nLength_];
+	SORT_COUNT_ALLOCATION(sizeof(int) * nLength_);
 	for (int i = nLength_ - 1; i >=0; --i)
 	{
 		int _nIndex = ArrayCount[array[i]] - 1;	// 元素array[i]在输出数组中的下标
 		ArrayResult[_nIndex] = array[i];
+		SORT_COUNT_MOVE(1);
 
 		// 因为可能有重复的元素，所以要减1,为下一个重复的元素计算正确的下标;
 		--ArrayCount[array[i]];
@@ -70,12 +74,14 @@ void CountingSort(int array[], int nLength_, int nMaxNumber_)
 
 	// 交换数据并释放内存空间
 	memcpy(array, ArrayResult, sizeof(int) * nLength_);
+	SORT_COUNT_MOVE(nLength_);
 	delete [] ArrayCount;
 	ArrayCount = nullptr;
 	delete [] ArrayResult;
 	ArrayResult = nullptr;
 }
 
+#ifndef SORT_NO_MAIN
 // 测试代码
 /***************    main.c     *********************/
 static void PrintArray(int array[], int nLength_);
@@ -87,6 +93,7 @@ int main(int argc, char* argv[])
 	CountingSort(test, 10, 12);
 	std::cout << "排序后：" << std::endl;
 	PrintArray(test, 10);
+	SORT_PRINT_STATS(std::cout);
 
 	return 0;
 }
@@ -104,3 +111,4 @@ static void PrintArray(int array[], int nLength_)
 
 	std::cout << std::endl;
 }
+#endif	// SORT_NO_MAIN
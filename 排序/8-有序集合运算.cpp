@@ -0,0 +1,367 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 14时08分52秒
+*   Modifed Time: 2026年10月20日 星期二 16时35分09秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+
+
+// 有序数组上的集合运算：交集、并集、差集与去重。
+// 排序之后经常需要对ID列表求交集或并集(例如倒排索引中的posting list求交), 它们本质上都是
+// 归并排序中Merge的变形：两个下标从前向后移动，每次比较两个数组当前的元素。
+//
+// 输入的数组都是从小到大有序的，并且(除了去重函数之外)没有重复的元素。输出数组由调用者分配：
+// 交集至少为min(nLengthA_, nLengthB_)个元素，并集为nLengthA_ + nLengthB_个元素，差集为
+// nLengthA_个元素。函数返回输出的元素个数。
+//
+// 几种方法：
+// 1. 无分支的归并：Merge中的if/else在随机数据上有一半的概率预测失败，把比较的结果直接当作
+// 0或1加到下标上，循环中就没有难以预测的分支了。
+// 2. SIMD块比较：每次从两个数组中各取4个元素，把B的4个元素循环移位3次，与A的4个元素比较4
+// 次，就完成了4x4=16对元素的比较，然后根据两块中最后一个元素的大小决定前进哪一块。
+// 3. 跳跃查找(galloping): 两个数组的大小相差很多时，对小数组中的每个元素，在大数组中从上
+// 一次的位置开始按1, 2, 4, 8...的步长向后跳，找到范围后再二分查找。复杂度为
+// O(m*log(n/m)), 而归并的复杂度为O(m + n).
+// 4. 自适应：根据两个数组大小的比值选择上面的方法，比值超过s_nGallopRatio时使用跳跃查找。
+//
+#include <algorithm>
+#include <iostream>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// 两个数组大小的比值超过该值时，使用跳跃查找。在随机数据上测试(见main函数), SIMD块比较与
+// 跳跃查找的交叉点在比值64到128之间。
+static const size_t s_nGallopRatio = 100;
+
+/***************    跳跃查找     *********************/
+// 在array[nStart_, nLength_)中查找第一个不小于nValue_的元素的下标，不存在时返回nLength_.
+static size_t GallopLowerBound(const int array[], size_t nStart_, size_t nLength_, int nValue_)
+{
+	if (nStart_ >= nLength_ || array[nStart_] >= nValue_)
+		return nStart_;
+
+	// 此时array[nStart_ + _nLow] < nValue_, 不断加倍步长直到越界或者找到不小于nValue_的元素
+	size_t _nLow = 0;
+	size_t _nStep = 1;
+	while (nStart_ + _nStep < nLength_ && array[nStart_ + _nStep] < nValue_)
+	{
+		_nLow = _nStep;
+		_nStep *= 2;
+	}
+	size_t _nHigh = std::min(nStart_ + _nStep, nLength_);
+	return std::lower_bound(array + nStart_ + _nLow + 1, array + _nHigh, nValue_) - array;
+}
+
+/***************    交集     *********************/
+// 无分支的归并求交集
+size_t Intersect_Merge(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[])
+{
+	size_t i = 0, j = 0, _nCount = 0;
+	while (i < nLengthA_ && j < nLengthB_)
+	{
+		int _nA = arrayA[i];
+		int _nB = arrayB[j];
+		arrayOut[_nCount] = _nA;
+		_nCount += _nA == _nB;
+		i += _nA <= _nB;
+		j += _nB <= _nA;
+	}
+	return _nCount;
+}
+
+// 对小数组中的每个元素，在大数组中跳跃查找
+size_t Intersect_Galloping(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[])
+{
+	if (nLengthA_ > nLengthB_)
+		return Intersect_Galloping(arrayB, nLengthB_, arrayA, nLengthA_, arrayOut);
+
+	size_t _nCount = 0;
+	size_t _nPosition = 0;
+	for (size_t i = 0; i < nLengthA_ && _nPosition < nLengthB_; ++i)
+	{
+		_nPosition = GallopLowerBound(arrayB, _nPosition, nLengthB_, arrayA[i]);
+		if (_nPosition < nLengthB_ && arrayB[_nPosition] == arrayA[i])
+			arrayOut[_nCount++] = arrayA[i];
+	}
+	return _nCount;
+}
+
+// SSE2的4x4块比较求交集，没有SSE2时与Intersect_Merge相同。
+// 每一步都会写4个输出位置，输出数组只有min(nLengthA_, nLengthB_)个元素，所以剩余的空间不足
+// 4个元素时改用Intersect_Merge处理剩下的部分。
+size_t Intersect_SIMD(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[])
+{
+	size_t i = 0, j = 0, _nCount = 0;
+#if defined(__SSE2__)
+	size_t _nCapicity = std::min(nLengthA_, nLengthB_);
+	while (i + 4 <= nLengthA_ && j + 4 <= nLengthB_ && _nCount + 4 <= _nCapicity)
+	{
+		__m128i _a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrayA + i));
+		__m128i _b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(arrayB + j));
+
+		// 把B循环移位3次，与A比较4次，得到A中每个元素是否在B的这4个元素中
+		__m128i _equal = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi32(_a, _b),
+					_mm_cmpeq_epi32(_a, _mm_shuffle_epi32(_b, _MM_SHUFFLE(0, 3, 2, 1)))),
+				_mm_or_si128(_mm_cmpeq_epi32(_a, _mm_shuffle_epi32(_b, _MM_SHUFFLE(1, 0, 3, 2))),
+					_mm_cmpeq_epi32(_a, _mm_shuffle_epi32(_b, _MM_SHUFFLE(2, 1, 0, 3)))));
+		int _nMask = _mm_movemask_ps(_mm_castsi128_ps(_equal));
+
+		// 无分支地写出匹配的元素：每个元素都写，只有匹配时输出的下标才加1
+		arrayOut[_nCount] = arrayA[i];
+		_nCount += _nMask & 1;
+		arrayOut[_nCount] = arrayA[i + 1];
+		_nCount += (_nMask >> 1) & 1;
+		arrayOut[_nCount] = arrayA[i + 2];
+		_nCount += (_nMask >> 2) & 1;
+		arrayOut[_nCount] = arrayA[i + 3];
+		_nCount += (_nMask >> 3) & 1;
+
+		// 最后一个元素较小的那一块已经比较完了，两块的最后一个元素相等时都前进
+		int _nLastA = arrayA[i + 3];
+		int _nLastB = arrayB[j + 3];
+		i += (_nLastA <= _nLastB) * 4;
+		j += (_nLastB <= _nLastA) * 4;
+	}
+#endif
+	return _nCount + Intersect_Merge(arrayA + i, nLengthA_ - i, arrayB + j, nLengthB_ - j, arrayOut + _nCount);
+}
+
+// 根据两个数组大小的比值选择求交集的方法
+size_t SetIntersection(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[])
+{
+	size_t _nSmall = std::min(nLengthA_, nLengthB_);
+	size_t _nLarge = std::max(nLengthA_, nLengthB_);
+	if (_nSmall == 0)
+		return 0;
+	if (_nLarge / _nSmall >= s_nGallopRatio)
+		return Intersect_Galloping(arrayA, nLengthA_, arrayB, nLengthB_, arrayOut);
+	return Intersect_SIMD(arrayA, nLengthA_, arrayB, nLengthB_, arrayOut);
+}
+
+/***************    并集     *********************/
+// 无分支的归并求并集，相等的元素只输出一次
+size_t SetUnion(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[])
+{
+	size_t i = 0, j = 0, _nCount = 0;
+	while (i < nLengthA_ && j < nLengthB_)
+	{
+		int _nA = arrayA[i];
+		int _nB = arrayB[j];
+		arrayOut[_nCount++] = _nA < _nB ? _nA : _nB;
+		i += _nA <= _nB;
+		j += _nB <= _nA;
+	}
+
+	// 把剩余的元素追加到后面
+	std::copy(arrayA + i, arrayA + nLengthA_, arrayOut + _nCount);
+	_nCount += nLengthA_ - i;
+	std::copy(arrayB + j, arrayB + nLengthB_, arrayOut + _nCount);
+	_nCount += nLengthB_ - j;
+	return _nCount;
+}
+
+/***************    差集     *********************/
+// 求A - B, 即在A中但是不在B中的元素。
+// 两个数组大小相近时使用无分支的归并；B比A大很多时，对A中的每个元素在B中跳跃查找；A比B大
+// 很多时，对B中的每个元素在A中跳跃查找，两个元素之间的那一段A直接整块拷贝。
+size_t SetDifference(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[])
+{
+	size_t i = 0, j = 0, _nCount = 0;
+	if (nLengthA_ > 0 && nLengthB_ / nLengthA_ >= s_nGallopRatio)
+	{
+		for (i = 0; i < nLengthA_; ++i)
+		{
+			j = GallopLowerBound(arrayB, j, nLengthB_, arrayA[i]);
+			arrayOut[_nCount] = arrayA[i];
+			_nCount += j == nLengthB_ || arrayB[j] != arrayA[i];
+		}
+		return _nCount;
+	}
+
+	if (nLengthB_ > 0 && nLengthA_ / nLengthB_ >= s_nGallopRatio)
+	{
+		for (j = 0; j < nLengthB_ && i < nLengthA_; ++j)
+		{
+			size_t _nPosition = GallopLowerBound(arrayA, i, nLengthA_, arrayB[j]);
+			std::copy(arrayA + i, arrayA + _nPosition, arrayOut + _nCount);
+			_nCount += _nPosition - i;
+			i = _nPosition + (_nPosition < nLengthA_ && arrayA[_nPosition] == arrayB[j]);
+		}
+	}
+	else
+	{
+		while (i < nLengthA_ && j < nLengthB_)
+		{
+			int _nA = arrayA[i];
+			int _nB = arrayB[j];
+			arrayOut[_nCount] = _nA;
+			_nCount += _nA < _nB;
+			i += _nA <= _nB;
+			j += _nB <= _nA;
+		}
+	}
+
+	std::copy(arrayA + i, arrayA + nLengthA_, arrayOut + _nCount);
+	return _nCount + nLengthA_ - i;
+}
+
+/***************    去重     *********************/
+// 对有序数组原地去重，返回去重后的元素个数。每个元素都写到当前的位置上，只有与前一个元素
+// 不相等时位置才加1.
+size_t SortedUnique(int array[], size_t nLength_)
+{
+	if (array == nullptr || nLength_ == 0)
+		return 0;
+
+	size_t _nCount = 1;
+	for (size_t i = 1; i < nLength_; ++i)
+	{
+		int _nValue = array[i];
+		array[_nCount] = _nValue;
+		_nCount += _nValue != array[_nCount - 1];
+	}
+	return _nCount;
+}
+
+#ifndef SORT_NO_MAIN
+// 测试代码
+/***************    main.c     *********************/
+#include <chrono>
+#include <random>
+#include <vector>
+
+typedef size_t (*SetOperation)(const int[], size_t, const int[], size_t, int[]);
+
+// 生成nLength_个从小到大并且互不相同的随机数，相邻两个数的差在[1, nMaxGap_]之间
+static std::vector<int> RandomSet(size_t nLength_, int nMaxGap_, std::mt19937& engine_)
+{
+	std::uniform_int_distribution<int> _distribution(1, nMaxGap_);
+	std::vector<int> _vecResult(nLength_);
+	int _nValue = 0;
+	for (size_t i = 0; i < nLength_; ++i)
+	{
+		_nValue += _distribution(engine_);
+		_vecResult[i] = _nValue;
+	}
+	return _vecResult;
+}
+
+static void PrintArray(const int array[], size_t nLength_)
+{
+	for (size_t i = 0; i < nLength_; ++i)
+		std::cout << array[i] << " ";
+	std::cout << std::endl;
+}
+
+// 与标准库的结果进行比较。输出数组按照约定的最小大小分配，越界写可以被AddressSanitizer发现。
+static bool CheckAll(const std::vector<int>& vecA_, const std::vector<int>& vecB_)
+{
+	std::vector<int> _vecExpected;
+	std::set_intersection(vecA_.begin(), vecA_.end(), vecB_.begin(), vecB_.end(), std::back_inserter(_vecExpected));
+	SetOperation _intersections[] = {Intersect_Merge, Intersect_Galloping, Intersect_SIMD, SetIntersection};
+	for (size_t i = 0; i < sizeof(_intersections) / sizeof(_intersections[0]); ++i)
+	{
+		std::vector<int> _vecOut(std::min(vecA_.size(), vecB_.size()));
+		size_t _nCount = _intersections[i](vecA_.data(), vecA_.size(), vecB_.data(), vecB_.size(), _vecOut.data());
+		if (_nCount != _vecExpected.size() || !std::equal(_vecExpected.begin(), _vecExpected.end(), _vecOut.begin()))
+			return false;
+	}
+
+	_vecExpected.clear();
+	std::set_union(vecA_.begin(), vecA_.end(), vecB_.begin(), vecB_.end(), std::back_inserter(_vecExpected));
+	std::vector<int> _vecUnion(vecA_.size() + vecB_.size());
+	size_t _nCount = SetUnion(vecA_.data(), vecA_.size(), vecB_.data(), vecB_.size(), _vecUnion.data());
+	if (_nCount != _vecExpected.size() || !std::equal(_vecExpected.begin(), _vecExpected.end(), _vecUnion.begin()))
+		return false;
+
+	_vecExpected.clear();
+	std::set_difference(vecA_.begin(), vecA_.end(), vecB_.begin(), vecB_.end(), std::back_inserter(_vecExpected));
+	std::vector<int> _vecDifference(vecA_.size());
+	_nCount = SetDifference(vecA_.data(), vecA_.size(), vecB_.data(), vecB_.size(), _vecDifference.data());
+	return _nCount == _vecExpected.size() && std::equal(_vecExpected.begin(), _vecExpected.end(), _vecDifference.begin());
+}
+
+// 统计求交集的各种方法每个元素平均花费的纳秒数
+static void BenchmarkIntersection(size_t nLarge_, size_t nRatio_, std::mt19937& engine_)
+{
+	std::vector<int> _vecLarge = RandomSet(nLarge_, 4, engine_);
+	std::vector<int> _vecSmall = RandomSet(nLarge_ / nRatio_, static_cast<int>(4 * nRatio_), engine_);
+	std::vector<int> _vecOut(_vecSmall.size());
+	const char* _names[] = {"Merge", "Galloping", "SIMD", "自适应"};
+	SetOperation _intersections[] = {Intersect_Merge, Intersect_Galloping, Intersect_SIMD, SetIntersection};
+
+	std::cout << "比值" << nRatio_ << ":";
+	for (size_t i = 0; i < sizeof(_intersections) / sizeof(_intersections[0]); ++i)
+	{
+		const int _nRepeat = 20;
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		size_t _nCount = 0;
+		for (int k = 0; k < _nRepeat; ++k)
+			_nCount += _intersections[i](_vecSmall.data(), _vecSmall.size(), _vecLarge.data(), _vecLarge.size(),
+					_vecOut.data());
+		std::chrono::duration<double, std::nano> _elapsed = std::chrono::steady_clock::now() - _start;
+		std::cout << "  " << _names[i] << " " << _elapsed.count() / _nRepeat / (_vecSmall.size() + nLarge_)
+			<< "ns/元素";
+		if (_nCount == 0)
+			std::cout << "(空)";
+	}
+	std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	int arrayA[] = {1, 3, 4, 7, 9, 12, 15, 20, 21, 30};
+	int arrayB[] = {2, 3, 7, 8, 9, 15, 21, 22};
+	int arrayOut[18];
+	std::cout << "A: ";
+	PrintArray(arrayA, 10);
+	std::cout << "B: ";
+	PrintArray(arrayB, 8);
+	std::cout << "交集：";
+	PrintArray(arrayOut, SetIntersection(arrayA, 10, arrayB, 8, arrayOut));
+	std::cout << "并集：";
+	PrintArray(arrayOut, SetUnion(arrayA, 10, arrayB, 8, arrayOut));
+	std::cout << "差集A-B: ";
+	PrintArray(arrayOut, SetDifference(arrayA, 10, arrayB, 8, arrayOut));
+
+	int arrayDuplicate[] = {1, 1, 2, 3, 3, 3, 7, 8, 8, 9};
+	std::cout << "去重：";
+	PrintArray(arrayDuplicate, SortedUnique(arrayDuplicate, 10));
+
+	// 与标准库的结果比较，包括大小相差很多的情况
+	// B完全包含在A的前几个元素中，交集恰好填满输出数组
+	int arrayRange[] = {0, 1, 2, 3, 4, 5, 6, 7};
+	int arraySubset[] = {1, 2, 3, 4};
+	std::vector<int> _vecRange(arrayRange, arrayRange + 8), _vecSubset(arraySubset, arraySubset + 4);
+	bool _bOk = CheckAll(_vecRange, _vecSubset) && CheckAll(_vecSubset, _vecRange);
+
+	std::mt19937 _engine(20190511);
+	for (int k = 0; k < 200 && _bOk; ++k)
+	{
+		size_t _nLengthA = _engine() % 300;
+		size_t _nLengthB = k % 4 == 0 ? _engine() % 20000 : _engine() % 300;
+		_bOk = CheckAll(RandomSet(_nLengthA, 8, _engine), RandomSet(_nLengthB, 3, _engine))
+			&& CheckAll(RandomSet(_nLengthB, 3, _engine), RandomSet(_nLengthA, 8, _engine));
+	}
+	std::cout << "与标准库比较：" << (_bOk ? "正确" : "错误") << std::endl;
+
+	const size_t _ratios[] = {1, 8, 64, 128, 256, 1024};
+	for (size_t i = 0; i < sizeof(_ratios) / sizeof(_ratios[0]); ++i)
+		BenchmarkIntersection(1 << 20, _ratios[i], _engine);
+
+	return _bOk ? 0 : 1;
+}
+#endif	// SORT_NO_MAIN
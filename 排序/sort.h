@@ -0,0 +1,89 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 14时02分17秒
+*   Modifed Time: 2026年10月19日 星期一 15时31分40秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef SORT_H
+#define SORT_H
+#include <cstddef>
+#include <vector>
+
+// 本目录下各个排序算法的函数声明, 供其它程序调用。
+// 各个排序算法的源文件中都带有自己的测试程序，编译时定义宏SORT_NO_MAIN即可去掉其中的main函
+// 数与测试用的辅助函数，然后把它们与调用者的程序链接在一起，例如：
+//     g++ -DSORT_NO_MAIN -c 2-归并排序.cpp
+//
+// 比较谓词：返回true表示lhs应该排在rhs的前面。
+typedef bool (*SortCompare)(int lhs, int rhs);
+
+// 1-插入排序.cpp, 从小到大排序
+void insertion_sort(int array[], size_t nLength_);
+
+// 2-归并排序.cpp, 区间为[nStart_, nEnd_)
+void Merge(int array[], int nStart_, int nMiddle_, int nEnd_, SortCompare comp);
+void MergeSort(int array[], int nStart_, int nEnd_, SortCompare comp);
+
+// 3-堆排序.cpp, 传入大于比较函数时建立最大堆，排序结果为从小到大
+void Heapify(int array[], int nLength_, int nIndex_, SortCompare CompFunc);
+void BulidHeap(int array[], int nLength_, SortCompare CompFunc);
+void HeapSort(int array[], int nLength_, SortCompare CompFunc);
+
+// 4-冒泡排序.cpp
+void BubbleSort_Loop(int array[], int nLength_, SortCompare CompFunc);
+void BubbleSort_Recursion(int array[], int nLength_, SortCompare CompFunc);
+// 数据无关的并行版本，bAscending_为true时从小到大排序, nThreads_为0时使用所有的CPU核。
+// 双调排序的元素个数必须为2的幂。
+void OddEvenTranspositionSort(int array[], int nLength_, bool bAscending_, int nThreads_);
+void BitonicSort(int array[], int nLength_, bool bAscending_, int nThreads_);
+
+// 5-快速排序.cpp, 版本二的区间为[nStart_, nEnd_)
+int Partition(int array[], int nLength_, SortCompare CompFunc);
+void QuickSort(int array[], int nLength_, SortCompare CompFunc);
+int Partition_Version2(int array[], int nStart_, int nEnd_, SortCompare CompFunc);
+void QuickSort_Version2(int array[], int nStart_, int nEnd_, SortCompare CompFunc);
+
+// 5-快速排序.cpp, 增量快速排序：每次只做产生下一个最小元素所必需的划分，取出前k个元素的
+// 复杂度为O(N + klogk). 已经取出的元素按顺序放在数组的前面, 即array[0, SortedCount()).
+class IncrementalQuickSort
+{
+public:
+	IncrementalQuickSort(int array[], int nLength_, SortCompare CompFunc);
+	bool HasNext() const;
+	int Next();									// 返回下一个元素，没有元素时抛出std::out_of_range
+	int NextBatch(int arrayOut[], int nCount_);	// 最多取出nCount_个元素，返回取出的个数
+	int SortedCount() const;
+
+private:
+	int* m_pArray;
+	int m_nLength;
+	int m_nIndex;								// 下一个要输出的元素的下标
+	int m_nEqualEnd;							// [m_nIndex, m_nEqualEnd)内的元素相等并且已经在最终的位置上
+	SortCompare m_CompFunc;
+	std::vector<int> m_vecBounds;				// 划分点的栈，栈顶为包含m_nIndex的区间的结束位置
+};
+
+// 6-计数排序.cpp, 元素的值必须在[0, nMaxNumber_]之间
+void CountingSort(int array[], int nLength_, int nMaxNumber_);
+
+// 8-有序集合运算.cpp, 输入为从小到大有序并且没有重复元素的数组，返回输出的元素个数
+size_t Intersect_Merge(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[]);
+size_t Intersect_Galloping(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[]);
+size_t Intersect_SIMD(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[]);
+size_t SetIntersection(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[]);
+size_t SetUnion(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[]);
+size_t SetDifference(const int arrayA[], size_t nLengthA_, const int arrayB[], size_t nLengthB_, int arrayOut[]);
+size_t SortedUnique(int array[], size_t nLength_);
+
+#endif	// SORT_H
@@ -0,0 +1,118 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 10时12分31秒
+*   Modifed Time: 2026年10月19日 星期一 11时40分05秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef SORT_STATS_H
+#define SORT_STATS_H
+
+// 排序算法的统计信息：比较次数/交换次数/移动次数/内存分配次数，以及划分/合并/建堆各个阶段
+// 花费的时间。
+//
+// 使用方法：
+//     1. 编译时定义宏SORT_STATS即可打开统计功能，例如：g++ -DSORT_STATS 2-归并排序.cpp
+//     2. 没有定义宏SORT_STATS时，下面所有的宏都展开为空或者展开为原表达式本身，不会产生任何
+//     额外的代码，所以正常编译的排序算法没有任何额外的开销。
+//
+// 宏的说明：
+//     SORT_COMPARE(expr)			统计一次比较，并返回比较表达式expr的值
+//     SORT_COUNT_COMPARES(n)		统计n次比较(多线程的排序在线程结束之后一次累加)
+//     SORT_COUNT_SWAP()			统计一次交换
+//     SORT_COUNT_MOVE(n)			统计n次元素的移动(赋值或拷贝)
+//     SORT_COUNT_ALLOCATION(bytes)	统计一次内存分配，以及分配的字节数
+//     SORT_PHASE_TIMER(phase)		统计当前作用域花费的时间，累加到指定阶段上,
+//     								phase为dPartitionSeconds/dMergeSeconds/dHeapifySeconds之一
+//     SORT_RESET_STATS()			清空统计信息
+//     SORT_PRINT_STATS(os)			把统计信息输出到流os中
+//
+#ifdef SORT_STATS
+#include <chrono>
+#include <ostream>
+
+struct SortStats
+{
+	unsigned long long nCompares;		// 比较次数
+	unsigned long long nSwaps;			// 交换次数
+	unsigned long long nMoves;			// 元素移动次数
+	unsigned long long nAllocations;	// 内存分配次数
+	unsigned long long nAllocatedBytes;	// 分配的总字节数
+	double dPartitionSeconds;			// 快速排序中划分花费的时间
+	double dMergeSeconds;				// 归并排序中合并花费的时间
+	double dHeapifySeconds;				// 堆排序中建堆与维护堆性质花费的时间
+};
+
+// 使用函数内的静态变量，多个源文件包含该头文件时也只有一份统计信息。
+inline SortStats& GetSortStats()
+{
+	static SortStats s_stats = SortStats();
+	return s_stats;
+}
+
+// 构造时开始计时，析构时把经过的时间累加到给定的变量上。
+class SortPhaseTimer
+{
+public:
+	explicit SortPhaseTimer(double& dSeconds_)
+		: m_dSeconds(dSeconds_), m_start(std::chrono::steady_clock::now())
+	{
+	}
+
+	~SortPhaseTimer()
+	{
+		std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - m_start;
+		m_dSeconds += _elapsed.count();
+	}
+
+private:
+	double& m_dSeconds;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+inline void PrintSortStats(std::ostream& os_)
+{
+	const SortStats& _stats = GetSortStats();
+	os_ << "比较次数：" << _stats.nCompares
+		<< "  交换次数：" << _stats.nSwaps
+		<< "  移动次数：" << _stats.nMoves
+		<< "  内存分配次数：" << _stats.nAllocations
+		<< "(" << _stats.nAllocatedBytes << "字节)" << std::endl;
+	os_ << "划分耗时：" << _stats.dPartitionSeconds << "秒"
+		<< "  合并耗时：" << _stats.dMergeSeconds << "秒"
+		<< "  建堆耗时：" << _stats.dHeapifySeconds << "秒" << std::endl;
+}
+
+#define SORT_COMPARE(expr) (++GetSortStats().nCompares, (expr))
+#define SORT_COUNT_COMPARES(n) (GetSortStats().nCompares += (n))
+#define SORT_COUNT_SWAP() (++GetSortStats().nSwaps)
+#define SORT_COUNT_MOVE(n) (GetSortStats().nMoves += (n))
+#define SORT_COUNT_ALLOCATION(bytes) (++GetSortStats().nAllocations, GetSortStats().nAllocatedBytes += (bytes))
+#define SORT_PHASE_TIMER(phase) SortPhaseTimer _sortPhaseTimer(GetSortStats().phase)
+#define SORT_RESET_STATS() (GetSortStats() = SortStats())
+#define SORT_PRINT_STATS(os) PrintSortStats(os)
+
+#else
+
+#define SORT_COMPARE(expr) (expr)
+#define SORT_COUNT_COMPARES(n) ((void)0)
+#define SORT_COUNT_SWAP() ((void)0)
+#define SORT_COUNT_MOVE(n) ((void)0)
+#define SORT_COUNT_ALLOCATION(bytes) ((void)0)
+#define SORT_PHASE_TIMER(phase) ((void)0)
+#define SORT_RESET_STATS() ((void)0)
+#define SORT_PRINT_STATS(os) ((void)0)
+
+#endif	// SORT_STATS
+
+#endif	// SORT_STATS_H
@@ -0,0 +1,837 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 23时05分17秒
+*   Modifed Time: 2026年10月20日 星期二 01时12分40秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "../sort.h"
+#include "../性能测试/input_generator.h"
+#include "socket_io.h"
+#include "../../数据结构/pad_right.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// 多进程的分布式排序(采样排序, sample sort)。
+// 当数据多到一个进程的内存放不下时，把数据分给多个工作进程，每个进程只保存其中的一部分,
+// 排序完成后第i个进程中的所有数据都不大于第i+1个进程中的数据。
+//
+// 过程:
+// 1. 本地排序：每个工作进程使用归并排序(MergeSort)或者快速排序(QuickSort_Version2)对自己
+// 的那一部分数据进行排序。
+// 2. 采样：每个工作进程从排序好的数据中等间隔地选出若干个样本发给协调进程，协调进程对所有
+// 样本排序后，等间隔地选出N-1个分割点，再广播给所有的工作进程。
+// 3. 划分：每个工作进程使用二分查找，按照分割点把自己的数据划分为N段，第j段属于进程j。
+// 因为数据已经有序，每一段都是连续的，不需要移动数据。
+// 4. 数据交换：每个工作进程把第j段发送给进程j, 同时接收其它进程发给自己的数据(all-to-all).
+// 5. 多路归并：每个工作进程收到的N段数据都是有序的，使用最小堆进行N路归并。
+//
+// 说明：
+// 1. 协调进程与工作进程之间通过socketpair()建立的控制通道通信，工作进程之间通过TCP或者
+// Unix域套接字交换数据，地址通过控制通道互相告知，所以以后把工作进程放到不同的机器上时,
+// 只需要把监听地址换掉即可。数据以本机的字节序发送，要求所有的机器字节序相同。
+// 2. 每个工作进程使用不同的种子生成自己的那一部分数据，模拟每个进程读取输入中的一段,
+// 协调进程自己不保存任何数据。
+// 3. 有大量重复值时(例如few-unique), 多个分割点可能相等，这时等于分割点的元素平均分给相应
+// 的几个进程，而不是都分给同一个进程，否则负载会严重不均衡。
+// 4. 排序结果的正确性由协调进程检查：每个进程内有序，相邻进程的边界有序，元素的个数与校验
+// 和(所有元素之和)在排序前后相等。
+// 5. QuickSort_Version2选择第一个元素作为划分点，在已经有序的数据上递归深度为N, 可能会栈
+// 溢出，所以默认使用归并排序。
+// 6. 某个工作进程异常退出时不能让其它进程永远等下去：数据交换时连续--timeout秒没有任何进展
+// (没有新的连接也没有收到数据, 或者发送的数据一直没有被接收)就认为失败，连接在数据收完之前
+// 被对方关闭也是失败; 失败的工作进程退出之后，协调进程发现有控制通道断开，就杀掉所有的工作
+// 进程并结束这一次排序。
+//
+/*******************    命令行参数        *****************/
+enum LocalSort
+{
+	LOCAL_MERGE_SORT,
+	LOCAL_QUICK_SORT,
+};
+
+struct Options
+{
+	int nWorkers = 4;
+	size_t nSize = 10000000;
+	size_t nSamples = 256;					// 每个工作进程的样本个数
+	Distribution eDist = UNIFORM;
+	unsigned long long nSeed = 20190511;
+	int nPercent = 1;
+	LocalSort eLocalSort = LOCAL_MERGE_SORT;
+	Transport eTransport = TRANSPORT_TCP;
+	int nTimeoutSeconds = 60;				// 数据交换时没有任何进展的最长时间
+};
+
+static void PrintUsage(const char* szProgram_)
+{
+	std::cout << "用法：" << szProgram_ << " [选项]" << std::endl
+		<< "  --workers N           工作进程的个数，默认为4" << std::endl
+		<< "  --size N              元素的总个数，默认为10^7" << std::endl
+		<< "  --dist NAME           数据分布: uniform,sorted,reversed,organ-pipe,sawtooth," << std::endl
+		<< "                        few-unique,zipf,nearly-sorted, 默认为uniform" << std::endl
+		<< "  --percent K           nearly-sorted中打乱的元素的百分比，默认为1" << std::endl
+		<< "  --seed S              随机数种子" << std::endl
+		<< "  --samples N           每个工作进程的样本个数，默认为256" << std::endl
+		<< "  --local-sort NAME     本地排序算法: merge或quick, 默认为merge" << std::endl
+		<< "  --transport NAME      数据交换使用的套接字: tcp或unix, 默认为tcp" << std::endl
+		<< "  --timeout SECONDS     数据交换时没有任何进展的最长时间，超过之后放弃，默认为60" << std::endl;
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& options_)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string _strArg = argv[i];
+		if (_strArg == "--help" || _strArg == "-h")
+			return false;
+		if (i + 1 >= argc)
+		{
+			std::cerr << "参数" << _strArg << "缺少取值" << std::endl;
+			return false;
+		}
+
+		std::string _strValue = argv[++i];
+		if (_strArg == "--workers")
+			options_.nWorkers = std::atoi(_strValue.c_str());
+		else if (_strArg == "--size")
+			options_.nSize = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--samples")
+			options_.nSamples = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--seed")
+			options_.nSeed = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--percent")
+			options_.nPercent = std::atoi(_strValue.c_str());
+		else if (_strArg == "--timeout")
+			options_.nTimeoutSeconds = std::atoi(_strValue.c_str());
+		else if (_strArg == "--dist")
+		{
+			if (!ParseDistribution(_strValue, options_.eDist))
+			{
+				std::cerr << "未知的数据分布：" << _strValue << std::endl;
+				return false;
+			}
+		}
+		else if (_strArg == "--local-sort" && (_strValue == "merge" || _strValue == "quick"))
+			options_.eLocalSort = _strValue == "merge" ? LOCAL_MERGE_SORT : LOCAL_QUICK_SORT;
+		else if (_strArg == "--transport" && (_strValue == "tcp" || _strValue == "unix"))
+			options_.eTransport = _strValue == "tcp" ? TRANSPORT_TCP : TRANSPORT_UNIX;
+		else
+		{
+			std::cerr << "未知的参数：" << _strArg << " " << _strValue << std::endl;
+			return false;
+		}
+	}
+
+	if (options_.nWorkers < 1 || options_.nWorkers > 256 || options_.nSamples < 1)
+	{
+		std::cerr << "工作进程的个数必须在[1, 256]之间, 样本个数必须大于0" << std::endl;
+		return false;
+	}
+	if (options_.nTimeoutSeconds < 1 || options_.nTimeoutSeconds > 24 * 3600)
+	{
+		std::cerr << "超时时间必须在[1, 86400]秒之间" << std::endl;
+		return false;
+	}
+	if (options_.nSize / options_.nWorkers >= static_cast<size_t>(INT_MAX))
+	{
+		std::cerr << "每个工作进程的数据太多, 请增加工作进程的个数" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*******************    控制通道的消息        *****************/
+// 工作进程在各个阶段花费的时间
+enum WorkerPhase
+{
+	PHASE_GENERATE,			// 生成数据
+	PHASE_LOCAL_SORT,		// 本地排序
+	PHASE_PARTITION,		// 按分割点划分
+	PHASE_EXCHANGE,			// 数据交换
+	PHASE_MERGE,			// 多路归并
+	PHASE_COUNT,
+};
+
+static const char* s_szPhaseNames[PHASE_COUNT] = {"生成数据", "本地排序", "划分", "数据交换", "多路归并"};
+
+// 工作进程启动后发给协调进程的第一个消息
+struct HelloMessage
+{
+	int nRank;
+	Endpoint endpoint;			// 用于接收其它工作进程数据的地址
+};
+
+// 工作进程之间发送一段数据前的头部
+struct RunHeader
+{
+	unsigned int nRank;			// 发送者的编号
+	unsigned int nReserved;
+	unsigned long long nCount;	// 元素的个数
+};
+
+// 工作进程结束时发给协调进程的报告
+struct WorkerReport
+{
+	int nRank;
+	int bSorted;							// 本地的结果是否有序
+	int nMin;								// 最小值与最大值，用于检查相邻进程的边界
+	int nMax;
+	unsigned long long nInputCount;
+	unsigned long long nInputChecksum;
+	unsigned long long nOutputCount;
+	unsigned long long nOutputChecksum;
+	unsigned long long nBytesSent;			// 发给其它工作进程的字节数
+	unsigned long long nBytesReceived;		// 从其它工作进程收到的字节数
+	double dSeconds[PHASE_COUNT];
+};
+
+/*******************    工作进程        *****************/
+static bool Less(int lhs, int rhs)
+{
+	return lhs < rhs;
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start_)
+{
+	std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - start_;
+	return _elapsed.count();
+}
+
+static unsigned long long Checksum(const int array[], size_t nLength_)
+{
+	unsigned long long _nSum = 0;
+	for (size_t i = 0; i < nLength_; ++i)
+		_nSum += static_cast<unsigned int>(array[i]);
+	return _nSum;
+}
+
+// 从有序的数组中等间隔地选出nSamples_个样本，取每一小段的中间位置。
+static void PickSamples(const std::vector<int>& vecSorted_, size_t nSamples_, std::vector<int>& vecSamples_)
+{
+	vecSamples_.clear();
+	if (vecSorted_.empty())
+		return;
+	if (vecSorted_.size() <= nSamples_)
+	{
+		vecSamples_ = vecSorted_;
+		return;
+	}
+	for (size_t i = 0; i < nSamples_; ++i)
+		vecSamples_.push_back(vecSorted_[(2 * i + 1) * vecSorted_.size() / (2 * nSamples_)]);
+}
+
+// 按照N-1个分割点把有序的数组划分为N段，第j段为[vecBounds_[j], vecBounds_[j + 1]).
+// 一组连续相等的分割点(共g个, 值为v)把等于v的元素平均分成g+1份，小于v的元素与第一份在
+// 一起, 大于v的元素与最后一份在一起。
+static void PartitionBySplitters(const std::vector<int>& vecSorted_, const std::vector<int>& vecSplitters_,
+		std::vector<size_t>& vecBounds_)
+{
+	const size_t _nParts = vecSplitters_.size() + 1;
+	vecBounds_.assign(_nParts + 1, 0);
+	vecBounds_[_nParts] = vecSorted_.size();
+
+	size_t _nGroupStart = 0;
+	while (_nGroupStart < vecSplitters_.size())
+	{
+		size_t _nGroupEnd = _nGroupStart + 1;
+		while (_nGroupEnd < vecSplitters_.size() && vecSplitters_[_nGroupEnd] == vecSplitters_[_nGroupStart])
+			++_nGroupEnd;
+
+		int _nValue = vecSplitters_[_nGroupStart];
+		size_t _nLower = std::lower_bound(vecSorted_.begin(), vecSorted_.end(), _nValue) - vecSorted_.begin();
+		size_t _nUpper = std::upper_bound(vecSorted_.begin(), vecSorted_.end(), _nValue) - vecSorted_.begin();
+		size_t _nGroupSize = _nGroupEnd - _nGroupStart;
+		for (size_t j = 0; j < _nGroupSize; ++j)
+			vecBounds_[_nGroupStart + j + 1] = _nLower + (_nUpper - _nLower) * (j + 1) / (_nGroupSize + 1);
+
+		_nGroupStart = _nGroupEnd;
+	}
+}
+
+// 一个正在接收数据的连接
+struct Incoming
+{
+	int nFd;
+	RunHeader header;
+	size_t nHeaderBytes;		// 已经收到的头部字节数
+	size_t nDataBytes;			// 已经收到的数据字节数
+	bool bDone;
+};
+
+static void CloseIncoming(std::vector<Incoming>& vecIncoming_)
+{
+	for (size_t i = 0; i < vecIncoming_.size(); ++i)
+	{
+		if (!vecIncoming_[i].bDone)
+			close(vecIncoming_[i].nFd);
+	}
+}
+
+// 接收其它nPeers_个工作进程发来的数据，放到vecRuns_中对应的位置上。
+// 使用poll()同时等待新的连接与所有连接上的数据，哪个连接上有数据就先读哪个，这样发送方不会
+// 因为接收方在等待另一个连接而阻塞。
+// 连续nTimeoutMs_毫秒没有新的连接也没有收到数据(有的工作进程已经退出或者卡住了), 或者某个
+// 连接在数据收完之前断开、出错时，返回false.
+static bool ReceiveRuns(int nListenFd_, int nPeers_, int nTimeoutMs_, std::vector<std::vector<int> >& vecRuns_,
+		unsigned long long& nBytesReceived_)
+{
+	std::vector<Incoming> _vecIncoming;
+	int _nFinished = 0;
+	bool _bOk = true;
+	while (_bOk && _nFinished < nPeers_)
+	{
+		std::vector<pollfd> _vecPollFds;
+		std::vector<size_t> _vecIndexes;
+		if (static_cast<int>(_vecIncoming.size()) < nPeers_)
+		{
+			pollfd _pollFd = {nListenFd_, POLLIN, 0};
+			_vecPollFds.push_back(_pollFd);
+			_vecIndexes.push_back(static_cast<size_t>(-1));
+		}
+		for (size_t i = 0; i < _vecIncoming.size(); ++i)
+		{
+			if (_vecIncoming[i].bDone)
+				continue;
+			pollfd _pollFd = {_vecIncoming[i].nFd, POLLIN, 0};
+			_vecPollFds.push_back(_pollFd);
+			_vecIndexes.push_back(i);
+		}
+
+		int _nReady = poll(&_vecPollFds[0], _vecPollFds.size(), nTimeoutMs_);
+		if (_nReady < 0 && errno == EINTR)
+			continue;
+		if (_nReady <= 0)
+		{
+			if (_nReady == 0)
+				std::cerr << "数据交换超时：只收到了" << _nFinished << "/" << nPeers_ << "个工作进程的数据" << std::endl;
+			_bOk = false;
+			break;
+		}
+
+		for (size_t i = 0; _bOk && i < _vecPollFds.size(); ++i)
+		{
+			if (_vecPollFds[i].revents == 0)
+				continue;
+
+			if (_vecIndexes[i] == static_cast<size_t>(-1))
+			{
+				int _nFd = accept(nListenFd_, nullptr, nullptr);
+				if (_nFd < 0)
+				{
+					_bOk = false;
+					break;
+				}
+				SetSocketBuffer(_nFd, 4 << 20);
+				Incoming _incoming = {_nFd, RunHeader(), 0, 0, false};
+				_vecIncoming.push_back(_incoming);
+				continue;
+			}
+
+			Incoming& _incoming = _vecIncoming[_vecIndexes[i]];
+			ssize_t _nRead = 0;
+			if (_incoming.nHeaderBytes < sizeof(RunHeader))
+			{
+				char* _pHeader = reinterpret_cast<char*>(&_incoming.header);
+				_nRead = recv(_incoming.nFd, _pHeader + _incoming.nHeaderBytes,
+						sizeof(RunHeader) - _incoming.nHeaderBytes, 0);
+				if (_nRead < 0 && errno == EINTR)
+					continue;
+				if (_nRead <= 0)
+				{
+					_bOk = false;
+					break;
+				}
+				_incoming.nHeaderBytes += _nRead;
+				if (_incoming.nHeaderBytes == sizeof(RunHeader))
+				{
+					if (_incoming.header.nRank >= vecRuns_.size())
+					{
+						_bOk = false;
+						break;
+					}
+					vecRuns_[_incoming.header.nRank].resize(_incoming.header.nCount);
+				}
+			}
+			else
+			{
+				std::vector<int>& _vecRun = vecRuns_[_incoming.header.nRank];
+				char* _pData = reinterpret_cast<char*>(_vecRun.data());
+				_nRead = recv(_incoming.nFd, _pData + _incoming.nDataBytes,
+						_vecRun.size() * sizeof(int) - _incoming.nDataBytes, 0);
+				if (_nRead < 0 && errno == EINTR)
+					continue;
+				if (_nRead <= 0)
+				{
+					_bOk = false;
+					break;
+				}
+				_incoming.nDataBytes += _nRead;
+			}
+
+			if (_incoming.nHeaderBytes == sizeof(RunHeader)
+					&& _incoming.nDataBytes == _incoming.header.nCount * sizeof(int))
+			{
+				nBytesReceived_ += sizeof(RunHeader) + _incoming.nDataBytes;
+				_incoming.bDone = true;
+				close(_incoming.nFd);
+				++_nFinished;
+			}
+		}
+	}
+
+	if (!_bOk)
+		CloseIncoming(_vecIncoming);
+	return _bOk;
+}
+
+// 把第j段数据发给进程j, 从自己的下一个进程开始轮流发送，避免所有进程同时发给同一个进程。
+// 对方nTimeoutMs_毫秒内一直不接收数据时发送失败。
+static bool SendRuns(int nRank_, int nTimeoutMs_, const std::vector<Endpoint>& vecEndpoints_,
+		const std::vector<int>& vecSorted_, const std::vector<size_t>& vecBounds_, unsigned long long& nBytesSent_)
+{
+	const int _nWorkers = static_cast<int>(vecEndpoints_.size());
+	for (int i = 1; i < _nWorkers; ++i)
+	{
+		int _nPeer = (nRank_ + i) % _nWorkers;
+		int _nFd = ConnectTo(vecEndpoints_[_nPeer]);
+		if (_nFd < 0)
+			return false;
+		SetSocketBuffer(_nFd, 4 << 20);
+		SetSendTimeout(_nFd, nTimeoutMs_);
+
+		RunHeader _header;
+		_header.nRank = nRank_;
+		_header.nReserved = 0;
+		_header.nCount = vecBounds_[_nPeer + 1] - vecBounds_[_nPeer];
+		bool _bOk = WriteAll(_nFd, &_header, sizeof(_header))
+			&& WriteAll(_nFd, vecSorted_.data() + vecBounds_[_nPeer], _header.nCount * sizeof(int));
+		close(_nFd);
+		if (!_bOk)
+			return false;
+		nBytesSent_ += sizeof(_header) + _header.nCount * sizeof(int);
+	}
+	return true;
+}
+
+// 使用最小堆对多个有序的数组进行多路归并, 堆中存放数组的下标，按照数组当前的元素比较大小。
+static void SiftDown(std::vector<int>& vecHeap_, size_t nIndex_, const std::vector<std::vector<int> >& vecRuns_,
+		const std::vector<size_t>& vecPositions_)
+{
+	const size_t _nSize = vecHeap_.size();
+	int _nRun = vecHeap_[nIndex_];
+	int _nValue = vecRuns_[_nRun][vecPositions_[_nRun]];
+	while (2 * nIndex_ + 1 < _nSize)
+	{
+		size_t _nChild = 2 * nIndex_ + 1;
+		if (_nChild + 1 < _nSize && vecRuns_[vecHeap_[_nChild + 1]][vecPositions_[vecHeap_[_nChild + 1]]]
+				< vecRuns_[vecHeap_[_nChild]][vecPositions_[vecHeap_[_nChild]]])
+			++_nChild;
+		if (vecRuns_[vecHeap_[_nChild]][vecPositions_[vecHeap_[_nChild]]] >= _nValue)
+			break;
+		vecHeap_[nIndex_] = vecHeap_[_nChild];
+		nIndex_ = _nChild;
+	}
+	vecHeap_[nIndex_] = _nRun;
+}
+
+static void KWayMerge(const std::vector<std::vector<int> >& vecRuns_, std::vector<int>& vecOut_)
+{
+	size_t _nTotal = 0;
+	std::vector<int> _vecHeap;
+	std::vector<size_t> _vecPositions(vecRuns_.size(), 0);
+	for (size_t i = 0; i < vecRuns_.size(); ++i)
+	{
+		_nTotal += vecRuns_[i].size();
+		if (!vecRuns_[i].empty())
+			_vecHeap.push_back(static_cast<int>(i));
+	}
+
+	vecOut_.resize(_nTotal);
+	for (size_t i = _vecHeap.size() / 2; i-- > 0; )
+		SiftDown(_vecHeap, i, vecRuns_, _vecPositions);
+
+	size_t _nIndex = 0;
+	while (!_vecHeap.empty())
+	{
+		int _nRun = _vecHeap[0];
+		vecOut_[_nIndex++] = vecRuns_[_nRun][_vecPositions[_nRun]];
+		if (++_vecPositions[_nRun] == vecRuns_[_nRun].size())
+		{
+			_vecHeap[0] = _vecHeap.back();
+			_vecHeap.pop_back();
+		}
+		if (!_vecHeap.empty())
+			SiftDown(_vecHeap, 0, vecRuns_, _vecPositions);
+	}
+}
+
+// 工作进程的主函数，返回值作为进程的退出码
+static int RunWorker(int nRank_, int nControlFd_, const Options& options_)
+{
+	WorkerReport _report;
+	memset(&_report, 0, sizeof(_report));
+	_report.nRank = nRank_;
+
+	// 生成自己的那一部分数据
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	size_t _nLocalSize = options_.nSize / options_.nWorkers
+		+ (static_cast<size_t>(nRank_) < options_.nSize % options_.nWorkers ? 1 : 0);
+	std::vector<int> _vecData;
+	GenerateInput(_vecData, _nLocalSize, options_.eDist, options_.nSeed + nRank_, options_.nPercent);
+	_report.nInputCount = _vecData.size();
+	_report.nInputChecksum = Checksum(_vecData.data(), _vecData.size());
+	_report.dSeconds[PHASE_GENERATE] = SecondsSince(_start);
+
+	// 在排序之前开始监听，这样其它进程开始交换数据时一定可以连接上
+	HelloMessage _hello;
+	_hello.nRank = nRank_;
+	std::string _strPath = "/tmp/dist_sort." + std::to_string(getppid()) + "." + std::to_string(nRank_);
+	int _nListenFd = ListenOn(options_.eTransport, _strPath.c_str(), _hello.endpoint);
+	if (_nListenFd < 0 || !WriteAll(nControlFd_, &_hello, sizeof(_hello)))
+	{
+		std::cerr << "工作进程" << nRank_ << "：无法创建监听套接字" << std::endl;
+		return 1;
+	}
+
+	// 本地排序
+	_start = std::chrono::steady_clock::now();
+	if (!_vecData.empty())
+	{
+		if (options_.eLocalSort == LOCAL_MERGE_SORT)
+			MergeSort(_vecData.data(), 0, static_cast<int>(_vecData.size()), Less);
+		else
+			QuickSort_Version2(_vecData.data(), 0, static_cast<int>(_vecData.size()), Less);
+	}
+	_report.dSeconds[PHASE_LOCAL_SORT] = SecondsSince(_start);
+
+	// 发送样本，接收所有进程的地址与分割点
+	std::vector<int> _vecSamples;
+	PickSamples(_vecData, options_.nSamples, _vecSamples);
+	unsigned long long _nSampleCount = _vecSamples.size();
+	std::vector<Endpoint> _vecEndpoints(options_.nWorkers);
+	std::vector<int> _vecSplitters(options_.nWorkers - 1);
+	if (!WriteAll(nControlFd_, &_nSampleCount, sizeof(_nSampleCount))
+			|| !WriteAll(nControlFd_, _vecSamples.data(), _vecSamples.size() * sizeof(int))
+			|| !ReadAll(nControlFd_, _vecEndpoints.data(), _vecEndpoints.size() * sizeof(Endpoint))
+			|| !ReadAll(nControlFd_, _vecSplitters.data(), _vecSplitters.size() * sizeof(int)))
+	{
+		std::cerr << "工作进程" << nRank_ << "：与协调进程的连接断开" << std::endl;
+		return 1;
+	}
+
+	// 划分
+	_start = std::chrono::steady_clock::now();
+	std::vector<size_t> _vecBounds;
+	PartitionBySplitters(_vecData, _vecSplitters, _vecBounds);
+	_report.dSeconds[PHASE_PARTITION] = SecondsSince(_start);
+
+	// 数据交换：另外一个线程负责发送，当前线程负责接收
+	_start = std::chrono::steady_clock::now();
+	std::vector<std::vector<int> > _vecRuns(options_.nWorkers);
+	_vecRuns[nRank_].assign(_vecData.begin() + _vecBounds[nRank_], _vecData.begin() + _vecBounds[nRank_ + 1]);
+	const int _nTimeoutMs = options_.nTimeoutSeconds * 1000;
+	std::atomic<bool> _bSendOk(true);
+	std::thread _sender([&]() {
+		_bSendOk = SendRuns(nRank_, _nTimeoutMs, _vecEndpoints, _vecData, _vecBounds, _report.nBytesSent);
+	});
+	bool _bReceiveOk = ReceiveRuns(_nListenFd, options_.nWorkers - 1, _nTimeoutMs, _vecRuns, _report.nBytesReceived);
+	_sender.join();
+	close(_nListenFd);
+	if (options_.eTransport == TRANSPORT_UNIX)
+		unlink(_strPath.c_str());
+	if (!_bSendOk || !_bReceiveOk)
+	{
+		std::cerr << "工作进程" << nRank_ << "：数据交换失败" << std::endl;
+		return 1;
+	}
+	std::vector<int>().swap(_vecData);
+	_report.dSeconds[PHASE_EXCHANGE] = SecondsSince(_start);
+
+	// 多路归并
+	_start = std::chrono::steady_clock::now();
+	std::vector<int> _vecResult;
+	KWayMerge(_vecRuns, _vecResult);
+	std::vector<std::vector<int> >().swap(_vecRuns);
+	_report.dSeconds[PHASE_MERGE] = SecondsSince(_start);
+
+	// 检查结果并报告
+	_report.bSorted = std::is_sorted(_vecResult.begin(), _vecResult.end()) ? 1 : 0;
+	_report.nOutputCount = _vecResult.size();
+	_report.nOutputChecksum = Checksum(_vecResult.data(), _vecResult.size());
+	_report.nMin = _vecResult.empty() ? 0 : _vecResult.front();
+	_report.nMax = _vecResult.empty() ? 0 : _vecResult.back();
+	if (!WriteAll(nControlFd_, &_report, sizeof(_report)))
+		return 1;
+	return 0;
+}
+
+/*******************    协调进程        *****************/
+static void KillWorkers(const std::vector<pid_t>& vecPids_)
+{
+	for (size_t i = 0; i < vecPids_.size(); ++i)
+		kill(vecPids_[i], SIGKILL);
+	for (size_t i = 0; i < vecPids_.size(); ++i)
+		waitpid(vecPids_[i], nullptr, 0);
+}
+
+// 同时等待所有工作进程的报告，哪个先到先读哪个。任何一个控制通道在报告之前断开(工作进程失败
+// 退出或者被杀掉)就立即返回false, 不再等待其它还在等着它的数据的工作进程。
+static bool ReadReports(const std::vector<int>& vecControlFds_, std::vector<WorkerReport>& vecReports_)
+{
+	std::vector<bool> _vecReceived(vecControlFds_.size(), false);
+	size_t _nReceived = 0;
+	while (_nReceived < vecControlFds_.size())
+	{
+		std::vector<pollfd> _vecPollFds;
+		std::vector<size_t> _vecIndexes;
+		for (size_t i = 0; i < vecControlFds_.size(); ++i)
+		{
+			if (_vecReceived[i])
+				continue;
+			pollfd _pollFd = {vecControlFds_[i], POLLIN, 0};
+			_vecPollFds.push_back(_pollFd);
+			_vecIndexes.push_back(i);
+		}
+
+		if (poll(&_vecPollFds[0], _vecPollFds.size(), -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+
+		for (size_t i = 0; i < _vecPollFds.size(); ++i)
+		{
+			if (_vecPollFds[i].revents == 0)
+				continue;
+			size_t _nIndex = _vecIndexes[i];
+			if (!ReadAll(vecControlFds_[_nIndex], &vecReports_[_nIndex], sizeof(WorkerReport))
+					|| vecReports_[_nIndex].nRank != static_cast<int>(_nIndex))
+			{
+				std::cerr << "工作进程" << _nIndex << "没有报告就退出了" << std::endl;
+				return false;
+			}
+			_vecReceived[_nIndex] = true;
+			++_nReceived;
+		}
+	}
+	return true;
+}
+
+// 检查所有工作进程的报告，排序结果正确时返回true
+static bool CheckReports(const std::vector<WorkerReport>& vecReports_)
+{
+	unsigned long long _nInputCount = 0, _nInputChecksum = 0, _nOutputCount = 0, _nOutputChecksum = 0;
+	bool _bHasPrevious = false;
+	int _nPreviousMax = 0;
+	bool _bOk = true;
+	for (size_t i = 0; i < vecReports_.size(); ++i)
+	{
+		const WorkerReport& _report = vecReports_[i];
+		_nInputCount += _report.nInputCount;
+		_nInputChecksum += _report.nInputChecksum;
+		_nOutputCount += _report.nOutputCount;
+		_nOutputChecksum += _report.nOutputChecksum;
+		if (!_report.bSorted)
+		{
+			std::cerr << "工作进程" << i << "的结果无序" << std::endl;
+			_bOk = false;
+		}
+		if (_report.nOutputCount == 0)
+			continue;
+		if (_bHasPrevious && _nPreviousMax > _report.nMin)
+		{
+			std::cerr << "工作进程" << i << "的最小值小于前一个进程的最大值" << std::endl;
+			_bOk = false;
+		}
+		_bHasPrevious = true;
+		_nPreviousMax = _report.nMax;
+	}
+	if (_nInputCount != _nOutputCount || _nInputChecksum != _nOutputChecksum)
+	{
+		std::cerr << "排序前后元素的个数或者校验和不相等" << std::endl;
+		_bOk = false;
+	}
+	return _bOk;
+}
+
+static void PrintSummary(const Options& options_, const std::vector<WorkerReport>& vecReports_,
+		double dSampleSeconds_, double dTotalSeconds_)
+{
+	// 每个阶段的时间取最慢的那个工作进程
+	double _dSeconds[PHASE_COUNT] = {0};
+	unsigned long long _nBytesShuffled = 0;
+	unsigned long long _nMaxCount = 0;
+	for (size_t i = 0; i < vecReports_.size(); ++i)
+	{
+		for (int j = 0; j < PHASE_COUNT; ++j)
+			_dSeconds[j] = std::max(_dSeconds[j], vecReports_[i].dSeconds[j]);
+		_nBytesShuffled += vecReports_[i].nBytesSent;
+		_nMaxCount = std::max(_nMaxCount, vecReports_[i].nOutputCount);
+	}
+
+	const double _dElements = static_cast<double>(options_.nSize);
+	std::cout << std::fixed << std::setprecision(4);
+	std::cout << PadRight("阶段", 10) << PadRight("耗时(秒)", 12) << "吞吐量(Melem/s)" << std::endl;
+	for (int j = 0; j < PHASE_COUNT; ++j)
+	{
+		std::cout << PadRight(s_szPhaseNames[j], 10) << std::left << std::setw(12) << _dSeconds[j]
+			<< std::setw(16) << (_dSeconds[j] > 0 ? _dElements / _dSeconds[j] / 1e6 : 0.0);
+		if (j == PHASE_EXCHANGE && _dSeconds[j] > 0)
+			std::cout << "    " << _nBytesShuffled / _dSeconds[j] / 1e6 << " MB/s";
+		std::cout << std::endl;
+	}
+	std::cout << PadRight("采样", 10) << std::left << std::setw(12) << dSampleSeconds_
+		<< std::setw(16) << "-" << "    (协调进程排序样本并选择分割点)" << std::endl;
+	std::cout << PadRight("总计", 10) << std::left << std::setw(12) << dTotalSeconds_
+		<< std::setw(16) << _dElements / dTotalSeconds_ / 1e6 << std::endl;
+
+	double _dAverage = _dElements / options_.nWorkers;
+	std::cout << "交换的数据量：" << _nBytesShuffled << "字节("
+		<< (_dElements > 0 ? 100.0 * _nBytesShuffled / (_dElements * sizeof(int)) : 0.0) << "%)" << std::endl;
+	std::cout << "负载均衡：最大分区/平均分区 = " << (_dAverage > 0 ? _nMaxCount / _dAverage : 0.0) << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Options _options;
+	if (!ParseOptions(argc, argv, _options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	std::cout << "分布式排序：" << _options.nWorkers << "个工作进程, " << _options.nSize << "个元素, 数据分布"
+		<< DistributionName(_options.eDist) << ", 本地排序"
+		<< (_options.eLocalSort == LOCAL_MERGE_SORT ? "MergeSort" : "QuickSort_Version2") << ", 使用"
+		<< (_options.eTransport == TRANSPORT_TCP ? "TCP" : "Unix域套接字") << "交换数据" << std::endl;
+	std::cout.flush();
+
+	// 创建工作进程，每个工作进程一个控制通道
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	std::vector<int> _vecControlFds;
+	std::vector<pid_t> _vecPids;
+	for (int i = 0; i < _options.nWorkers; ++i)
+	{
+		int _fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM, 0, _fds) != 0)
+		{
+			std::cerr << "创建控制通道失败" << std::endl;
+			KillWorkers(_vecPids);
+			return 1;
+		}
+
+		pid_t _nPid = fork();
+		if (_nPid < 0)
+		{
+			std::cerr << "创建工作进程失败" << std::endl;
+			KillWorkers(_vecPids);
+			return 1;
+		}
+		if (_nPid == 0)
+		{
+			for (size_t j = 0; j < _vecControlFds.size(); ++j)
+				close(_vecControlFds[j]);
+			close(_fds[0]);
+			_exit(RunWorker(i, _fds[1], _options));
+		}
+		close(_fds[1]);
+		_vecControlFds.push_back(_fds[0]);
+		_vecPids.push_back(_nPid);
+	}
+
+	// 收集地址与样本
+	std::vector<Endpoint> _vecEndpoints(_options.nWorkers);
+	std::vector<int> _vecSamples;
+	bool _bOk = true;
+	for (int i = 0; i < _options.nWorkers && _bOk; ++i)
+	{
+		HelloMessage _hello;
+		_bOk = ReadAll(_vecControlFds[i], &_hello, sizeof(_hello)) && _hello.nRank == i;
+		_vecEndpoints[i] = _hello.endpoint;
+	}
+	for (int i = 0; i < _options.nWorkers && _bOk; ++i)
+	{
+		unsigned long long _nCount = 0;
+		_bOk = ReadAll(_vecControlFds[i], &_nCount, sizeof(_nCount)) && _nCount <= _options.nSamples;
+		if (!_bOk)
+			break;
+		size_t _nOldSize = _vecSamples.size();
+		_vecSamples.resize(_nOldSize + _nCount);
+		_bOk = ReadAll(_vecControlFds[i], _vecSamples.data() + _nOldSize, _nCount * sizeof(int));
+	}
+	if (!_bOk)
+	{
+		std::cerr << "工作进程异常退出" << std::endl;
+		KillWorkers(_vecPids);
+		return 1;
+	}
+
+	// 对样本排序，等间隔地选出分割点后广播给所有的工作进程
+	std::chrono::steady_clock::time_point _sampleStart = std::chrono::steady_clock::now();
+	std::vector<int> _vecSplitters(_options.nWorkers - 1, 0);
+	if (!_vecSamples.empty())
+	{
+		MergeSort(_vecSamples.data(), 0, static_cast<int>(_vecSamples.size()), Less);
+		for (int i = 1; i < _options.nWorkers; ++i)
+			_vecSplitters[i - 1] = _vecSamples[i * _vecSamples.size() / _options.nWorkers];
+	}
+	double _dSampleSeconds = SecondsSince(_sampleStart);
+	for (int i = 0; i < _options.nWorkers && _bOk; ++i)
+	{
+		_bOk = WriteAll(_vecControlFds[i], _vecEndpoints.data(), _vecEndpoints.size() * sizeof(Endpoint))
+			&& WriteAll(_vecControlFds[i], _vecSplitters.data(), _vecSplitters.size() * sizeof(int));
+	}
+
+	// 等待所有工作进程的报告
+	std::vector<WorkerReport> _vecReports(_options.nWorkers);
+	_bOk = _bOk && ReadReports(_vecControlFds, _vecReports);
+	double _dTotalSeconds = SecondsSince(_start);
+	if (!_bOk)
+	{
+		std::cerr << "工作进程异常退出" << std::endl;
+		KillWorkers(_vecPids);
+		return 1;
+	}
+
+	int _nFailed = 0;
+	for (int i = 0; i < _options.nWorkers; ++i)
+	{
+		int _nStatus = 0;
+		close(_vecControlFds[i]);
+		waitpid(_vecPids[i], &_nStatus, 0);
+		if (!WIFEXITED(_nStatus) || WEXITSTATUS(_nStatus) != 0)
+			++_nFailed;
+	}
+
+	PrintSummary(_options, _vecReports, _dSampleSeconds, _dTotalSeconds);
+	bool _bCorrect = _nFailed == 0 && CheckReports(_vecReports);
+	std::cout << "排序结果" << (_bCorrect ? "正确" : "错误") << std::endl;
+	return _bCorrect ? 0 : 1;
+}
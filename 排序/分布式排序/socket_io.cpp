@@ -0,0 +1,179 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 23时05分17秒
+*   Modifed Time: 2026年10月20日 星期二 01时12分40秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "socket_io.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+bool WriteAll(int nFd_, const void* pData_, size_t nSize_)
+{
+	const char* _pData = static_cast<const char*>(pData_);
+	while (nSize_ > 0)
+	{
+		ssize_t _nWritten = send(nFd_, _pData, nSize_, MSG_NOSIGNAL);
+		if (_nWritten < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		_pData += _nWritten;
+		nSize_ -= _nWritten;
+	}
+	return true;
+}
+
+bool ReadAll(int nFd_, void* pData_, size_t nSize_)
+{
+	char* _pData = static_cast<char*>(pData_);
+	while (nSize_ > 0)
+	{
+		ssize_t _nRead = recv(nFd_, _pData, nSize_, 0);
+		if (_nRead < 0 && errno == EINTR)
+			continue;
+		if (_nRead <= 0)
+			return false;
+		_pData += _nRead;
+		nSize_ -= _nRead;
+	}
+	return true;
+}
+
+int ListenOn(Transport eTransport_, const char* szPath_, Endpoint& endpoint_)
+{
+	memset(&endpoint_, 0, sizeof(endpoint_));
+	endpoint_.nTransport = eTransport_;
+
+	int _nFd = -1;
+	if (eTransport_ == TRANSPORT_TCP)
+	{
+		_nFd = socket(AF_INET, SOCK_STREAM, 0);
+		if (_nFd < 0)
+			return -1;
+
+		sockaddr_in _addr;
+		memset(&_addr, 0, sizeof(_addr));
+		_addr.sin_family = AF_INET;
+		_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		_addr.sin_port = 0;
+		socklen_t _nLength = sizeof(_addr);
+		if (bind(_nFd, reinterpret_cast<sockaddr*>(&_addr), sizeof(_addr)) != 0
+				|| getsockname(_nFd, reinterpret_cast<sockaddr*>(&_addr), &_nLength) != 0)
+		{
+			close(_nFd);
+			return -1;
+		}
+		endpoint_.nPort = ntohs(_addr.sin_port);
+		inet_ntop(AF_INET, &_addr.sin_addr, endpoint_.szAddress, sizeof(endpoint_.szAddress));
+	}
+	else
+	{
+		sockaddr_un _addr;
+		if (szPath_ == nullptr || strlen(szPath_) >= sizeof(_addr.sun_path))
+			return -1;
+		_nFd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (_nFd < 0)
+			return -1;
+
+		memset(&_addr, 0, sizeof(_addr));
+		_addr.sun_family = AF_UNIX;
+		strcpy(_addr.sun_path, szPath_);
+		unlink(szPath_);
+		if (bind(_nFd, reinterpret_cast<sockaddr*>(&_addr), sizeof(_addr)) != 0)
+		{
+			close(_nFd);
+			return -1;
+		}
+		strcpy(endpoint_.szAddress, szPath_);
+	}
+
+	if (listen(_nFd, SOMAXCONN) != 0)
+	{
+		close(_nFd);
+		return -1;
+	}
+	return _nFd;
+}
+
+int ConnectTo(const Endpoint& endpoint_)
+{
+	int _nFd = -1;
+	if (endpoint_.nTransport == TRANSPORT_TCP)
+	{
+		sockaddr_in _addr;
+		memset(&_addr, 0, sizeof(_addr));
+		_addr.sin_family = AF_INET;
+		_addr.sin_port = htons(endpoint_.nPort);
+		if (inet_pton(AF_INET, endpoint_.szAddress, &_addr.sin_addr) != 1)
+			return -1;
+
+		_nFd = socket(AF_INET, SOCK_STREAM, 0);
+		if (_nFd < 0)
+			return -1;
+		if (connect(_nFd, reinterpret_cast<sockaddr*>(&_addr), sizeof(_addr)) != 0)
+		{
+			close(_nFd);
+			return -1;
+		}
+
+		// 数据都是大块发送的，关闭Nagle算法避免最后一小段数据被延迟
+		int _nOne = 1;
+		setsockopt(_nFd, IPPROTO_TCP, TCP_NODELAY, &_nOne, sizeof(_nOne));
+	}
+	else
+	{
+		sockaddr_un _addr;
+		size_t _nLength = strnlen(endpoint_.szAddress, sizeof(endpoint_.szAddress));
+		if (_nLength >= sizeof(_addr.sun_path))
+			return -1;
+		memset(&_addr, 0, sizeof(_addr));
+		_addr.sun_family = AF_UNIX;
+		memcpy(_addr.sun_path, endpoint_.szAddress, _nLength);
+
+		_nFd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (_nFd < 0)
+			return -1;
+		if (connect(_nFd, reinterpret_cast<sockaddr*>(&_addr), sizeof(_addr)) != 0)
+		{
+			close(_nFd);
+			return -1;
+		}
+	}
+	return _nFd;
+}
+
+void SetSocketBuffer(int nFd_, int nBytes_)
+{
+	setsockopt(nFd_, SOL_SOCKET, SO_SNDBUF, &nBytes_, sizeof(nBytes_));
+	setsockopt(nFd_, SOL_SOCKET, SO_RCVBUF, &nBytes_, sizeof(nBytes_));
+}
+
+void SetSendTimeout(int nFd_, int nMilliseconds_)
+{
+	timeval _timeout;
+	_timeout.tv_sec = nMilliseconds_ / 1000;
+	_timeout.tv_usec = (nMilliseconds_ % 1000) * 1000;
+	setsockopt(nFd_, SOL_SOCKET, SO_SNDTIMEO, &_timeout, sizeof(_timeout));
+}
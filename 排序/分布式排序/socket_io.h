@@ -0,0 +1,56 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 23时05分17秒
+*   Modifed Time: 2026年10月20日 星期二 01时12分40秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef SOCKET_IO_H
+#define SOCKET_IO_H
+#include <cstddef>
+
+// 分布式排序中用到的套接字辅助函数。
+// 工作进程之间可以使用TCP(目前只监听回环地址127.0.0.1)或者Unix域套接字通信，地址用
+// Endpoint表示，它是一个POD结构体，可以直接通过控制通道发送给其它进程。
+enum Transport
+{
+	TRANSPORT_TCP,
+	TRANSPORT_UNIX,
+};
+
+struct Endpoint
+{
+	int nTransport;				// Transport中的一个值
+	unsigned short nPort;		// TCP端口号, 网络字节序之前的值
+	char szAddress[108];		// TCP时为IP地址, Unix域套接字时为文件路径
+};
+
+// 发送/接收恰好nSize_个字节，对方关闭连接或者出错时返回false.
+// 发送时使用MSG_NOSIGNAL, 对方进程退出时不会因为SIGPIPE信号而终止。
+bool WriteAll(int nFd_, const void* pData_, size_t nSize_);
+bool ReadAll(int nFd_, void* pData_, size_t nSize_);
+
+// 创建一个监听套接字，TCP时由系统分配端口号，Unix域套接字时使用szPath_作为文件路径。
+// 成功时返回文件描述符并填写endpoint_, 失败时返回-1.
+int ListenOn(Transport eTransport_, const char* szPath_, Endpoint& endpoint_);
+
+// 连接到endpoint_, 失败时返回-1.
+int ConnectTo(const Endpoint& endpoint_);
+
+// 设置套接字的发送与接收缓冲区的大小，数据交换时使用较大的缓冲区可以减少系统调用的次数。
+void SetSocketBuffer(int nFd_, int nBytes_);
+
+// 设置发送的超时时间, 对方一直不接收数据时WriteAll()在超时之后返回false, 而不是永远阻塞。
+void SetSendTimeout(int nFd_, int nMilliseconds_);
+
+#endif	// SOCKET_IO_H
@@ -0,0 +1,345 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 16时05分12秒
+*   Modifed Time: 2026年10月19日 星期一 19时47分33秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "../sort_stats.h"
+#include "input_generator.h"
+#include "sort_entries.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 排序算法的性能测试程序。
+// 对本目录下的每一个排序算法，在不同的数据分布与不同的数据规模下进行测试，输出每个元素
+// 平均花费的纳秒数与吞吐量，并可以把结果保存为CSV或JSON文件，方便不同版本之间进行对比。
+//
+// 说明：
+// 1. 数据规模从--min-size开始，每次乘以10，直到--max-size为止(最大可以到10^8)。
+// 2. 插入排序与冒泡排序的复杂度为O(N*N), 快速排序在非随机的数据上也会退化为O(N*N)(它选
+// 第一个元素作为划分点), 对于这些情况，数据规模超过--quadratic-limit时跳过不测。
+// 3. 小规模的数据排序一次的时间太短，计时不准确，所以一次准备多份数据连续排序，并且重复
+// 多次，直到总时间超过--min-time为止，取最好的一次作为结果。
+// 4. 使用make STATS=1编译时，还会输出每次排序的比较/交换/移动/内存分配次数。
+//
+/*******************    命令行参数        *****************/
+struct Options
+{
+	size_t nMinSize = 10;
+	size_t nMaxSize = 1000000;
+	size_t nQuadraticLimit = 20000;
+	size_t nCountingLimit = 1 << 26;	// 计数排序中最大值的上限, 超过时跳过不测
+	double dMinSeconds = 0.2;
+	unsigned long long nSeed = 20190511;
+	int nPercent = 1;
+	std::vector<Distribution> vecDistributions;
+	std::vector<std::string> vecSorts;
+	std::string strCsvFile;
+	std::string strJsonFile;
+};
+
+static void PrintUsage(const char* szProgram_)
+{
+	std::cout << "用法：" << szProgram_ << " [选项]" << std::endl
+		<< "  --min-size N          最小的数据规模，默认为10" << std::endl
+		<< "  --max-size N          最大的数据规模，默认为10^6, 最大为10^8" << std::endl
+		<< "  --dist a,b,...        数据分布: uniform,sorted,reversed,organ-pipe,sawtooth," << std::endl
+		<< "                        few-unique,zipf,nearly-sorted, 默认为全部" << std::endl
+		<< "  --sort a,b,...        排序算法的名字，默认为全部" << std::endl
+		<< "  --percent K           nearly-sorted中打乱的元素的百分比，默认为1" << std::endl
+		<< "  --seed S              随机数种子" << std::endl
+		<< "  --quadratic-limit N   O(N*N)的情况下最大的数据规模，默认为20000" << std::endl
+		<< "  --min-time SECONDS    每一项测试最少运行的时间，默认为0.2秒" << std::endl
+		<< "  --csv FILE            把结果保存为CSV文件" << std::endl
+		<< "  --json FILE           把结果保存为JSON文件" << std::endl;
+}
+
+static std::vector<std::string> SplitByComma(const std::string& str_)
+{
+	std::vector<std::string> _vecResult;
+	std::stringstream _stream(str_);
+	std::string _strItem;
+	while (std::getline(_stream, _strItem, ','))
+	{
+		if (!_strItem.empty())
+			_vecResult.push_back(_strItem);
+	}
+	return _vecResult;
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& options_)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string _strArg = argv[i];
+		if (_strArg == "--help" || _strArg == "-h")
+			return false;
+		if (i + 1 >= argc)
+		{
+			std::cerr << "参数" << _strArg << "缺少取值" << std::endl;
+			return false;
+		}
+
+		std::string _strValue = argv[++i];
+		if (_strArg == "--min-size")
+			options_.nMinSize = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--max-size")
+			options_.nMaxSize = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--quadratic-limit")
+			options_.nQuadraticLimit = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--min-time")
+			options_.dMinSeconds = std::atof(_strValue.c_str());
+		else if (_strArg == "--seed")
+			options_.nSeed = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--percent")
+			options_.nPercent = std::atoi(_strValue.c_str());
+		else if (_strArg == "--csv")
+			options_.strCsvFile = _strValue;
+		else if (_strArg == "--json")
+			options_.strJsonFile = _strValue;
+		else if (_strArg == "--sort")
+			options_.vecSorts = SplitByComma(_strValue);
+		else if (_strArg == "--dist")
+		{
+			std::vector<std::string> _vecNames = SplitByComma(_strValue);
+			for (size_t j = 0; j < _vecNames.size(); ++j)
+			{
+				Distribution _eDist;
+				if (!ParseDistribution(_vecNames[j], _eDist))
+				{
+					std::cerr << "未知的数据分布：" << _vecNames[j] << std::endl;
+					return false;
+				}
+				options_.vecDistributions.push_back(_eDist);
+			}
+		}
+		else
+		{
+			std::cerr << "未知的参数：" << _strArg << std::endl;
+			return false;
+		}
+	}
+
+	if (options_.nMinSize == 0 || options_.nMaxSize > 100000000 || options_.nMinSize > options_.nMaxSize)
+	{
+		std::cerr << "数据规模必须在[1, 10^8]之间" << std::endl;
+		return false;
+	}
+
+	if (options_.vecDistributions.empty())
+	{
+		for (int i = 0; i < DISTRIBUTION_COUNT; ++i)
+			options_.vecDistributions.push_back(static_cast<Distribution>(i));
+	}
+	return true;
+}
+
+/*******************    测试与结果输出        *****************/
+struct Result
+{
+	std::string strSort;
+	std::string strDistribution;
+	size_t nSize;
+	size_t nRuns;				// 一共排序了多少次
+	double dBestNsPerElement;	// 最好的一次每个元素花费的纳秒数
+	double dMeanNsPerElement;	// 平均每个元素花费的纳秒数
+	double dMElementsPerSecond;	// 最好的一次的吞吐量, 单位为百万个元素每秒
+	bool bVerified;				// 排序结果是否正确
+	double dCompares;			// 下面几项为平均每次排序的统计值，只在STATS=1时有效
+	double dSwaps;
+	double dMoves;
+	double dAllocations;
+};
+
+// 判断某个算法在给定的分布与规模下是否需要跳过
+static bool ShouldSkip(const SortEntry& entry_, Distribution eDist_, size_t nSize_,
+		const std::vector<int>& vecInput_, const Options& options_)
+{
+	if (IsQuadratic(entry_, eDist_ == UNIFORM) && nSize_ > options_.nQuadraticLimit)
+		return true;
+	if (entry_.bSmallKeysOnly && !vecInput_.empty() &&
+			static_cast<size_t>(*std::max_element(vecInput_.begin(), vecInput_.end())) > options_.nCountingLimit)
+		return true;
+	return false;
+}
+
+static Result Measure(const SortEntry& entry_, Distribution eDist_, const std::vector<int>& vecInput_,
+		const Options& options_)
+{
+	typedef std::chrono::steady_clock Clock;
+	size_t _nSize = vecInput_.size();
+
+	// 一批准备多份数据，使一批至少包含约10^6个元素
+	size_t _nCopies = std::max<size_t>(1, 1000000 / _nSize);
+	std::vector<int> _vecBatch(_nCopies * _nSize);
+
+	// 正确的结果由std::sort得到，每一份排序之后的数据都要与它完全相同(不能丢失或重复元素)
+	std::vector<int> _vecExpected(vecInput_);
+	std::sort(_vecExpected.begin(), _vecExpected.end());
+
+	Result _result = Result();
+	_result.strSort = entry_.szName;
+	_result.strDistribution = DistributionName(eDist_);
+	_result.nSize = _nSize;
+	_result.bVerified = true;
+
+	double _dBestSeconds = 0.0;
+	double _dTotalSeconds = 0.0;
+	SORT_RESET_STATS();
+	do
+	{
+		for (size_t i = 0; i < _nCopies; ++i)
+			std::memcpy(&_vecBatch[i * _nSize], vecInput_.data(), sizeof(int) * _nSize);
+
+		Clock::time_point _start = Clock::now();
+		for (size_t i = 0; i < _nCopies; ++i)
+			entry_.pSort(&_vecBatch[i * _nSize], _nSize);
+		std::chrono::duration<double> _elapsed = Clock::now() - _start;
+
+		double _dSeconds = _elapsed.count() / _nCopies;
+		if (_result.nRuns == 0 || _dSeconds < _dBestSeconds)
+			_dBestSeconds = _dSeconds;
+		_dTotalSeconds += _elapsed.count();
+		_result.nRuns += _nCopies;
+
+		for (size_t i = 0; i < _nCopies; ++i)
+		{
+			if (!std::equal(_vecExpected.begin(), _vecExpected.end(), _vecBatch.begin() + i * _nSize))
+				_result.bVerified = false;
+		}
+	} while (_dTotalSeconds < options_.dMinSeconds);
+
+	_result.dBestNsPerElement = _dBestSeconds * 1e9 / _nSize;
+	_result.dMeanNsPerElement = _dTotalSeconds * 1e9 / _result.nRuns / _nSize;
+	_result.dMElementsPerSecond = _dBestSeconds > 0.0 ? _nSize / _dBestSeconds / 1e6 : 0.0;
+#ifdef SORT_STATS
+	_result.dCompares = static_cast<double>(GetSortStats().nCompares) / _result.nRuns;
+	_result.dSwaps = static_cast<double>(GetSortStats().nSwaps) / _result.nRuns;
+	_result.dMoves = static_cast<double>(GetSortStats().nMoves) / _result.nRuns;
+	_result.dAllocations = static_cast<double>(GetSortStats().nAllocations) / _result.nRuns;
+#endif
+	return _result;
+}
+
+static void WriteCsv(std::ostream& os_, const std::vector<Result>& vecResults_)
+{
+	os_ << "sort,distribution,size,runs,best_ns_per_element,mean_ns_per_element,"
+		"melements_per_second,verified,compares,swaps,moves,allocations\n";
+	for (size_t i = 0; i < vecResults_.size(); ++i)
+	{
+		const Result& _r = vecResults_[i];
+		os_ << _r.strSort << ',' << _r.strDistribution << ',' << _r.nSize << ',' << _r.nRuns << ','
+			<< _r.dBestNsPerElement << ',' << _r.dMeanNsPerElement << ',' << _r.dMElementsPerSecond << ','
+			<< (_r.bVerified ? "true" : "false") << ',' << _r.dCompares << ',' << _r.dSwaps << ','
+			<< _r.dMoves << ',' << _r.dAllocations << '\n';
+	}
+}
+
+static void WriteJson(std::ostream& os_, const std::vector<Result>& vecResults_, const Options& options_)
+{
+	os_ << "{\n  \"seed\": " << options_.nSeed << ",\n  \"percent\": " << options_.nPercent
+		<< ",\n  \"results\": [\n";
+	for (size_t i = 0; i < vecResults_.size(); ++i)
+	{
+		const Result& _r = vecResults_[i];
+		os_ << "    {\"sort\": \"" << _r.strSort << "\", \"distribution\": \"" << _r.strDistribution
+			<< "\", \"size\": " << _r.nSize << ", \"runs\": " << _r.nRuns
+			<< ", \"best_ns_per_element\": " << _r.dBestNsPerElement
+			<< ", \"mean_ns_per_element\": " << _r.dMeanNsPerElement
+			<< ", \"melements_per_second\": " << _r.dMElementsPerSecond
+			<< ", \"verified\": " << (_r.bVerified ? "true" : "false")
+			<< ", \"compares\": " << _r.dCompares << ", \"swaps\": " << _r.dSwaps
+			<< ", \"moves\": " << _r.dMoves << ", \"allocations\": " << _r.dAllocations << "}"
+			<< (i + 1 < vecResults_.size() ? ",\n" : "\n");
+	}
+	os_ << "  ]\n}\n";
+}
+
+static bool IsSelected(const SortEntry& entry_, const Options& options_)
+{
+	if (options_.vecSorts.empty())
+		return true;
+	return std::find(options_.vecSorts.begin(), options_.vecSorts.end(), entry_.szName) != options_.vecSorts.end();
+}
+
+int main(int argc, char* argv[])
+{
+	Options _options;
+	if (!ParseOptions(argc, argv, _options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	std::vector<Result> _vecResults;
+	std::vector<int> _vecInput;
+	std::cout << "sort                      distribution   size        ns/elem(best)  ns/elem(mean)  Melem/s" << std::endl;
+	for (size_t d = 0; d < _options.vecDistributions.size(); ++d)
+	{
+		Distribution _eDist = _options.vecDistributions[d];
+		for (size_t _nSize = _options.nMinSize; _nSize <= _options.nMaxSize; _nSize *= 10)
+		{
+			GenerateInput(_vecInput, _nSize, _eDist, _options.nSeed, _options.nPercent);
+			for (size_t s = 0; s < g_nSortCount; ++s)
+			{
+				const SortEntry& _entry = g_sortEntries[s];
+				if (!IsSelected(_entry, _options) || ShouldSkip(_entry, _eDist, _nSize, _vecInput, _options))
+					continue;
+
+				Result _result = Measure(_entry, _eDist, _vecInput, _options);
+				_vecResults.push_back(_result);
+
+				std::cout.width(26);
+				std::cout << std::left << _result.strSort;
+				std::cout.width(15);
+				std::cout << _result.strDistribution;
+				std::cout.width(12);
+				std::cout << _result.nSize;
+				std::cout.width(15);
+				std::cout << _result.dBestNsPerElement;
+				std::cout.width(15);
+				std::cout << _result.dMeanNsPerElement;
+				std::cout << _result.dMElementsPerSecond;
+				if (!_result.bVerified)
+					std::cout << "  排序结果错误!";
+				std::cout << std::endl;
+			}
+		}
+	}
+
+	if (!_options.strCsvFile.empty())
+	{
+		std::ofstream _file(_options.strCsvFile.c_str());
+		WriteCsv(_file, _vecResults);
+	}
+	if (!_options.strJsonFile.empty())
+	{
+		std::ofstream _file(_options.strJsonFile.c_str());
+		WriteJson(_file, _vecResults, _options);
+	}
+
+	for (size_t i = 0; i < _vecResults.size(); ++i)
+	{
+		if (!_vecResults[i].bVerified)
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,131 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 16时05分12秒
+*   Modifed Time: 2026年10月19日 星期一 19时47分33秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "input_generator.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <random>
+
+static const char* s_szDistributionNames[DISTRIBUTION_COUNT] =
+{
+	"uniform", "sorted", "reversed", "organ-pipe", "sawtooth", "few-unique", "zipf", "nearly-sorted",
+};
+
+const char* DistributionName(Distribution eDist_)
+{
+	if (eDist_ < 0 || eDist_ >= DISTRIBUTION_COUNT)
+		return "unknown";
+	return s_szDistributionNames[eDist_];
+}
+
+bool ParseDistribution(const std::string& strName_, Distribution& eDist_)
+{
+	for (int i = 0; i < DISTRIBUTION_COUNT; ++i)
+	{
+		if (strName_ == s_szDistributionNames[i])
+		{
+			eDist_ = static_cast<Distribution>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+// 齐夫分布：第k个值出现的概率正比于1/k. 先计算出累积分布，再通过二分查找进行采样。
+// 不同值的个数最多取2^20个，足够表现出长尾的效果了。
+static void GenerateZipf(std::vector<int>& vecOut_, size_t nSize_, std::mt19937_64& engine_)
+{
+	size_t _nRanks = std::min<size_t>(std::max<size_t>(nSize_, 1), 1 << 20);
+	std::vector<double> _vecCdf(_nRanks);
+	double _dSum = 0.0;
+	for (size_t k = 0; k < _nRanks; ++k)
+	{
+		_dSum += 1.0 / static_cast<double>(k + 1);
+		_vecCdf[k] = _dSum;
+	}
+
+	std::uniform_real_distribution<double> _dist(0.0, _dSum);
+	for (size_t i = 0; i < nSize_; ++i)
+	{
+		size_t _nRank = std::lower_bound(_vecCdf.begin(), _vecCdf.end(), _dist(engine_)) - _vecCdf.begin();
+		vecOut_[i] = static_cast<int>(std::min(_nRank, _nRanks - 1));
+	}
+}
+
+void GenerateInput(std::vector<int>& vecOut_, size_t nSize_, Distribution eDist_,
+		unsigned long long nSeed_, int nPercent_)
+{
+	std::mt19937_64 _engine(nSeed_);
+	vecOut_.resize(nSize_);
+
+	switch (eDist_)
+	{
+	case UNIFORM:
+	{
+		std::uniform_int_distribution<int> _dist(0, INT_MAX);
+		for (size_t i = 0; i < nSize_; ++i)
+			vecOut_[i] = _dist(_engine);
+		break;
+	}
+	case SORTED:
+		for (size_t i = 0; i < nSize_; ++i)
+			vecOut_[i] = static_cast<int>(i);
+		break;
+	case REVERSED:
+		for (size_t i = 0; i < nSize_; ++i)
+			vecOut_[i] = static_cast<int>(nSize_ - 1 - i);
+		break;
+	case ORGAN_PIPE:
+		for (size_t i = 0; i < nSize_; ++i)
+			vecOut_[i] = static_cast<int>(std::min(i, nSize_ - 1 - i));
+		break;
+	case SAWTOOTH:
+	{
+		size_t _nTooth = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(nSize_))));
+		for (size_t i = 0; i < nSize_; ++i)
+			vecOut_[i] = static_cast<int>(i % _nTooth);
+		break;
+	}
+	case FEW_UNIQUE:
+	{
+		std::uniform_int_distribution<int> _dist(0, 15);
+		for (size_t i = 0; i < nSize_; ++i)
+			vecOut_[i] = _dist(_engine);
+		break;
+	}
+	case ZIPF:
+		GenerateZipf(vecOut_, nSize_, _engine);
+		break;
+	case NEARLY_SORTED:
+	{
+		for (size_t i = 0; i < nSize_; ++i)
+			vecOut_[i] = static_cast<int>(i);
+		if (nSize_ < 2)
+			break;
+
+		// 每次交换打乱两个元素，所以交换次数为 n * k% / 2
+		size_t _nSwaps = nSize_ * static_cast<size_t>(std::max(nPercent_, 0)) / 200;
+		std::uniform_int_distribution<size_t> _dist(0, nSize_ - 1);
+		for (size_t i = 0; i < _nSwaps; ++i)
+			std::swap(vecOut_[_dist(_engine)], vecOut_[_dist(_engine)]);
+		break;
+	}
+	default:
+		break;
+	}
+}
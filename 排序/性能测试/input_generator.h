@@ -0,0 +1,48 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 16时05分12秒
+*   Modifed Time: 2026年10月19日 星期一 19时47分33秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef INPUT_GENERATOR_H
+#define INPUT_GENERATOR_H
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 排序性能测试用的输入数据生成器。
+// 给定相同的种子，生成的数据完全相同，这样不同的版本之间才可以比较。生成的数据都是非负
+// 整数，以便计数排序也可以参与测试。
+enum Distribution
+{
+	UNIFORM,			// 在[0, INT_MAX]内均匀分布
+	SORTED,				// 已经从小到大有序
+	REVERSED,			// 从大到小有序
+	ORGAN_PIPE,			// 前半部分递增，后半部分递减: 0 1 2 ... 2 1 0
+	SAWTOOTH,			// 多个递增的锯齿, 每个锯齿长度为sqrt(n)
+	FEW_UNIQUE,			// 只有16个不同的值
+	ZIPF,				// 服从s=1的齐夫分布，少数几个值出现的次数非常多
+	NEARLY_SORTED,		// 有序的数组中随机交换了k%的元素
+	DISTRIBUTION_COUNT,
+};
+
+// 分布的名字, 用于命令行参数与输出结果
+const char* DistributionName(Distribution eDist_);
+bool ParseDistribution(const std::string& strName_, Distribution& eDist_);
+
+// 生成nSize_个数据放到vecOut_中, nPercent_只对NEARLY_SORTED有效，表示打乱的元素的百分比。
+void GenerateInput(std::vector<int>& vecOut_, size_t nSize_, Distribution eDist_,
+		unsigned long long nSeed_, int nPercent_);
+
+#endif	// INPUT_GENERATOR_H
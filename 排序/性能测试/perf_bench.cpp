@@ -0,0 +1,377 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 20时15分08秒
+*   Modifed Time: 2026年10月19日 星期一 22时41分26秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "perf_counter.h"
+#include "input_generator.h"
+#include "sort_entries.h"
+#include "../../数据结构/binary_search_tree.h"
+#include "../../图相关/vertex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// 使用硬件性能计数器分析排序算法以及二叉搜索树/图的遍历操作。
+// 对每一个被测量的操作，同时输出墙上时间与时钟周期数/指令数/IPC/L1数据缓存缺失/最后一级
+// 缓存缺失/分支预测失败/数据TLB缺失, 从而可以看出为什么一个算法比另一个算法慢，例如堆排序
+// 在大规模数据上的缓存缺失远多于快速排序。
+// 计数器不可用时(没有权限或者不是Linux系统)，对应的列输出n/a, 墙上时间照常输出。
+// 二叉搜索树与图的遍历函数分别来自7-二叉搜索树.cpp(使用-DBST_NO_MAIN编译)与图相关目录下的
+// BFS/DFS(使用-DGRAPH_NO_MAIN编译), 它们的声明在binary_search_tree.h与vertex.h中。
+//
+/*****************   测量与输出      ********************/
+struct Options
+{
+	size_t nSize = 1000000;			// 排序的数据规模
+	size_t nTreeSize = 1000000;		// 二叉搜索树的结点数
+	size_t nGraphSize = 50000;		// 图的顶点数, DFS是递归实现的，不宜过大
+	size_t nDegree = 8;				// 图中每个顶点的平均度数
+	size_t nQuadraticLimit = 20000;
+	Distribution eDist = UNIFORM;
+	unsigned long long nSeed = 20190511;
+	std::string strCsvFile;
+};
+
+struct Sample
+{
+	std::string strName;
+	size_t nSize;
+	double dMilliseconds;
+	bool bAvailable[PERF_EVENT_COUNT];
+	unsigned long long nValues[PERF_EVENT_COUNT];
+};
+
+// 包装一个被测量的区域：同时记录墙上时间与所有的性能计数器
+class Measurement
+{
+public:
+	Measurement(PerfCounters& counters_, Sample& sample_)
+		: m_counters(counters_), m_sample(sample_), m_start(std::chrono::steady_clock::now())
+	{
+		m_counters.Start();
+	}
+
+	~Measurement()
+	{
+		m_counters.Stop();
+		std::chrono::duration<double, std::milli> _elapsed = std::chrono::steady_clock::now() - m_start;
+		m_sample.dMilliseconds = _elapsed.count();
+		for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+		{
+			m_sample.bAvailable[i] = m_counters.Available(static_cast<PerfEvent>(i));
+			m_sample.nValues[i] = m_counters.Value(static_cast<PerfEvent>(i));
+		}
+	}
+
+private:
+	PerfCounters& m_counters;
+	Sample& m_sample;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+static void PrintSample(const Sample& sample_)
+{
+	std::cout.width(22);
+	std::cout << std::left << sample_.strName;
+	std::cout.width(10);
+	std::cout << sample_.nSize;
+	std::cout.width(12);
+	std::cout << sample_.dMilliseconds;
+
+	// 每个元素平均的计数值更便于比较不同规模的测试
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+		std::cout.width(14);
+		if (sample_.bAvailable[i])
+			std::cout << static_cast<double>(sample_.nValues[i]) / sample_.nSize;
+		else
+			std::cout << "n/a";
+	}
+
+	if (sample_.bAvailable[PERF_CYCLES] && sample_.bAvailable[PERF_INSTRUCTIONS] && sample_.nValues[PERF_CYCLES] > 0)
+		std::cout << static_cast<double>(sample_.nValues[PERF_INSTRUCTIONS]) / sample_.nValues[PERF_CYCLES];
+	else
+		std::cout << "n/a";
+	std::cout << std::endl;
+}
+
+static void WriteCsv(const std::string& strFile_, const std::vector<Sample>& vecSamples_)
+{
+	std::ofstream _file(strFile_.c_str());
+	_file << "region,size,wall_ms";
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+		_file << ',' << PerfCounters::Name(static_cast<PerfEvent>(i));
+	_file << '\n';
+
+	// 不可用的计数器输出为空
+	for (size_t s = 0; s < vecSamples_.size(); ++s)
+	{
+		const Sample& _sample = vecSamples_[s];
+		_file << _sample.strName << ',' << _sample.nSize << ',' << _sample.dMilliseconds;
+		for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+		{
+			_file << ',';
+			if (_sample.bAvailable[i])
+				_file << _sample.nValues[i];
+		}
+		_file << '\n';
+	}
+}
+
+/*****************   被测量的操作      ********************/
+static void RunSorts(PerfCounters& counters_, const Options& options_, std::vector<Sample>& vecSamples_)
+{
+	std::vector<int> _vecInput;
+	std::vector<int> _vecWork;
+	GenerateInput(_vecInput, options_.nSize, options_.eDist, options_.nSeed, 1);
+	for (size_t s = 0; s < g_nSortCount; ++s)
+	{
+		const SortEntry& _entry = g_sortEntries[s];
+		if (IsQuadratic(_entry, options_.eDist == UNIFORM) && options_.nSize > options_.nQuadraticLimit)
+			continue;
+		if (_entry.bSmallKeysOnly && options_.eDist == UNIFORM)
+			continue;
+
+		_vecWork = _vecInput;
+		Sample _sample = Sample();
+		_sample.strName = _entry.szName;
+		_sample.nSize = _vecWork.size();
+		{
+			Measurement _measure(counters_, _sample);
+			_entry.pSort(_vecWork.data(), _vecWork.size());
+		}
+		vecSamples_.push_back(_sample);
+		PrintSample(_sample);
+	}
+}
+
+static long long s_nVisitSum = 0;		// 遍历时的回调函数对结点的值求和，防止遍历被优化掉
+
+static void VisitTreeNode(Node* pNode_)
+{
+	s_nVisitSum += pNode_->m_nValue;
+}
+
+static void VisitVertex(vertex* pVertex_)
+{
+	s_nVisitSum += pVertex_->m_nValue;
+}
+
+static void DeleteTree(Node* pRoot_)
+{
+	if (pRoot_ == nullptr)
+		return;
+	DeleteTree(pRoot_->m_pLeft);
+	DeleteTree(pRoot_->m_pRight);
+	delete pRoot_;
+}
+
+// 二叉搜索树使用随机的键值，避免退化为链表
+static void RunTree(PerfCounters& counters_, const Options& options_, std::vector<Sample>& vecSamples_)
+{
+	std::vector<int> _vecKeys;
+	GenerateInput(_vecKeys, options_.nTreeSize, UNIFORM, options_.nSeed, 0);
+
+	Node* _pRoot = nullptr;
+	Sample _insert = Sample();
+	_insert.strName = "BST Insert";
+	_insert.nSize = _vecKeys.size();
+	{
+		Measurement _measure(counters_, _insert);
+		for (size_t i = 0; i < _vecKeys.size(); ++i)
+			Insert(_pRoot, _vecKeys[i]);
+	}
+	vecSamples_.push_back(_insert);
+	PrintSample(_insert);
+
+	// 按照与插入不同的顺序查找
+	std::shuffle(_vecKeys.begin(), _vecKeys.end(), std::mt19937_64(options_.nSeed + 1));
+	Sample _search = Sample();
+	_search.strName = "BST Search";
+	_search.nSize = _vecKeys.size();
+	{
+		Measurement _measure(counters_, _search);
+		for (size_t i = 0; i < _vecKeys.size(); ++i)
+		{
+			if (Search(_pRoot, _vecKeys[i]) != nullptr)
+				++s_nVisitSum;
+		}
+	}
+	vecSamples_.push_back(_search);
+	PrintSample(_search);
+
+	Sample _inorder = Sample();
+	_inorder.strName = "BST Inorder";
+	_inorder.nSize = _vecKeys.size();
+	{
+		Measurement _measure(counters_, _inorder);
+		InorderTraversal_ByRecursion(_pRoot, VisitTreeNode);
+	}
+	vecSamples_.push_back(_inorder);
+	PrintSample(_inorder);
+
+	DeleteTree(_pRoot);
+}
+
+// 随机生成一个连通的无向图：先把所有顶点随机连成一条链保证连通，再随机添加边
+static void BuildGraph(std::vector<vertex>& vecGraph_, const Options& options_)
+{
+	size_t _nVertices = options_.nGraphSize;
+	vecGraph_.assign(_nVertices, vertex());
+	std::vector<size_t> _vecOrder(_nVertices);
+	for (size_t i = 0; i < _nVertices; ++i)
+	{
+		vecGraph_[i].m_nValue = static_cast<int>(i);
+		vecGraph_[i].m_bSearched = false;
+		_vecOrder[i] = i;
+	}
+
+	std::mt19937_64 _engine(options_.nSeed);
+	std::shuffle(_vecOrder.begin(), _vecOrder.end(), _engine);
+	for (size_t i = 1; i < _nVertices; ++i)
+	{
+		vecGraph_[_vecOrder[i - 1]].m_listAdjacent.push_back(&vecGraph_[_vecOrder[i]]);
+		vecGraph_[_vecOrder[i]].m_listAdjacent.push_back(&vecGraph_[_vecOrder[i - 1]]);
+	}
+
+	std::uniform_int_distribution<size_t> _dist(0, _nVertices - 1);
+	size_t _nEdges = _nVertices * options_.nDegree / 2;
+	for (size_t i = _nVertices - 1; i < _nEdges; ++i)
+	{
+		size_t _nFrom = _dist(_engine);
+		size_t _nTo = _dist(_engine);
+		vecGraph_[_nFrom].m_listAdjacent.push_back(&vecGraph_[_nTo]);
+		vecGraph_[_nTo].m_listAdjacent.push_back(&vecGraph_[_nFrom]);
+	}
+}
+
+static void ResetGraph(std::vector<vertex>& vecGraph_)
+{
+	for (size_t i = 0; i < vecGraph_.size(); ++i)
+		vecGraph_[i].m_bSearched = false;
+}
+
+static void RunGraph(PerfCounters& counters_, const Options& options_, std::vector<Sample>& vecSamples_)
+{
+	if (options_.nGraphSize == 0)
+		return;
+
+	std::vector<vertex> _vecGraph;
+	BuildGraph(_vecGraph, options_);
+
+	Sample _bfs = Sample();
+	_bfs.strName = "Graph BFS";
+	_bfs.nSize = _vecGraph.size();
+	{
+		Measurement _measure(counters_, _bfs);
+		BreadthFirstSearch(&_vecGraph[0], VisitVertex);
+	}
+	vecSamples_.push_back(_bfs);
+	PrintSample(_bfs);
+
+	ResetGraph(_vecGraph);
+	Sample _dfs = Sample();
+	_dfs.strName = "Graph DFS";
+	_dfs.nSize = _vecGraph.size();
+	{
+		Measurement _measure(counters_, _dfs);
+		DepthFirstSearch(&_vecGraph[0], VisitVertex);
+	}
+	vecSamples_.push_back(_dfs);
+	PrintSample(_dfs);
+}
+
+static void PrintUsage(const char* szProgram_)
+{
+	std::cout << "用法：" << szProgram_ << " [选项]" << std::endl
+		<< "  --size N              排序的数据规模，默认为10^6" << std::endl
+		<< "  --dist NAME           排序数据的分布，默认为uniform" << std::endl
+		<< "  --tree-size N         二叉搜索树的结点数，默认为10^6" << std::endl
+		<< "  --graph-size N        图的顶点数，默认为50000" << std::endl
+		<< "  --degree N            图中顶点的平均度数，默认为8" << std::endl
+		<< "  --quadratic-limit N   O(N*N)的情况下最大的数据规模，默认为20000" << std::endl
+		<< "  --seed S              随机数种子" << std::endl
+		<< "  --csv FILE            把结果保存为CSV文件" << std::endl;
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& options_)
+{
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		std::string _strArg = argv[i];
+		std::string _strValue = argv[i + 1];
+		if (_strArg == "--size")
+			options_.nSize = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--tree-size")
+			options_.nTreeSize = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--graph-size")
+			options_.nGraphSize = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--degree")
+			options_.nDegree = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--quadratic-limit")
+			options_.nQuadraticLimit = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--seed")
+			options_.nSeed = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--csv")
+			options_.strCsvFile = _strValue;
+		else if (_strArg == "--dist")
+		{
+			if (!ParseDistribution(_strValue, options_.eDist))
+				return false;
+		}
+		else
+			return false;
+	}
+	return argc % 2 == 1 && options_.nSize > 0;
+}
+
+int main(int argc, char* argv[])
+{
+	Options _options;
+	if (!ParseOptions(argc, argv, _options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	PerfCounters _counters;
+	if (!_counters.AnyAvailable())
+		std::cout << "硬件性能计数器不可用(没有权限或者不支持), 只输出墙上时间。" << std::endl;
+
+	std::cout << "region                size      wall(ms)    ";
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+		std::cout.width(14);
+		std::cout << std::left << PerfCounters::Name(static_cast<PerfEvent>(i));
+	}
+	std::cout << "IPC" << std::endl;
+	std::cout << "(计数器的值为平均每个元素的次数)" << std::endl;
+
+	std::vector<Sample> _vecSamples;
+	RunSorts(_counters, _options, _vecSamples);
+	RunTree(_counters, _options, _vecSamples);
+	RunGraph(_counters, _options, _vecSamples);
+
+	if (!_options.strCsvFile.empty())
+		WriteCsv(_options.strCsvFile, _vecSamples);
+	std::cout << "遍历的校验和：" << s_nVisitSum << std::endl;
+	return 0;
+}
@@ -0,0 +1,179 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 20时15分08秒
+*   Modifed Time: 2026年10月19日 星期一 22时41分26秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "perf_counter.h"
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// 每个计数器对应的perf_event_attr的type与config
+static void GetEventConfig(PerfEvent eEvent_, unsigned int& nType_, unsigned long long& nConfig_)
+{
+	switch (eEvent_)
+	{
+	case PERF_CYCLES:
+		nType_ = PERF_TYPE_HARDWARE;
+		nConfig_ = PERF_COUNT_HW_CPU_CYCLES;
+		break;
+	case PERF_INSTRUCTIONS:
+		nType_ = PERF_TYPE_HARDWARE;
+		nConfig_ = PERF_COUNT_HW_INSTRUCTIONS;
+		break;
+	case PERF_L1D_MISSES:
+		nType_ = PERF_TYPE_HW_CACHE;
+		nConfig_ = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	case PERF_LLC_MISSES:
+		nType_ = PERF_TYPE_HARDWARE;
+		nConfig_ = PERF_COUNT_HW_CACHE_MISSES;
+		break;
+	case PERF_BRANCH_MISSES:
+		nType_ = PERF_TYPE_HARDWARE;
+		nConfig_ = PERF_COUNT_HW_BRANCH_MISSES;
+		break;
+	case PERF_DTLB_MISSES:
+	default:
+		nType_ = PERF_TYPE_HW_CACHE;
+		nConfig_ = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			(PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		break;
+	}
+}
+
+static int OpenEvent(PerfEvent eEvent_)
+{
+	struct perf_event_attr _attr;
+	memset(&_attr, 0, sizeof(_attr));
+	_attr.size = sizeof(_attr);
+	GetEventConfig(eEvent_, _attr.type, _attr.config);
+	_attr.disabled = 1;
+	_attr.exclude_kernel = 1;		// 只统计用户态，这样普通用户也有权限
+	_attr.exclude_hv = 1;
+	_attr.inherit = 1;				// 计数器打开之后创建的线程(例如并行排序的工作线程)也统计在内
+	_attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	// 统计当前进程在任意CPU上的事件
+	return static_cast<int>(syscall(__NR_perf_event_open, &_attr, 0, -1, -1, 0));
+}
+#endif	// __linux__
+
+PerfCounters::PerfCounters()
+{
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+#ifdef __linux__
+		m_fds[i] = OpenEvent(static_cast<PerfEvent>(i));
+#else
+		m_fds[i] = -1;
+#endif
+		m_values[i] = 0;
+	}
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+		if (m_fds[i] >= 0)
+			close(m_fds[i]);
+	}
+#endif
+}
+
+void PerfCounters::Start()
+{
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+		m_values[i] = 0;
+#ifdef __linux__
+		if (m_fds[i] >= 0)
+		{
+			ioctl(m_fds[i], PERF_EVENT_IOC_RESET, 0);
+			ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+}
+
+void PerfCounters::Stop()
+{
+#ifdef __linux__
+	// 先全部停止再读取，尽量减少读取过程本身被统计进去
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+		if (m_fds[i] >= 0)
+			ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+	}
+
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+		if (m_fds[i] < 0)
+			continue;
+
+		// 读取的格式为：计数值/计数器启用的时间/计数器实际运行的时间
+		unsigned long long _data[3] = {0, 0, 0};
+		if (read(m_fds[i], _data, sizeof(_data)) != static_cast<ssize_t>(sizeof(_data)))
+			continue;
+
+		if (_data[2] == 0)
+			m_values[i] = 0;
+		else if (_data[2] < _data[1])
+			m_values[i] = static_cast<unsigned long long>(static_cast<double>(_data[0]) * _data[1] / _data[2]);
+		else
+			m_values[i] = _data[0];
+	}
+#endif
+}
+
+bool PerfCounters::Available(PerfEvent eEvent_) const
+{
+	return eEvent_ >= 0 && eEvent_ < PERF_EVENT_COUNT && m_fds[eEvent_] >= 0;
+}
+
+bool PerfCounters::AnyAvailable() const
+{
+	for (int i = 0; i < PERF_EVENT_COUNT; ++i)
+	{
+		if (m_fds[i] >= 0)
+			return true;
+	}
+	return false;
+}
+
+unsigned long long PerfCounters::Value(PerfEvent eEvent_) const
+{
+	if (!Available(eEvent_))
+		return 0;
+	return m_values[eEvent_];
+}
+
+const char* PerfCounters::Name(PerfEvent eEvent_)
+{
+	static const char* s_szNames[PERF_EVENT_COUNT] =
+	{
+		"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "dtlb_misses",
+	};
+	if (eEvent_ < 0 || eEvent_ >= PERF_EVENT_COUNT)
+		return "unknown";
+	return s_szNames[eEvent_];
+}
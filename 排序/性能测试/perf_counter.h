@@ -0,0 +1,82 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 20时15分08秒
+*   Modifed Time: 2026年10月19日 星期一 22时41分26秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef PERF_COUNTER_H
+#define PERF_COUNTER_H
+
+// 基于Linux的perf_event_open()系统调用读取CPU的硬件性能计数器，用来分析程序慢在哪里：
+// 时钟周期数/指令数/L1数据缓存缺失/最后一级缓存缺失/分支预测失败/数据TLB缺失。
+//
+// 说明：
+// 1. 每一个计数器单独打开，某个计数器不可用时(例如CPU不支持, 虚拟机或容器中没有权限,
+// /proc/sys/kernel/perf_event_paranoid的值太大)不影响其它计数器, 不可用的计数器的值无效。
+// 2. 非Linux系统上所有的计数器都不可用，程序仍然可以正常运行。
+// 3. 计数器的数目多于CPU的硬件计数器时，内核会分时复用, 读取的值会按照实际计数的时间
+// 比例进行放大。
+// 4. 计数器会被之后创建的线程继承，并行排序的工作线程中的事件也统计在内, 线程退出后它的计数
+// 值合并到读取的结果中。所以测量期间其它无关线程中的事件也会被算进去。
+//
+// 使用方法：
+//     PerfCounters _counters;
+//     _counters.Start();
+//     ......       // 被测量的代码
+//     _counters.Stop();
+//     _counters.Value(PERF_CYCLES);
+//
+enum PerfEvent
+{
+	PERF_CYCLES,			// 时钟周期数
+	PERF_INSTRUCTIONS,		// 执行的指令数
+	PERF_L1D_MISSES,		// L1数据缓存读缺失次数
+	PERF_LLC_MISSES,		// 最后一级缓存缺失次数
+	PERF_BRANCH_MISSES,		// 分支预测失败次数
+	PERF_DTLB_MISSES,		// 数据TLB读缺失次数
+	PERF_EVENT_COUNT,
+};
+
+class PerfCounters
+{
+public:
+	PerfCounters();
+	~PerfCounters();
+	void Start();							// 清零并开始计数
+	void Stop();							// 停止计数并读取计数值
+	bool Available(PerfEvent eEvent_) const;	// 该计数器是否可用
+	bool AnyAvailable() const;				// 是否至少有一个计数器可用
+	unsigned long long Value(PerfEvent eEvent_) const;
+	static const char* Name(PerfEvent eEvent_);
+
+private:
+	PerfCounters(const PerfCounters&);
+	PerfCounters& operator=(const PerfCounters&);
+
+	int m_fds[PERF_EVENT_COUNT];				// 每个计数器的文件描述符，-1表示不可用
+	unsigned long long m_values[PERF_EVENT_COUNT];
+};
+
+// 在构造与析构时分别开始与停止计数，用于测量一个作用域。
+class PerfScope
+{
+public:
+	explicit PerfScope(PerfCounters& counters_) : m_counters(counters_) { m_counters.Start(); }
+	~PerfScope() { m_counters.Stop(); }
+
+private:
+	PerfCounters& m_counters;
+};
+
+#endif	// PERF_COUNTER_H
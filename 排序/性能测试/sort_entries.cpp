@@ -0,0 +1,107 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 20时15分08秒
+*   Modifed Time: 2026年10月19日 星期一 22时41分26秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "sort_entries.h"
+#include "../sort.h"
+#include <algorithm>
+
+static bool Less(int lhs, int rhs)
+{
+	return lhs < rhs;
+}
+
+static bool Greater(int lhs, int rhs)
+{
+	return lhs > rhs;
+}
+
+/*******************    被测试的排序算法        *****************/
+static void RunInsertionSort(int array[], size_t nLength_)
+{
+	insertion_sort(array, nLength_);
+}
+
+static void RunMergeSort(int array[], size_t nLength_)
+{
+	MergeSort(array, 0, static_cast<int>(nLength_), Less);
+}
+
+// 堆排序通过建立最大堆来实现从小到大排序，所以传入大于比较函数
+static void RunHeapSort(int array[], size_t nLength_)
+{
+	HeapSort(array, static_cast<int>(nLength_), Greater);
+}
+
+static void RunBubbleSortLoop(int array[], size_t nLength_)
+{
+	BubbleSort_Loop(array, static_cast<int>(nLength_), Less);
+}
+
+static void RunBubbleSortRecursion(int array[], size_t nLength_)
+{
+	BubbleSort_Recursion(array, static_cast<int>(nLength_), Less);
+}
+
+// 数据无关的奇偶换位排序, 使用所有的CPU核
+static void RunOddEvenTranspositionSort(int array[], size_t nLength_)
+{
+	OddEvenTranspositionSort(array, static_cast<int>(nLength_), true, 0);
+}
+
+static void RunQuickSort(int array[], size_t nLength_)
+{
+	QuickSort(array, static_cast<int>(nLength_), Less);
+}
+
+static void RunQuickSortVersion2(int array[], size_t nLength_)
+{
+	QuickSort_Version2(array, 0, static_cast<int>(nLength_), Less);
+}
+
+// 计数排序需要知道最大值，求最大值的时间也算在排序时间里。
+static void RunCountingSort(int array[], size_t nLength_)
+{
+	if (nLength_ == 0)
+		return;
+	CountingSort(array, static_cast<int>(nLength_), *std::max_element(array, array + nLength_));
+}
+
+// 作为参照的标准库排序
+static void RunStdSort(int array[], size_t nLength_)
+{
+	std::sort(array, array + nLength_);
+}
+
+const SortEntry g_sortEntries[] =
+{
+	{"insertion_sort", RunInsertionSort, QUADRATIC, false},
+	{"MergeSort", RunMergeSort, LINEARITHMIC, false},
+	{"HeapSort", RunHeapSort, LINEARITHMIC, false},
+	{"BubbleSort_Loop", RunBubbleSortLoop, QUADRATIC, false},
+	{"BubbleSort_Recursion", RunBubbleSortRecursion, QUADRATIC, false},
+	{"OddEvenTranspositionSort", RunOddEvenTranspositionSort, QUADRATIC, false},
+	{"QuickSort", RunQuickSort, QUADRATIC_UNLESS_RANDOM, false},
+	{"QuickSort_Version2", RunQuickSortVersion2, QUADRATIC_UNLESS_RANDOM, false},
+	{"CountingSort", RunCountingSort, LINEARITHMIC, true},
+	{"std::sort", RunStdSort, LINEARITHMIC, false},
+};
+const size_t g_nSortCount = sizeof(g_sortEntries) / sizeof(g_sortEntries[0]);
+
+bool IsQuadratic(const SortEntry& entry_, bool bRandom_)
+{
+	return entry_.eComplexity == QUADRATIC || (entry_.eComplexity == QUADRATIC_UNLESS_RANDOM && !bRandom_);
+}
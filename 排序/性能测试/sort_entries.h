@@ -0,0 +1,45 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 20时15分08秒
+*   Modifed Time: 2026年10月19日 星期一 22时41分26秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef SORT_ENTRIES_H
+#define SORT_ENTRIES_H
+#include <cstddef>
+
+// 性能测试中用到的所有排序算法。每一个算法都包装成统一的形式：对array中的nLength_个元
+// 素从小到大排序。
+enum Complexity
+{
+	LINEARITHMIC,			// O(NlogN)或者更快
+	QUADRATIC,				// O(N*N)
+	QUADRATIC_UNLESS_RANDOM,	// 只有均匀分布的随机数据上为O(NlogN), 其它为O(N*N)
+};
+
+struct SortEntry
+{
+	const char* szName;
+	void (*pSort)(int[], size_t);
+	Complexity eComplexity;
+	bool bSmallKeysOnly;	// 只适用于取值范围较小的非负整数(计数排序)
+};
+
+extern const SortEntry g_sortEntries[];
+extern const size_t g_nSortCount;
+
+// 判断该算法在给定的规模下是否会退化为O(N*N), bRandom_表示数据是否为均匀分布的随机数
+bool IsQuadratic(const SortEntry& entry_, bool bRandom_);
+
+#endif	// SORT_ENTRIES_H
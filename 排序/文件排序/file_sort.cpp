@@ -0,0 +1,227 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 09时21分44秒
+*   Modifed Time: 2026年10月20日 星期二 11时03分18秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "mmap_sort.h"
+#include "../性能测试/input_generator.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// 二进制键文件的原地排序程序。
+//     file_sort [选项] 文件
+// 文件中的每个键是一个4字节的int(本机字节序). 使用--generate可以先生成一个测试文件，使用
+// --check可以在排序之后检查文件是否有序。
+//
+/*******************    命令行参数        *****************/
+struct Options
+{
+	MmapSortOptions sortOptions;
+	size_t nGenerate = 0;					// 大于0时先生成一个包含这么多个键的文件
+	Distribution eDist = UNIFORM;
+	unsigned long long nSeed = 20190511;
+	bool bCheck = false;
+	std::string strPath;
+};
+
+static void PrintUsage(const char* szProgram_)
+{
+	std::cout << "用法：" << szProgram_ << " [选项] 文件" << std::endl
+		<< "  --generate N          先生成一个包含N个键的文件(覆盖原文件)" << std::endl
+		<< "  --dist NAME           生成文件时的数据分布，默认为uniform" << std::endl
+		<< "  --seed S              生成文件时的随机数种子" << std::endl
+		<< "  --chunk-mb N          分块的大小，默认为32MB" << std::endl
+		<< "  --leaf NAME           分块的排序算法: merge或quick, 默认为merge" << std::endl
+		<< "  --populate MODE       MAP_POPULATE预读: auto/yes/no, 默认为auto" << std::endl
+		<< "  --no-hugepage         不使用MADV_HUGEPAGE提示" << std::endl
+		<< "  --no-sync             排序完成后不等待数据写回磁盘" << std::endl
+		<< "  --check               排序完成后检查文件是否有序" << std::endl;
+}
+
+static bool ParseOptions(int argc, char* argv[], Options& options_)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string _strArg = argv[i];
+		if (_strArg == "--help" || _strArg == "-h")
+			return false;
+		if (_strArg == "--no-hugepage")
+		{
+			options_.sortOptions.bHugePages = false;
+			continue;
+		}
+		if (_strArg == "--no-sync")
+		{
+			options_.sortOptions.bSync = false;
+			continue;
+		}
+		if (_strArg == "--check")
+		{
+			options_.bCheck = true;
+			continue;
+		}
+		if (_strArg.compare(0, 2, "--") != 0)
+		{
+			options_.strPath = _strArg;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			std::cerr << "参数" << _strArg << "缺少取值" << std::endl;
+			return false;
+		}
+
+		std::string _strValue = argv[++i];
+		if (_strArg == "--generate")
+			options_.nGenerate = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--seed")
+			options_.nSeed = std::strtoull(_strValue.c_str(), nullptr, 10);
+		else if (_strArg == "--chunk-mb")
+			options_.sortOptions.nChunkBytes = std::strtoull(_strValue.c_str(), nullptr, 10) << 20;
+		else if (_strArg == "--dist")
+		{
+			if (!ParseDistribution(_strValue, options_.eDist))
+			{
+				std::cerr << "未知的数据分布：" << _strValue << std::endl;
+				return false;
+			}
+		}
+		else if (_strArg == "--leaf" && (_strValue == "merge" || _strValue == "quick"))
+			options_.sortOptions.eLeafSort = _strValue == "merge" ? MMAP_LEAF_MERGE_SORT : MMAP_LEAF_QUICK_SORT;
+		else if (_strArg == "--populate" && (_strValue == "auto" || _strValue == "yes" || _strValue == "no"))
+			options_.sortOptions.nPopulate = _strValue == "auto" ? -1 : (_strValue == "yes" ? 1 : 0);
+		else
+		{
+			std::cerr << "未知的参数：" << _strArg << " " << _strValue << std::endl;
+			return false;
+		}
+	}
+
+	if (options_.strPath.empty())
+	{
+		std::cerr << "缺少文件名" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// 分批生成数据写入文件，每批的种子不同，这样生成大文件时不需要把所有的数据放在内存中。
+static bool GenerateFile(const Options& options_)
+{
+	FILE* _pFile = fopen(options_.strPath.c_str(), "wb");
+	if (_pFile == nullptr)
+	{
+		std::cerr << "无法创建文件" << options_.strPath << std::endl;
+		return false;
+	}
+
+	const size_t _nBatch = 1 << 24;
+	std::vector<int> _vecKeys;
+	bool _bOk = true;
+	for (size_t _nDone = 0; _nDone < options_.nGenerate && _bOk; _nDone += _nBatch)
+	{
+		size_t _nCount = std::min(_nBatch, options_.nGenerate - _nDone);
+		GenerateInput(_vecKeys, _nCount, options_.eDist, options_.nSeed + _nDone / _nBatch, 1);
+		_bOk = fwrite(_vecKeys.data(), sizeof(int), _nCount, _pFile) == _nCount;
+	}
+	if (fclose(_pFile) != 0 || !_bOk)
+	{
+		std::cerr << "写入文件" << options_.strPath << "失败" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static bool CheckFile(const std::string& strPath_)
+{
+	int _nFd = open(strPath_.c_str(), O_RDONLY);
+	struct stat _fileStat;
+	if (_nFd < 0 || fstat(_nFd, &_fileStat) != 0)
+		return false;
+
+	bool _bSorted = true;
+	size_t _nBytes = _fileStat.st_size;
+	if (_nBytes >= sizeof(int))
+	{
+		void* _pMapped = mmap(nullptr, _nBytes, PROT_READ, MAP_SHARED, _nFd, 0);
+		if (_pMapped == MAP_FAILED)
+		{
+			close(_nFd);
+			return false;
+		}
+		madvise(_pMapped, _nBytes, MADV_SEQUENTIAL);
+		const int* _pKeys = static_cast<const int*>(_pMapped);
+		_bSorted = std::is_sorted(_pKeys, _pKeys + _nBytes / sizeof(int));
+		munmap(_pMapped, _nBytes);
+	}
+	close(_nFd);
+	return _bSorted;
+}
+
+static void PrintPhase(const char* szName_, double dSeconds_, double dBytes_)
+{
+	std::cout << "  " << szName_ << std::setw(10) << dSeconds_ << "秒";
+	if (dSeconds_ > 0 && dBytes_ > 0)
+		std::cout << std::setw(12) << dBytes_ / dSeconds_ / (1 << 20) << " MB/s";
+	std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	Options _options;
+	if (!ParseOptions(argc, argv, _options))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+	if (_options.nGenerate > 0 && !GenerateFile(_options))
+		return 1;
+
+	MmapSortStats _stats;
+	if (!MmapSortFile(_options.strPath.c_str(), _options.sortOptions, &_stats))
+		return 1;
+
+	double _dBytes = static_cast<double>(_stats.nKeys) * sizeof(int);
+	double _dTotal = _stats.dMapSeconds + _stats.dPartitionSeconds + _stats.dChunkSortSeconds + _stats.dSyncSeconds;
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << _options.strPath << "：" << _stats.nKeys << "个键(" << _dBytes / (1 << 20) << "MB), "
+		<< _stats.nChunks << "个分块(其中" << _stats.nSortedChunks << "个已经有序), "
+		<< (_stats.bPopulated ? "使用" : "没有使用") << "MAP_POPULATE" << std::endl;
+	PrintPhase("映射文件", _stats.dMapSeconds, _dBytes);
+	PrintPhase("划分    ", _stats.dPartitionSeconds, static_cast<double>(_stats.nPartitionBytes));
+	PrintPhase("分块排序", _stats.dChunkSortSeconds, _dBytes);
+	PrintPhase("写回磁盘", _stats.dSyncSeconds, _dBytes);
+	PrintPhase("总计    ", _dTotal, _dBytes);
+	if (_dBytes > 0)
+		std::cout << "  划分阶段扫描了" << _stats.nPartitionBytes / _dBytes << "遍数据" << std::endl;
+
+	if (_options.bCheck)
+	{
+		bool _bSorted = CheckFile(_options.strPath);
+		std::cout << "排序结果" << (_bSorted ? "正确" : "错误") << std::endl;
+		if (!_bSorted)
+			return 1;
+	}
+	return 0;
+}
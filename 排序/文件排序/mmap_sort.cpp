@@ -0,0 +1,314 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 09时21分44秒
+*   Modifed Time: 2026年10月20日 星期二 11时03分18秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "mmap_sort.h"
+#include "../sort.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+static bool Less(int lhs, int rhs)
+{
+	return lhs < rhs;
+}
+
+static double SecondsSince(std::chrono::steady_clock::time_point start_)
+{
+	std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - start_;
+	return _elapsed.count();
+}
+
+// 对[pBegin_, pBegin_ + nBytes_)所在的页给出访问提示，madvise()要求起始地址按页对齐。
+static void Advise(void* pBegin_, size_t nBytes_, int nAdvice_)
+{
+	static const size_t s_nPageSize = sysconf(_SC_PAGESIZE);
+	char* _pBegin = static_cast<char*>(pBegin_);
+	char* _pAligned = reinterpret_cast<char*>(reinterpret_cast<size_t>(_pBegin) & ~(s_nPageSize - 1));
+	madvise(_pAligned, nBytes_ + (_pBegin - _pAligned), nAdvice_);
+}
+
+// 把[nStart_, nEnd_)划分为两部分，返回第二部分的起始下标。
+// bInclusive_为false时第一部分为小于nPivot_的键，为true时第一部分为小于等于nPivot_的键。
+// 与Partition_Version2相同，两个下标都从前向后移动，对内存的访问是顺序的。
+static size_t PartitionByValue(int array[], size_t nStart_, size_t nEnd_, int nPivot_, bool bInclusive_)
+{
+	size_t _nBound = nStart_;
+	for (size_t i = nStart_; i < nEnd_; ++i)
+	{
+		int _nValue = array[i];
+		if (_nValue < nPivot_ || (bInclusive_ && _nValue == nPivot_))
+		{
+			array[i] = array[_nBound];
+			array[_nBound] = _nValue;
+			++_nBound;
+		}
+	}
+	return _nBound;
+}
+
+// 为[nStart_, nEnd_)选择划分值，区间内所有的键都相等时返回false.
+// 划分值总是可以保证划分后的两部分都不为空。
+static bool ChoosePivot(int array[], size_t nStart_, size_t nEnd_, int& nPivot_, bool& bInclusive_)
+{
+	const size_t _nSamples = 31;
+	int _samples[_nSamples];
+	size_t _nLength = nEnd_ - nStart_;
+	for (size_t i = 0; i < _nSamples; ++i)
+		_samples[i] = array[nStart_ + (2 * i + 1) * _nLength / (2 * _nSamples)];
+	insertion_sort(_samples, _nSamples);
+
+	int _nMin = _samples[0];
+	int _nMax = _samples[_nSamples - 1];
+	if (_nMin == _nMax)
+	{
+		// 样本全部相等时扫描整个区间，区间内有不同的键时用最小值与最大值的中间值划分
+		for (size_t i = nStart_; i < nEnd_; ++i)
+		{
+			_nMin = std::min(_nMin, array[i]);
+			_nMax = std::max(_nMax, array[i]);
+		}
+		if (_nMin == _nMax)
+			return false;
+		nPivot_ = static_cast<int>(_nMin + (static_cast<long long>(_nMax) - _nMin) / 2);
+		bInclusive_ = true;
+		return true;
+	}
+
+	// 中位数小于样本的最大值时使用小于等于，中位数本身在第一部分，最大值在第二部分；
+	// 否则使用小于，最小值在第一部分，中位数在第二部分。
+	nPivot_ = _samples[_nSamples / 2];
+	bInclusive_ = nPivot_ < _nMax;
+	return true;
+}
+
+static int MedianOfThree(int a, int b, int c)
+{
+	return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// 分块内的快速排序，使用三路划分：区间划分为小于、等于、大于划分值的三部分，等于划分值的键
+// 已经在最终的位置上，不再参与后面的排序，所以大量重复的键时也不会退化为O(N^2).
+// 1. 划分值取均匀分布的9个键的中位数的中位数，有序、逆序的区间也能均匀地划分。
+// 2. 较短的部分递归处理，较长的部分在循环中继续处理，递归深度不超过logN.
+// 3. 划分的次数超过2logN时说明划分值一直选得不好，剩下的区间改用MergeSort, 最坏也是O(NlogN).
+// 4. 区间较短时直接使用插入排序。
+static void QuickSortChunk(int array[], size_t nStart_, size_t nEnd_, int nDepthLimit_)
+{
+	const size_t _nInsertionSortLength = 16;
+	while (nEnd_ - nStart_ > _nInsertionSortLength)
+	{
+		if (nDepthLimit_-- == 0)
+		{
+			MergeSort(array + nStart_, 0, static_cast<int>(nEnd_ - nStart_), Less);
+			return;
+		}
+
+		size_t _nStep = (nEnd_ - nStart_) / 9;
+		const int* _pSample = array + nStart_ + _nStep / 2;
+		int _nPivot = MedianOfThree(
+				MedianOfThree(_pSample[0], _pSample[_nStep], _pSample[2 * _nStep]),
+				MedianOfThree(_pSample[3 * _nStep], _pSample[4 * _nStep], _pSample[5 * _nStep]),
+				MedianOfThree(_pSample[6 * _nStep], _pSample[7 * _nStep], _pSample[8 * _nStep]));
+
+		// [nStart_, _nLess)小于划分值，[_nLess, i)等于划分值，[_nGreater, nEnd_)大于划分值
+		size_t _nLess = nStart_;
+		size_t _nGreater = nEnd_;
+		size_t i = nStart_;
+		while (i < _nGreater)
+		{
+			if (array[i] < _nPivot)
+				std::swap(array[_nLess++], array[i++]);
+			else if (_nPivot < array[i])
+				std::swap(array[i], array[--_nGreater]);
+			else
+				++i;
+		}
+
+		if (_nLess - nStart_ < nEnd_ - _nGreater)
+		{
+			QuickSortChunk(array, nStart_, _nLess, nDepthLimit_);
+			nStart_ = _nGreater;
+		}
+		else
+		{
+			QuickSortChunk(array, _nGreater, nEnd_, nDepthLimit_);
+			nEnd_ = _nLess;
+		}
+	}
+	insertion_sort(array + nStart_, nEnd_ - nStart_);
+}
+
+// 对一个分块排序，已经有序的分块直接跳过。
+static void SortChunk(int array[], size_t nStart_, size_t nEnd_, const MmapSortOptions& options_,
+		MmapSortStats& stats_)
+{
+	++stats_.nChunks;
+	if (std::is_sorted(array + nStart_, array + nEnd_))
+	{
+		++stats_.nSortedChunks;
+		return;
+	}
+
+	if (options_.eLeafSort == MMAP_LEAF_MERGE_SORT)
+		MergeSort(array + nStart_, 0, static_cast<int>(nEnd_ - nStart_), Less);
+	else
+	{
+		int _nDepthLimit = 0;
+		for (size_t n = nEnd_ - nStart_; n > 1; n >>= 1)
+			_nDepthLimit += 2;
+		QuickSortChunk(array, nStart_, nEnd_, _nDepthLimit);
+	}
+}
+
+// 先划分再排序的主过程, nFd_不为-1时，每个排序完成的分块开始异步写回文件。
+static void SortRange(int array[], size_t nLength_, int nFd_, const MmapSortOptions& options_,
+		MmapSortStats& stats_)
+{
+	size_t _nChunkKeys = std::max<size_t>(options_.nChunkBytes / sizeof(int), 1024);
+	_nChunkKeys = std::min<size_t>(_nChunkKeys, INT_MAX);
+	stats_.nKeys = nLength_;
+
+	// 待处理的区间，后进先出，先压入第二部分再压入第一部分，使区间按照地址从小到大处理
+	std::vector<std::pair<size_t, size_t> > _vecRanges;
+	_vecRanges.push_back(std::make_pair(static_cast<size_t>(0), nLength_));
+	while (!_vecRanges.empty())
+	{
+		size_t _nStart = _vecRanges.back().first;
+		size_t _nEnd = _vecRanges.back().second;
+		_vecRanges.pop_back();
+
+		if (_nEnd - _nStart <= _nChunkKeys)
+		{
+			std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+			Advise(array + _nStart, (_nEnd - _nStart) * sizeof(int), MADV_WILLNEED);
+			SortChunk(array, _nStart, _nEnd, options_, stats_);
+#ifdef SYNC_FILE_RANGE_WRITE
+			if (nFd_ >= 0)
+				sync_file_range(nFd_, _nStart * sizeof(int), (_nEnd - _nStart) * sizeof(int), SYNC_FILE_RANGE_WRITE);
+#endif
+			stats_.dChunkSortSeconds += SecondsSince(_start);
+			continue;
+		}
+
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		int _nPivot = 0;
+		bool _bInclusive = false;
+		if (ChoosePivot(array, _nStart, _nEnd, _nPivot, _bInclusive))
+		{
+			size_t _nMiddle = PartitionByValue(array, _nStart, _nEnd, _nPivot, _bInclusive);
+			_vecRanges.push_back(std::make_pair(_nMiddle, _nEnd));
+			_vecRanges.push_back(std::make_pair(_nStart, _nMiddle));
+		}
+		stats_.nPartitionBytes += (_nEnd - _nStart) * sizeof(int);
+		stats_.dPartitionSeconds += SecondsSince(_start);
+	}
+	(void)nFd_;
+}
+
+void SortKeysInPlace(int array[], size_t nLength_, const MmapSortOptions& options_, MmapSortStats* pStats_)
+{
+	MmapSortStats _stats;
+	if (array != nullptr && nLength_ > 1)
+		SortRange(array, nLength_, -1, options_, _stats);
+	if (pStats_ != nullptr)
+		*pStats_ = _stats;
+}
+
+bool MmapSortFile(const char* szPath_, const MmapSortOptions& options_, MmapSortStats* pStats_)
+{
+	MmapSortStats _stats;
+	int _nFd = open(szPath_, O_RDWR);
+	if (_nFd < 0)
+	{
+		std::cerr << "无法打开文件" << szPath_ << "：" << strerror(errno) << std::endl;
+		return false;
+	}
+
+	struct stat _fileStat;
+	if (fstat(_nFd, &_fileStat) != 0)
+	{
+		std::cerr << "无法获取文件" << szPath_ << "的大小：" << strerror(errno) << std::endl;
+		close(_nFd);
+		return false;
+	}
+	if (_fileStat.st_size % sizeof(int) != 0)
+	{
+		std::cerr << "文件" << szPath_ << "的大小不是" << sizeof(int) << "的倍数" << std::endl;
+		close(_nFd);
+		return false;
+	}
+
+	size_t _nBytes = _fileStat.st_size;
+	if (_nBytes / sizeof(int) < 2)
+	{
+		close(_nFd);
+		if (pStats_ != nullptr)
+			*pStats_ = _stats;
+		return true;
+	}
+
+	// 文件不超过物理内存的一半时一次性预读，否则预读反而会把前面读入的页挤出去
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	int _nFlags = MAP_SHARED;
+	size_t _nPhysicalBytes = static_cast<size_t>(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGESIZE);
+	_stats.bPopulated = options_.nPopulate > 0 || (options_.nPopulate < 0 && _nBytes <= _nPhysicalBytes / 2);
+#ifdef MAP_POPULATE
+	if (_stats.bPopulated)
+		_nFlags |= MAP_POPULATE;
+#else
+	_stats.bPopulated = false;
+#endif
+	void* _pMapped = mmap(nullptr, _nBytes, PROT_READ | PROT_WRITE, _nFlags, _nFd, 0);
+	if (_pMapped == MAP_FAILED)
+	{
+		std::cerr << "无法映射文件" << szPath_ << "：" << strerror(errno) << std::endl;
+		close(_nFd);
+		return false;
+	}
+	Advise(_pMapped, _nBytes, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+	// 只有支持大页的文件系统(例如tmpfs)才会生效，其它情况下忽略错误
+	if (options_.bHugePages)
+		Advise(_pMapped, _nBytes, MADV_HUGEPAGE);
+#endif
+	_stats.dMapSeconds = SecondsSince(_start);
+
+	SortRange(static_cast<int*>(_pMapped), _nBytes / sizeof(int), _nFd, options_, _stats);
+
+	bool _bOk = true;
+	_start = std::chrono::steady_clock::now();
+	if (options_.bSync && msync(_pMapped, _nBytes, MS_SYNC) != 0)
+	{
+		std::cerr << "写回文件" << szPath_ << "失败：" << strerror(errno) << std::endl;
+		_bOk = false;
+	}
+	_stats.dSyncSeconds = SecondsSince(_start);
+
+	munmap(_pMapped, _nBytes);
+	close(_nFd);
+	if (pStats_ != nullptr)
+		*pStats_ = _stats;
+	return _bOk;
+}
@@ -0,0 +1,78 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 09时21分44秒
+*   Modifed Time: 2026年10月20日 星期二 11时03分18秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef MMAP_SORT_H
+#define MMAP_SORT_H
+#include <cstddef>
+
+// 通过mmap()对二进制文件中的键进行原地排序。
+// 文件中的每个键是一个4字节的int, 按照本机的字节序存放，文件的大小必须是4的倍数。
+// 文件映射到内存之后直接在页缓存中排序，不需要先读到堆上的缓冲区再写回去，I/O量与内存
+// 的峰值都只有原来的一半。
+//
+// 排序分为两个阶段(先划分再排序)：
+// 1. 划分：对大于一个分块(默认32MB)的区间，从区间中等间隔地选出31个样本，用它们的中位数
+// 作为划分值, 从前向后扫描一遍把区间划分为两部分。扫描是顺序的，配合MADV_SEQUENTIAL,
+// 内核可以提前读入后面的页并及时回收前面的页。
+// 2. 分块排序：区间不大于一个分块时，使用MergeSort或者三路划分的快速排序对它排序，此时
+// 所有的访问都集中在这一个分块内。排序完成的分块开始异步写回磁盘，变为干净页之后内核可以
+// 直接回收, 文件接近内存大小时也不会因为大量的脏页而反复换入换出。
+// 区间总是按照地址从小到大的顺序处理，内存中活跃的页始终只是文件中的一小段。
+//
+// 说明：
+// 1. 大量重复的键会使中位数等于区间的最小值或最大值，此时改用小于等于进行划分，保证两部分
+// 都不为空；区间内所有的键都相等时不再处理。
+// 2. 分块内的快速排序不使用QuickSort_Version2: 它选第一个元素作为划分值，在有序的分块上
+// 递归深度等于分块的大小；重复的键都划分到同一边，重复的键很多时退化为O(N^2). 这里使用三路
+// 划分，等于划分值的键不再参与排序。默认仍使用MergeSort, 已经有序的分块直接跳过。
+//
+enum MmapLeafSort
+{
+	MMAP_LEAF_MERGE_SORT,		// 使用MergeSort对分块排序
+	MMAP_LEAF_QUICK_SORT,		// 使用三路划分的快速排序对分块排序
+};
+
+struct MmapSortOptions
+{
+	size_t nChunkBytes = 32 << 20;				// 分块的大小
+	MmapLeafSort eLeafSort = MMAP_LEAF_MERGE_SORT;
+	int nPopulate = -1;							// MAP_POPULATE: 1使用, 0不使用, -1当文件不超过物理内存的一半时使用
+	bool bHugePages = true;						// 是否使用MADV_HUGEPAGE提示
+	bool bSync = true;							// 排序完成后是否调用msync()等待数据写回磁盘
+};
+
+// 排序过程的统计信息
+struct MmapSortStats
+{
+	size_t nKeys = 0;
+	size_t nChunks = 0;							// 排序的分块个数
+	size_t nSortedChunks = 0;					// 其中本来就有序而跳过的分块个数
+	unsigned long long nPartitionBytes = 0;		// 划分阶段扫描的总字节数
+	bool bPopulated = false;					// 是否使用了MAP_POPULATE
+	double dMapSeconds = 0;						// 映射文件(包括预读)的时间
+	double dPartitionSeconds = 0;
+	double dChunkSortSeconds = 0;
+	double dSyncSeconds = 0;
+};
+
+// 对内存中的nLength_个键进行排序，使用与文件排序相同的先划分再排序的方法。
+void SortKeysInPlace(int array[], size_t nLength_, const MmapSortOptions& options_, MmapSortStats* pStats_);
+
+// 对文件中的键进行原地排序，成功时返回true, 失败时输出错误信息并返回false. pStats_可以为空。
+bool MmapSortFile(const char* szPath_, const MmapSortOptions& options_, MmapSortStats* pStats_);
+
+#endif	// MMAP_SORT_H
@@ -15,8 +15,9 @@
 *   Github: https://github.com/yinheyi
 *   
 ***********************************************************************/
+#include "stack.h"
 #include <iostream>
-#include <stdexcept>
+#include <string>
 
 /*************************   栈的简单介绍     ****************************/
 // 1. 栈是很常用的数据结构，可能程序员使用栈的机会比数组少，但是，在程序调用过程中一直在
@@ -30,115 +31,18 @@
 //      empty(), 判断栈是否为空
 //      size(), 栈中元素的个数
 // 4.下面基于数组来实现栈的定义， 基于数组来实现的栈是有最大容量的.
+// 5. 构造时可以指定为可增长的栈：栈满时重新申请一块两倍大小的内存，把元素移动过去，这样
+// 入栈的均摊时间复杂度仍然为O(1), 并且没有最大容量的限制。
+// 6. 数组只申请内存，不构造元素，入栈时才在对应的位置上构造元素(placement new), 出栈时
+// 析构它。这样不需要T有默认构造函数，也不会在构造栈时构造m_nCapicity个用不到的元素。入栈
+// 右值或者使用Emplace()直接在栈中构造时没有任何拷贝，对于string这样的类型只是移动指针。
+// 7. Stack<T, N>把前N个元素直接存放在栈对象内部，超过N个元素时才在堆上申请内存(类似于
+// 小字符串优化)。大部分栈中的元素都很少，作为局部变量时入栈出栈完全不需要申请内存。
+// 栈的定义与实现在stack.h中，这样其它程序(例如二叉树的遍历)也可以使用它。
+// 8. 元素非常多并且不希望增长时移动元素，可以使用分段栈SegmentedStack<T>, 见11-分段栈.cpp.
 //
 //
 //
-/*************************   stack类的定义     ****************************/
-// 定义一个栈的模板类
-template <typename T>
-class Stack
-{
-public:
-	Stack();
-	explicit Stack(size_t capicity);
-	~Stack();
-
-	void Push(const T& Value);
-	void Pop();
-	T Top() const;
-
-	bool Empty() const;
-	bool Full() const;
-	size_t Size() const;
-	size_t Capicity() const;
-
-private:
-	size_t m_nCapicity;		// 数组最大容量
-	size_t m_nSize;			// 当前数组内包含的元素个数
-	T* m_pArray;			// 一维数组的指针
-};
-
-/*************************   stack类的的实现     ****************************/
-// 构造与析构函数的定义
-template <typename T>
-Stack<T>::Stack()
-{
-	// 默认的容量大小为1000.
-	m_nCapicity = 1000;
-	m_nSize = 0;
-	m_pArray = new T[m_nCapicity];
-}
-
-template <typename T>
-Stack<T>::Stack(size_t capicity)
-{
-	m_nCapicity = capicity;
-	m_nSize = 0;
-	m_pArray = new T[m_nCapicity];
-}
-
-template <typename T>
-Stack<T>::~Stack()
-{
-	delete [] m_pArray;
-	m_pArray = nullptr;
-}
-
-// 入栈/出栈/获取栈顶元素的函数定义
-template <typename T>
-void Stack<T>::Push(const T& value)
-{
-	// 栈否为满的判断
-	if (Full())
-		std::cerr << "栈为满，入栈失败" << std::endl;
-	else
-		m_pArray[m_nSize++] = value;
-}
-
-template <typename T>
-void Stack<T>::Pop()
-{
-	// 栈否为空的判断
-	if (Empty())
-		std::cerr << "栈为空，出栈失败" << std::endl;
-	else
-		--m_nSize;
-}
-
-template <typename T>
-T Stack<T>::Top() const
-{
-	if (Empty())
-		throw std::out_of_range("栈空，不存在栈顶元素");
-	else
-		return m_pArray[m_nSize - 1];
-}
-
-// 栈空/栈满/栈内元素个数的相关函数
-template <typename T>
-bool Stack<T>::Empty() const
-{
-	return 0 == m_nSize;
-}
-
-template <typename T>
-bool Stack<T>::Full() const
-{
-	return m_nSize == m_nCapicity;
-}
-
-template <typename T>
-size_t Stack<T>::Size() const
-{
-	return m_nSize;
-}
-
-template <typename T>
-size_t Stack<T>::Capicity() const
-{
-	return m_nCapicity;
-}
-
 /***************    测试程序   ****************************/
 int main(int argc, char* argv[])
 {
@@ -159,6 +63,35 @@ int main(int argc, char* argv[])
 	std::cout << "栈顶的元素为：" << stack.Top() << std::endl;
 	stack.Pop();
 
+	// 可增长的栈，入栈时移动或者直接构造string, 没有拷贝
+	Stack<std::string> growable(2, true);
+	std::string _strValue = "第一个字符串";
+	growable.Push(std::move(_strValue));
+	growable.Emplace(5, 'x');
+	growable.Emplace("第三个字符串");
+	growable.Push(growable.Top());
+	std::cout << "可增长的栈内元素个数为：" << growable.Size() << ", 容量为：" << growable.Capicity() << std::endl;
+	growable.Top() += "(修改过)";
+	std::cout << "栈顶的元素为：" << growable.Top() << std::endl;
+	growable.Reserve(100);
+	std::cout << "Reserve(100)之后的容量为：" << growable.Capicity() << std::endl;
+	growable.ShrinkToFit();
+	std::cout << "ShrinkToFit()之后的容量为：" << growable.Capicity() << std::endl;
+
+	// 内部存放4个元素的栈，第5个元素入栈时才转移到堆上
+	Stack<int, 4> smallStack;
+	for (int i = 0; i < 6; ++i)
+	{
+		smallStack.Push(i);
+		std::cout << "入栈" << i << "之后容量为：" << smallStack.Capicity()
+			<< (smallStack.IsInline() ? ", 在栈对象内部" : ", 在堆上") << std::endl;
+	}
+	smallStack.Pop();
+	smallStack.Pop();
+	smallStack.ShrinkToFit();
+	std::cout << "ShrinkToFit()之后的容量为：" << smallStack.Capicity()
+		<< (smallStack.IsInline() ? ", 在栈对象内部" : ", 在堆上") << std::endl;
+
 	stack.Pop();
 	stack.Top();
 
@@ -0,0 +1,373 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 16时20分33秒
+*   Modifed Time: 2026年10月20日 星期二 17时11分52秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define STACK_ARENA_HAS_PMR 1
+#endif
+#endif
+
+/*************************   栈式内存分配器的简单介绍     ****************************/
+// 1. 处理一个请求时会分配很多生命周期很短的对象，并且总是后分配的先释放(与栈的入栈出栈顺序
+// 相同)。这样的内存可以像1-栈.cpp中的栈一样，从一块连续的内存中依次分配：用一个栈顶指针
+// 记录已经分配到了哪里，分配时把栈顶指针向后移动(bump pointer), 一次分配只是一次指针加法。
+// 2. 与栈不同的是，每次分配的大小与对齐都可以不同，分配之前先把栈顶指针按要求对齐。
+// 3. Mark()记录当前的栈顶，Release(mark)把栈顶恢复到记录的位置，相当于一次性释放了mark之后
+// 分配的所有内存，时间复杂度为O(1). 例如处理请求之前Mark(), 处理完成之后Release().
+// 4. 第一块内存用完之后，再申请一块两倍大小的内存链接在后面，继续从新的内存块上分配。释放
+// 之后的内存块不会还给系统，而是留在链表中，下一次分配到这里时直接使用，稳定之后不会再调用
+// new. Trim()可以释放当前内存块之后所有暂时用不到的内存块。
+// 5. 分配的内存不会单独释放，Deallocate()只有在释放的恰好是最后一次分配的内存时才会把栈顶
+// 退回去，其它情况下什么也不做，内存在Release()或者Reset()时统一回收。
+// 6. 分配器只管理内存，不会调用析构函数，在其中构造的对象需要在Release()之前自己析构(或者
+// 是不需要析构的类型)。
+// 7. 使用C++17编译时，StackArenaResource把分配器包装为std::pmr::memory_resource, 可以直接
+// 用于std::pmr::vector/std::pmr::string等容器。
+//
+//
+/*************************   栈式内存分配器的定义     ****************************/
+class StackArena
+{
+public:
+	struct Block;
+
+	// 记录某一时刻的栈顶，用于Release()
+	struct Marker
+	{
+		Block* m_pBlock;
+		char* m_pTop;
+	};
+
+	explicit StackArena(size_t nFirstBlockBytes = 64 * 1024);
+	~StackArena();
+
+	void* Allocate(size_t nBytes, size_t nAlignment = alignof(std::max_align_t));
+	void Deallocate(void* p, size_t nBytes);	// 只有最后一次分配的内存才会真正回收
+
+	Marker Mark() const;
+	void Release(const Marker& marker);			// 释放marker之后分配的所有内存
+	void Reset();								// 释放所有的内存，内存块保留下来重复使用
+	void Trim();								// 把当前内存块之后的内存块还给系统
+
+	size_t BytesUsed() const;					// 已经分配出去的字节数(包括对齐的填充与前面内存块末尾用不到的部分)
+	size_t BytesReserved() const;				// 所有内存块的总字节数
+	size_t BlockCount() const;
+
+	// 内存块的头部，数据紧跟在头部之后
+	struct Block
+	{
+		Block* m_pNext;
+		size_t m_nBytes;		// 数据部分的字节数
+		size_t m_nBytesBefore;	// 前面所有内存块的字节数之和，用于计算BytesUsed()
+		char* Begin() { return reinterpret_cast<char*>(this) + HeaderBytes(); }
+		char* End() { return Begin() + m_nBytes; }
+		static size_t HeaderBytes() { return (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1); }
+	};
+
+private:
+	StackArena(const StackArena&);
+	StackArena& operator=(const StackArena&);
+
+	void* AllocateSlow(size_t nBytes, size_t nAlignment);
+	static Block* NewBlock(size_t nBytes);
+
+	Block* m_pFirst;		// 第一个内存块
+	Block* m_pCurrent;		// 当前正在分配的内存块
+	char* m_pTop;			// 当前内存块中的栈顶指针
+	char* m_pEnd;			// 当前内存块的结束位置
+};
+
+/*************************   栈式内存分配器的实现     ****************************/
+StackArena::StackArena(size_t nFirstBlockBytes)
+{
+	m_pFirst = NewBlock(nFirstBlockBytes);
+	m_pFirst->m_nBytesBefore = 0;
+	m_pCurrent = m_pFirst;
+	m_pTop = m_pFirst->Begin();
+	m_pEnd = m_pFirst->End();
+}
+
+StackArena::~StackArena()
+{
+	while (m_pFirst != nullptr)
+	{
+		Block* _pNext = m_pFirst->m_pNext;
+		::operator delete(m_pFirst);
+		m_pFirst = _pNext;
+	}
+}
+
+// 快速路径：对齐栈顶之后当前内存块放得下，只需要移动栈顶指针
+inline void* StackArena::Allocate(size_t nBytes, size_t nAlignment)
+{
+	if (nAlignment == 0 || (nAlignment & (nAlignment - 1)) != 0)
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+
+	// 先比较补齐的字节数与剩余的空间，补齐之后可能已经超出了内存块的结束位置
+	uintptr_t _nTop = reinterpret_cast<uintptr_t>(m_pTop);
+	size_t _nPadding = ((_nTop + nAlignment - 1) & ~(nAlignment - 1)) - _nTop;
+	size_t _nFree = static_cast<size_t>(m_pEnd - m_pTop);
+	if (_nPadding <= _nFree && nBytes <= _nFree - _nPadding)
+	{
+		char* _pResult = m_pTop + _nPadding;
+		m_pTop = _pResult + nBytes;
+		return _pResult;
+	}
+	return AllocateSlow(nBytes, nAlignment);
+}
+
+// 当前内存块放不下时，使用下一个保留下来的内存块，没有或者太小时再申请一块新的内存块插在
+// 当前内存块之后。
+void* StackArena::AllocateSlow(size_t nBytes, size_t nAlignment)
+{
+	Block* _pNext = m_pCurrent->m_pNext;
+	size_t _nNeeded = nBytes + nAlignment;
+	if (_pNext == nullptr || _pNext->m_nBytes < _nNeeded)
+	{
+		size_t _nBlockBytes = 2 * m_pCurrent->m_nBytes;
+		Block* _pBlock = NewBlock(_nBlockBytes < _nNeeded ? _nNeeded : _nBlockBytes);
+		_pBlock->m_pNext = _pNext;
+		m_pCurrent->m_pNext = _pBlock;
+		_pNext = _pBlock;
+	}
+
+	_pNext->m_nBytesBefore = m_pCurrent->m_nBytesBefore + m_pCurrent->m_nBytes;
+	m_pCurrent = _pNext;
+	m_pTop = m_pCurrent->Begin();
+	m_pEnd = m_pCurrent->End();
+	return Allocate(nBytes, nAlignment);
+}
+
+StackArena::Block* StackArena::NewBlock(size_t nBytes)
+{
+	Block* _pBlock = static_cast<Block*>(::operator new(Block::HeaderBytes() + nBytes));
+	_pBlock->m_pNext = nullptr;
+	_pBlock->m_nBytes = nBytes;
+	_pBlock->m_nBytesBefore = 0;
+	return _pBlock;
+}
+
+void StackArena::Deallocate(void* p, size_t nBytes)
+{
+	if (static_cast<char*>(p) + nBytes == m_pTop)
+		m_pTop = static_cast<char*>(p);
+}
+
+StackArena::Marker StackArena::Mark() const
+{
+	Marker _marker;
+	_marker.m_pBlock = m_pCurrent;
+	_marker.m_pTop = m_pTop;
+	return _marker;
+}
+
+void StackArena::Release(const Marker& marker)
+{
+	m_pCurrent = marker.m_pBlock;
+	m_pTop = marker.m_pTop;
+	m_pEnd = m_pCurrent->End();
+}
+
+void StackArena::Reset()
+{
+	m_pCurrent = m_pFirst;
+	m_pTop = m_pFirst->Begin();
+	m_pEnd = m_pFirst->End();
+}
+
+void StackArena::Trim()
+{
+	Block* _pBlock = m_pCurrent->m_pNext;
+	m_pCurrent->m_pNext = nullptr;
+	while (_pBlock != nullptr)
+	{
+		Block* _pNext = _pBlock->m_pNext;
+		::operator delete(_pBlock);
+		_pBlock = _pNext;
+	}
+}
+
+size_t StackArena::BytesUsed() const
+{
+	return m_pCurrent->m_nBytesBefore + (m_pTop - m_pCurrent->Begin());
+}
+
+size_t StackArena::BytesReserved() const
+{
+	size_t _nBytes = 0;
+	for (Block* _pBlock = m_pFirst; _pBlock != nullptr; _pBlock = _pBlock->m_pNext)
+		_nBytes += _pBlock->m_nBytes;
+	return _nBytes;
+}
+
+size_t StackArena::BlockCount() const
+{
+	size_t _nCount = 0;
+	for (Block* _pBlock = m_pFirst; _pBlock != nullptr; _pBlock = _pBlock->m_pNext)
+		++_nCount;
+	return _nCount;
+}
+
+/*************************   std::pmr::memory_resource适配器     ****************************/
+#ifdef STACK_ARENA_HAS_PMR
+class StackArenaResource : public std::pmr::memory_resource
+{
+public:
+	explicit StackArenaResource(StackArena& arena) : m_arena(arena) {}
+
+private:
+	void* do_allocate(size_t nBytes, size_t nAlignment) override
+	{
+		return m_arena.Allocate(nBytes, nAlignment);
+	}
+
+	void do_deallocate(void* p, size_t nBytes, size_t) override
+	{
+		m_arena.Deallocate(p, nBytes);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+
+	StackArena& m_arena;
+};
+#endif	// STACK_ARENA_HAS_PMR
+
+/***************    测试程序   ****************************/
+// 模拟一个请求处理过程中分配的对象
+struct Request
+{
+	int m_nId;
+	double m_dWeight;
+	char m_szName[40];
+};
+
+static double SecondsSince(std::chrono::steady_clock::time_point start_)
+{
+	std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - start_;
+	return _elapsed.count();
+}
+
+int main(int argc, char* argv[])
+{
+	StackArena _arena(1024);
+	std::cout << "初始：已分配" << _arena.BytesUsed() << "字节，共" << _arena.BytesReserved()
+		<< "字节, " << _arena.BlockCount() << "个内存块" << std::endl;
+
+	// 不同大小与对齐的分配
+	char* _pChars = static_cast<char*>(_arena.Allocate(3, 1));
+	double* _pDoubles = static_cast<double*>(_arena.Allocate(sizeof(double) * 4, alignof(double)));
+	void* _pAligned = _arena.Allocate(100, 64);
+	std::cout << "char数组：" << static_cast<void*>(_pChars) << ", double数组：" << _pDoubles
+		<< ", 按64字节对齐：" << _pAligned << (reinterpret_cast<uintptr_t>(_pAligned) % 64 == 0 ? "(已对齐)" : "(未对齐)")
+		<< std::endl;
+
+	// 对齐要求大于内存块剩余的空间时，补齐的字节数超出了内存块，应该使用新的内存块
+	StackArena _small(16);
+	char* _pSmall = static_cast<char*>(_small.Allocate(1, 1));
+	char* _pBig = static_cast<char*>(_small.Allocate(8, 4096));
+	memset(_pBig, 0, 8);
+	std::cout << "按4096字节对齐：" << (reinterpret_cast<uintptr_t>(_pBig) % 4096 == 0 ? "已对齐" : "未对齐")
+		<< ", " << (_pBig < _pSmall || _pBig >= _pSmall + 16 ? "使用了新的内存块" : "错误：在第一个内存块中")
+		<< ", 共" << _small.BlockCount() << "个内存块" << std::endl;
+
+	// Mark()之后分配超过第一个内存块的内存，Release()之后栈顶回到原来的位置
+	StackArena::Marker _marker = _arena.Mark();
+	size_t _nUsedBefore = _arena.BytesUsed();
+	for (int i = 0; i < 100; ++i)
+		new (_arena.Allocate(sizeof(Request), alignof(Request))) Request();
+	std::cout << "分配100个Request之后：已分配" << _arena.BytesUsed() << "字节，共" << _arena.BytesReserved()
+		<< "字节, " << _arena.BlockCount() << "个内存块" << std::endl;
+	_arena.Release(_marker);
+	std::cout << "Release()之后：已分配" << _arena.BytesUsed() << "字节(Mark()时为" << _nUsedBefore
+		<< "字节), 内存块保留下来：共" << _arena.BlockCount() << "个内存块" << std::endl;
+	_arena.Reset();
+	_arena.Trim();
+	std::cout << "Reset()与Trim()之后：已分配" << _arena.BytesUsed() << "字节，共" << _arena.BytesReserved()
+		<< "字节, " << _arena.BlockCount() << "个内存块" << std::endl;
+
+#ifdef STACK_ARENA_HAS_PMR
+	{
+		StackArena::Marker _pmrMarker = _arena.Mark();
+		StackArenaResource _resource(_arena);
+		std::pmr::vector<int> _vecValues(&_resource);
+		for (int i = 0; i < 1000; ++i)
+			_vecValues.push_back(i);
+		std::cout << "std::pmr::vector中有" << _vecValues.size() << "个元素，分配器中已分配"
+			<< _arena.BytesUsed() << "字节" << std::endl;
+		_vecValues.clear();
+		_vecValues.shrink_to_fit();
+		_arena.Release(_pmrMarker);
+	}
+#endif	// STACK_ARENA_HAS_PMR
+
+	// 与new/delete对比：每个请求分配8个Request, 处理完成之后全部释放
+	const int _nRequests = 1000000;
+	const int _nObjects = 8;
+	Request* _pRequests[_nObjects];
+	long long _nCheckSum = 0;
+
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	for (int i = 0; i < _nRequests; ++i)
+	{
+		for (int j = 0; j < _nObjects; ++j)
+		{
+			_pRequests[j] = new Request();
+			_pRequests[j]->m_nId = i + j;
+		}
+		for (int j = _nObjects - 1; j >= 0; --j)
+		{
+			_nCheckSum += _pRequests[j]->m_nId;
+			delete _pRequests[j];
+		}
+	}
+	double _dNewSeconds = SecondsSince(_start);
+
+	_start = std::chrono::steady_clock::now();
+	for (int i = 0; i < _nRequests; ++i)
+	{
+		StackArena::Marker _requestMarker = _arena.Mark();
+		for (int j = 0; j < _nObjects; ++j)
+		{
+			_pRequests[j] = new (_arena.Allocate(sizeof(Request), alignof(Request))) Request();
+			_pRequests[j]->m_nId = i + j;
+		}
+		for (int j = _nObjects - 1; j >= 0; --j)
+			_nCheckSum -= _pRequests[j]->m_nId;
+		_arena.Release(_requestMarker);
+	}
+	double _dArenaSeconds = SecondsSince(_start);
+
+	std::cout << _nRequests << "个请求，每个请求分配" << _nObjects << "个对象：new/delete用时" << _dNewSeconds
+		<< "秒, 栈式分配器用时" << _dArenaSeconds << "秒" << (_nCheckSum == 0 ? "" : ", 结果不一致！") << std::endl;
+	return 0;
+}
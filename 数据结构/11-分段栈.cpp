@@ -0,0 +1,129 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 17时30分05秒
+*   Modifed Time: 2026年10月20日 星期二 18时16分27秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "stack.h"
+#include "pad_right.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*************************   分段栈的简单介绍     ****************************/
+// 1. 可增长的Stack<T>在栈满时重新申请一块两倍大小的内存，把所有的元素移动过去。均摊下来每次
+// 入栈仍然是O(1)的，但是触发增长的那一次入栈需要移动全部的元素，栈中有几千万个元素时这一次
+// 入栈要花几十毫秒; 并且移动之后，原来指向栈中元素的指针全部失效。
+// 2. 分段栈(SegmentedStack<T>, 定义在stack.h中)把元素存放在一个个固定大小的内存块中，内存块
+// 从下向上链接起来。当前的内存块满了就链接一个新的内存块，当前的内存块空了就回到下面的内存块。
+// 入栈与出栈在最坏情况下也是O(1)的，元素一旦入栈，地址在出栈之前就不会改变。
+// 3. 如果栈的大小正好在内存块的边界上来回变化，每次入栈都要申请一个内存块，每次出栈都要释放
+// 一个内存块。所以空出来的内存块不马上释放，而是留作备用，下次需要新的内存块时直接使用。
+// 只保留一个备用的内存块，栈变小之后占用的内存也会跟着减少。
+// 4. 代价是元素不再连续存放，不能像数组一样随机访问(栈本来也不需要随机访问)。
+//
+// 下面的测试程序分别向可增长的Stack<int>与SegmentedStack<int>中压入大量的元素，统计每次入栈的
+// 耗时分布。参数可以指定元素的个数，默认为一千万个。
+//
+/***************    测试程序   ****************************/
+struct LatencySummary
+{
+	double dTotalSeconds;
+	double dP50;
+	double dP99;
+	double dP999;
+	double dMax;		// 单位都为纳秒
+};
+
+// 逐个计时nCount_次入栈, 计时本身的开销对两种栈是相同的
+template <typename StackType>
+static LatencySummary MeasurePush(StackType& stack_, size_t nCount_, std::vector<float>& vecLatencies_)
+{
+	typedef std::chrono::steady_clock Clock;
+	vecLatencies_.resize(nCount_);
+
+	Clock::time_point _start = Clock::now();
+	Clock::time_point _last = _start;
+	for (size_t i = 0; i < nCount_; ++i)
+	{
+		stack_.Push(static_cast<int>(i));
+		Clock::time_point _now = Clock::now();
+		vecLatencies_[i] = std::chrono::duration<float, std::nano>(_now - _last).count();
+		_last = _now;
+	}
+
+	LatencySummary _summary;
+	_summary.dTotalSeconds = std::chrono::duration<double>(_last - _start).count();
+	_summary.dMax = *std::max_element(vecLatencies_.begin(), vecLatencies_.end());
+	const double s_dQuantiles[] = {0.5, 0.99, 0.999};
+	double* s_pResults[] = {&_summary.dP50, &_summary.dP99, &_summary.dP999};
+	for (int i = 0; i < 3; ++i)
+	{
+		std::vector<float>::iterator _nth = vecLatencies_.begin() + static_cast<size_t>(s_dQuantiles[i] * (nCount_ - 1));
+		std::nth_element(vecLatencies_.begin(), _nth, vecLatencies_.end());
+		*s_pResults[i] = *_nth;
+	}
+	return _summary;
+}
+
+static void PrintSummary(const char* szName_, const LatencySummary& summary_)
+{
+	std::cout << std::left << std::setw(20) << szName_ << std::setw(12) << summary_.dTotalSeconds
+		<< std::setw(10) << summary_.dP50 << std::setw(10) << summary_.dP99
+		<< std::setw(10) << summary_.dP999 << summary_.dMax << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	// 基本操作与地址的稳定性
+	SegmentedStack<int, 4> _smallStack;
+	_smallStack.Push(0);
+	int* _pBottom = &_smallStack.Top();
+	for (int i = 1; i < 10; ++i)
+		_smallStack.Push(i);
+	std::cout << "压入10个元素之后有" << _smallStack.ChunkCount() << "个内存块" << std::endl;
+	std::cout << "出栈的顺序为：";
+	bool _bStable = true;
+	while (!_smallStack.Empty())
+	{
+		if (_smallStack.Size() == 1)
+			_bStable = &_smallStack.Top() == _pBottom;
+		std::cout << _smallStack.Top() << " ";
+		_smallStack.Pop();
+	}
+	std::cout << std::endl << "栈底元素的地址" << (_bStable ? "没有改变" : "改变了") << std::endl;
+	std::cout << "栈为空时有" << _smallStack.ChunkCount() << "个内存块" << std::endl << std::endl;
+
+	size_t _nCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	std::vector<float> _vecLatencies;
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "压入" << _nCount << "个int, 单次入栈的耗时(纳秒，包括计时的开销)：" << std::endl;
+	std::cout << PadRight("栈", 20) << PadRight("总时间(秒)", 12) << PadRight("p50", 10)
+		<< PadRight("p99", 10) << PadRight("p99.9", 10) << "最大值" << std::endl;
+	{
+		Stack<int> _stack(16, true);
+		LatencySummary _summary = MeasurePush(_stack, _nCount, _vecLatencies);
+		PrintSummary("Stack<int>", _summary);
+	}
+	{
+		SegmentedStack<int> _stack;
+		LatencySummary _summary = MeasurePush(_stack, _nCount, _vecLatencies);
+		PrintSummary("SegmentedStack<int>", _summary);
+	}
+	return 0;
+}
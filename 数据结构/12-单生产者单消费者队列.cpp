@@ -0,0 +1,375 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 19时45分20秒
+*   Modifed Time: 2026年10月20日 星期二 20时58分03秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "queue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/*******************    单生产者单消费者队列的简单介绍    ************************/
+// 1. 流水线中相邻的两个阶段分别在两个线程中运行，中间用一个队列连接：只有一个线程入队(生产者),
+// 只有一个线程出队(消费者)。用互斥锁保护queue<T>可以实现，但是每个元素都要加锁解锁两次，两个
+// 线程还会互相等锁。
+// 2. 只有一个生产者与一个消费者时，环形队列不需要任何锁：tail只由生产者修改，head只由消费者
+// 修改。生产者先把元素写入数组，再以release的方式更新tail; 消费者以acquire的方式读到新的tail
+// 之后，一定能看到写入的元素。出队的方向也是一样的。两边都不会等待对方，入队与出队都是无等待
+// (wait-free)的。
+// 3. head与tail分别放在不同的缓存行上，否则一边修改时会使另一边的缓存行失效(伪共享)。
+// 4. 生产者每次入队都要读head判断队列是否为满，而head所在的缓存行一直在被消费者修改，每读一次
+// 都要从另一个CPU核上取过来。所以生产者保存一份head的副本，只有副本表明队列满了，才重新读一次
+// head; 消费者同样保存一份tail的副本。队列不满不空时，两边基本上只访问自己的缓存行。
+// 5. 批量入队/出队时，一批元素全部写入(读出)之后只更新一次tail(head), 一次同步可以传递很多元素。
+// 6. 队列的容量为2的幂，使用与ring_queue相同的下标计算方式。
+//
+/*******************    单生产者单消费者队列的定义        *****************/
+template <typename T>
+class spsc_queue
+{
+public:
+	explicit spsc_queue(size_t nCapicity = 1024);		// 容量向上取为2的幂
+	~spsc_queue();
+
+	// 只能由生产者线程调用
+	bool try_enqueue(const T& value);					// 队列为满时返回false
+	size_t enqueue(const T* pValues, size_t nCount);	// 批量入队，返回入队的元素个数
+
+	// 只能由消费者线程调用
+	bool try_dequeue(T& value);							// 队列为空时返回false
+	size_t dequeue(T* pValues, size_t nCount);			// 批量出队，返回出队的元素个数
+
+	size_t size() const;								// 两个线程都在修改时只是一个近似值
+	size_t capicity() const;
+
+private:
+	spsc_queue(const spsc_queue&);
+	spsc_queue& operator=(const spsc_queue&);
+
+	// 消费者使用的数据
+	alignas(64) std::atomic<size_t> m_nHead;			// 队首元素的序号
+	size_t m_nCachedTail;								// 消费者保存的tail的副本
+
+	// 生产者使用的数据
+	alignas(64) std::atomic<size_t> m_nTail;			// 队尾元素的下一个序号
+	size_t m_nCachedHead;								// 生产者保存的head的副本
+
+	// 两边都只读的数据
+	alignas(64) size_t m_nMask;
+	T* m_pArray;
+};
+
+/*******************    单生产者单消费者队列的实现        *****************/
+template <typename T>
+spsc_queue<T>::spsc_queue(size_t capicity)
+	: m_nHead(0), m_nCachedTail(0), m_nTail(0), m_nCachedHead(0)
+{
+	size_t _nLength = 1;
+	while (_nLength < capicity)
+		_nLength <<= 1;
+	m_nMask = _nLength - 1;
+	m_pArray = new T[_nLength];
+}
+
+template <typename T>
+spsc_queue<T>::~spsc_queue()
+{
+	delete[] m_pArray;
+	m_pArray = nullptr;
+}
+
+template <typename T>
+bool spsc_queue<T>::try_enqueue(const T& value)
+{
+	size_t _nTail = m_nTail.load(std::memory_order_relaxed);
+	if (_nTail - m_nCachedHead > m_nMask)
+	{
+		// 副本表明队列满了，重新读取head
+		m_nCachedHead = m_nHead.load(std::memory_order_acquire);
+		if (_nTail - m_nCachedHead > m_nMask)
+			return false;
+	}
+
+	m_pArray[_nTail & m_nMask] = value;
+	m_nTail.store(_nTail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+size_t spsc_queue<T>::enqueue(const T* pValues, size_t nCount)
+{
+	size_t _nTail = m_nTail.load(std::memory_order_relaxed);
+	if (nCount > m_nMask + 1 - (_nTail - m_nCachedHead))
+	{
+		m_nCachedHead = m_nHead.load(std::memory_order_acquire);
+		nCount = std::min(nCount, m_nMask + 1 - (_nTail - m_nCachedHead));
+	}
+
+	for (size_t i = 0; i < nCount; ++i)
+		m_pArray[(_nTail + i) & m_nMask] = pValues[i];
+	m_nTail.store(_nTail + nCount, std::memory_order_release);
+	return nCount;
+}
+
+template <typename T>
+bool spsc_queue<T>::try_dequeue(T& value)
+{
+	size_t _nHead = m_nHead.load(std::memory_order_relaxed);
+	if (_nHead == m_nCachedTail)
+	{
+		// 副本表明队列空了，重新读取tail
+		m_nCachedTail = m_nTail.load(std::memory_order_acquire);
+		if (_nHead == m_nCachedTail)
+			return false;
+	}
+
+	value = m_pArray[_nHead & m_nMask];
+	m_nHead.store(_nHead + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+size_t spsc_queue<T>::dequeue(T* pValues, size_t nCount)
+{
+	size_t _nHead = m_nHead.load(std::memory_order_relaxed);
+	if (nCount > m_nCachedTail - _nHead)
+	{
+		m_nCachedTail = m_nTail.load(std::memory_order_acquire);
+		nCount = std::min(nCount, m_nCachedTail - _nHead);
+	}
+
+	for (size_t i = 0; i < nCount; ++i)
+		pValues[i] = m_pArray[(_nHead + i) & m_nMask];
+	m_nHead.store(_nHead + nCount, std::memory_order_release);
+	return nCount;
+}
+
+template <typename T>
+size_t spsc_queue<T>::size() const
+{
+	size_t _nHead = m_nHead.load(std::memory_order_acquire);
+	size_t _nTail = m_nTail.load(std::memory_order_acquire);
+	return _nTail > _nHead ? _nTail - _nHead : 0;
+}
+
+template <typename T>
+size_t spsc_queue<T>::capicity() const
+{
+	return m_nMask + 1;
+}
+
+/*******************    用于对比的加锁的队列        *****************/
+template <typename T>
+class locked_queue
+{
+public:
+	explicit locked_queue(size_t nCapicity) : m_queue(nCapicity) {}
+
+	bool try_enqueue(const T& value)
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		if (m_queue.full())
+			return false;
+		m_queue.enqueue(value);
+		return true;
+	}
+
+	bool try_dequeue(T& value)
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		if (m_queue.empty())
+			return false;
+		value = m_queue.front();
+		m_queue.dequeue();
+		return true;
+	}
+
+private:
+	std::mutex m_mutex;
+	queue<T> m_queue;
+};
+
+/**********************    测试程序     *************************/
+// 把当前线程绑定到第nCpu_个CPU核上，CPU核不够时不绑定
+static bool PinThread(unsigned nCpu_)
+{
+#ifdef __linux__
+	if (nCpu_ >= std::thread::hardware_concurrency())
+		return false;
+	cpu_set_t _cpuSet;
+	CPU_ZERO(&_cpuSet);
+	CPU_SET(nCpu_, &_cpuSet);
+	return pthread_setaffinity_np(pthread_self(), sizeof(_cpuSet), &_cpuSet) == 0;
+#else
+	(void)nCpu_;
+	return false;
+#endif
+}
+
+// 忙等一会儿，仍然等不到时让出CPU(只有一个CPU核时另一个线程需要运行)
+static inline void SpinWait(unsigned& nSpins_)
+{
+	if (++nSpins_ < 64)
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+	}
+	else
+	{
+		nSpins_ = 0;
+		std::this_thread::yield();
+	}
+}
+
+// 吞吐量：生产者入队nCount_个元素，消费者全部出队并检查顺序, 返回每个元素的平均耗时(纳秒)
+template <typename QueueType>
+static double MeasureThroughput(QueueType& queue_, size_t nCount_)
+{
+	bool _bInOrder = true;
+	std::thread _consumer([&]() {
+		PinThread(1);
+		unsigned _nSpins = 0;
+		size_t _nValue = 0;
+		for (size_t i = 0; i < nCount_; ++i)
+		{
+			while (!queue_.try_dequeue(_nValue))
+				SpinWait(_nSpins);
+			_bInOrder = _bInOrder && _nValue == i;
+		}
+	});
+
+	PinThread(0);
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	unsigned _nSpins = 0;
+	for (size_t i = 0; i < nCount_; ++i)
+	{
+		while (!queue_.try_enqueue(i))
+			SpinWait(_nSpins);
+	}
+	_consumer.join();
+	std::chrono::duration<double, std::nano> _elapsed = std::chrono::steady_clock::now() - _start;
+	if (!_bInOrder)
+		std::cerr << "出队的顺序不正确！" << std::endl;
+	return _elapsed.count() / nCount_;
+}
+
+// 批量的吞吐量，每批最多nBatch_个元素
+static double MeasureBatchThroughput(spsc_queue<size_t>& queue_, size_t nCount_, size_t nBatch_)
+{
+	bool _bInOrder = true;
+	std::thread _consumer([&]() {
+		PinThread(1);
+		std::vector<size_t> _vecValues(nBatch_);
+		unsigned _nSpins = 0;
+		for (size_t i = 0; i < nCount_; )
+		{
+			size_t _nCount = queue_.dequeue(_vecValues.data(), nBatch_);
+			if (_nCount == 0)
+				SpinWait(_nSpins);
+			for (size_t j = 0; j < _nCount; ++j, ++i)
+				_bInOrder = _bInOrder && _vecValues[j] == i;
+		}
+	});
+
+	PinThread(0);
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	std::vector<size_t> _vecValues(nBatch_);
+	unsigned _nSpins = 0;
+	for (size_t i = 0; i < nCount_; )
+	{
+		size_t _nBatch = std::min(nBatch_, nCount_ - i);
+		for (size_t j = 0; j < _nBatch; ++j)
+			_vecValues[j] = i + j;
+		size_t _nCount = queue_.enqueue(_vecValues.data(), _nBatch);
+		if (_nCount == 0)
+			SpinWait(_nSpins);
+		i += _nCount;
+	}
+	_consumer.join();
+	std::chrono::duration<double, std::nano> _elapsed = std::chrono::steady_clock::now() - _start;
+	if (!_bInOrder)
+		std::cerr << "批量出队的顺序不正确！" << std::endl;
+	return _elapsed.count() / nCount_;
+}
+
+// 延迟：两个线程通过一对队列来回传递一个元素(ping-pong), 单程的延迟为往返时间的一半
+template <typename QueueType>
+static double MeasureLatency(QueueType& ping_, QueueType& pong_, size_t nRounds_)
+{
+	std::thread _echo([&]() {
+		PinThread(1);
+		unsigned _nSpins = 0;
+		size_t _nValue = 0;
+		for (size_t i = 0; i < nRounds_; ++i)
+		{
+			while (!ping_.try_dequeue(_nValue))
+				SpinWait(_nSpins);
+			while (!pong_.try_enqueue(_nValue))
+				SpinWait(_nSpins);
+		}
+	});
+
+	PinThread(0);
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	unsigned _nSpins = 0;
+	size_t _nValue = 0;
+	for (size_t i = 0; i < nRounds_; ++i)
+	{
+		while (!ping_.try_enqueue(i))
+			SpinWait(_nSpins);
+		while (!pong_.try_dequeue(_nValue))
+			SpinWait(_nSpins);
+	}
+	_echo.join();
+	std::chrono::duration<double, std::nano> _elapsed = std::chrono::steady_clock::now() - _start;
+	return _elapsed.count() / nRounds_ / 2;
+}
+
+int main(int argc, char* argv[])
+{
+	size_t _nCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	size_t _nRounds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+	std::cout << "CPU核数：" << std::thread::hardware_concurrency()
+		<< (std::thread::hardware_concurrency() >= 2 ? ", 生产者与消费者分别绑定在CPU 0与CPU 1上" : ", 两个线程只能共用一个CPU核")
+		<< std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+
+	{
+		locked_queue<size_t> _lockedQueue(1023);
+		spsc_queue<size_t> _spscQueue(1024);
+		std::cout << "传递" << _nCount << "个元素，每个元素的平均耗时(纳秒)：" << std::endl;
+		std::cout << "  加锁的queue<T>:   " << MeasureThroughput(_lockedQueue, _nCount) << std::endl;
+		std::cout << "  spsc_queue:       " << MeasureThroughput(_spscQueue, _nCount) << std::endl;
+		std::cout << "  spsc_queue每批64: " << MeasureBatchThroughput(_spscQueue, _nCount, 64) << std::endl;
+	}
+	{
+		locked_queue<size_t> _lockedPing(15), _lockedPong(15);
+		spsc_queue<size_t> _spscPing(16), _spscPong(16);
+		std::cout << "来回传递" << _nRounds << "次，单程的平均延迟(纳秒)：" << std::endl;
+		std::cout << "  加锁的queue<T>:   " << MeasureLatency(_lockedPing, _lockedPong, _nRounds) << std::endl;
+		std::cout << "  spsc_queue:       " << MeasureLatency(_spscPing, _spscPong, _nRounds) << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,416 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 21时05分47秒
+*   Modifed Time: 2026年10月20日 星期二 22时31分09秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "queue.h"
+#include "pad_right.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*******************    多生产者多消费者队列的简单介绍    ************************/
+// 1. 多个线程入队，多个线程出队(例如线程池中的任务队列)。用一把锁保护整个队列时，所有的线程
+// 都在这一把锁上排队；使用链表实现的无锁队列则每个元素都要申请一次内存。
+// 2. 这里实现的是Dmitry Vyukov的有界多生产者多消费者队列：底层是长度为2的幂的环形数组，每个
+// 位置上除了元素之外还有一个序号(sequence), 序号说明这个位置当前处于什么状态。对于第pos次入队
+// 使用的位置(下标为pos & mask):
+//        序号 == pos              位置是空的，可以入队
+//        序号 == pos + 1          元素已经写入，可以出队
+//        序号 == pos + 数组长度    元素已经被取走，可以用于下一圈的第pos + 数组长度次入队
+// 3. 入队时读出enqueue_pos, 检查对应位置的序号等于pos之后，用CAS把enqueue_pos加1, 成功的线程
+// 就独占了这个位置，写入元素之后把序号改为pos + 1(release). 出队是对称的：检查序号等于pos + 1
+// 之后用CAS把dequeue_pos加1, 读出元素之后把序号改为pos + 数组长度。
+// 生产者之间只在enqueue_pos上竞争，消费者之间只在dequeue_pos上竞争，生产者与消费者之间只通过
+// 每个位置上的序号同步，不会互相阻塞。所有的内存在构造时一次申请好。
+// 4. try_enqueue()/try_dequeue()不会阻塞，队列为满或者为空时返回false. enqueue()/dequeue()
+// 会等待：先自旋一段时间(先忙等再让出CPU)，仍然不成功时睡眠(Linux上使用futex, C++20使用std::atomic::wait),
+// 对方操作成功之后如果发现有线程在睡眠就唤醒一个。没有线程睡眠时不会有任何系统调用。
+//
+/*******************    线程的睡眠与唤醒        *****************/
+// 线程在一个32位的计数上睡眠，计数没有变化时才真正睡眠，唤醒的一方先把计数加1再唤醒。
+class ParkingWord
+{
+public:
+	ParkingWord() : m_nEpoch(0) {}
+
+	uint32_t Epoch() const { return m_nEpoch.load(std::memory_order_acquire); }
+
+	// 计数仍然等于nEpoch时睡眠，直到被唤醒(可能会提前返回)
+	void Wait(uint32_t nEpoch)
+	{
+#if __cplusplus >= 202002L
+		m_nEpoch.wait(nEpoch, std::memory_order_acquire);
+#elif defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_nEpoch), FUTEX_WAIT_PRIVATE, nEpoch, nullptr, nullptr, 0);
+#else
+		if (Epoch() == nEpoch)
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+	}
+
+	void WakeOne()
+	{
+		m_nEpoch.fetch_add(1, std::memory_order_release);
+#if __cplusplus >= 202002L
+		m_nEpoch.notify_one();
+#elif defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_nEpoch), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#endif
+	}
+
+	void WakeAll()
+	{
+		m_nEpoch.fetch_add(1, std::memory_order_release);
+#if __cplusplus >= 202002L
+		m_nEpoch.notify_all();
+#elif defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_nEpoch), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+	}
+
+private:
+	std::atomic<uint32_t> m_nEpoch;
+};
+
+/*******************    多生产者多消费者队列的定义        *****************/
+template <typename T>
+class mpmc_queue
+{
+public:
+	explicit mpmc_queue(size_t nCapicity = 1024);		// 容量向上取为2的幂，至少为2
+	~mpmc_queue();
+
+	bool try_enqueue(const T& value);					// 队列为满时返回false
+	bool try_dequeue(T& value);							// 队列为空时返回false
+	void enqueue(const T& value);						// 队列为满时等待
+	void dequeue(T& value);								// 队列为空时等待
+
+	size_t size() const;								// 有线程在修改时只是一个近似值
+	size_t capicity() const;
+
+private:
+	mpmc_queue(const mpmc_queue&);
+	mpmc_queue& operator=(const mpmc_queue&);
+
+	struct Cell
+	{
+		std::atomic<size_t> m_nSequence;
+		T m_value;
+	};
+
+	// 先自旋再睡眠，直到tryFunc成功；waiters记录睡眠的线程个数，word用于睡眠
+	template <typename TryFunc>
+	void WaitUntil(TryFunc tryFunc, std::atomic<int>& waiters, ParkingWord& word);
+	void WakeIfWaiting(std::atomic<int>& waiters, ParkingWord& word);
+
+	static const int s_nSpinCount = 64;				// 睡眠之前忙等的次数
+	static const int s_nYieldCount = 16;			// 睡眠之前让出CPU的次数
+
+	alignas(64) std::atomic<size_t> m_nEnqueuePos;
+	alignas(64) std::atomic<size_t> m_nDequeuePos;
+	alignas(64) std::atomic<int> m_nWaitingProducers;	// 等待队列不满的线程个数
+	std::atomic<int> m_nWaitingConsumers;				// 等待队列不空的线程个数
+	ParkingWord m_notFull;
+	ParkingWord m_notEmpty;
+	alignas(64) size_t m_nMask;
+	Cell* m_pCells;
+};
+
+/*******************    多生产者多消费者队列的实现        *****************/
+template <typename T>
+mpmc_queue<T>::mpmc_queue(size_t capicity)
+	: m_nEnqueuePos(0), m_nDequeuePos(0), m_nWaitingProducers(0), m_nWaitingConsumers(0)
+{
+	size_t _nLength = 2;
+	while (_nLength < capicity)
+		_nLength <<= 1;
+	m_nMask = _nLength - 1;
+	m_pCells = new Cell[_nLength];
+	for (size_t i = 0; i < _nLength; ++i)
+		m_pCells[i].m_nSequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+mpmc_queue<T>::~mpmc_queue()
+{
+	delete[] m_pCells;
+	m_pCells = nullptr;
+}
+
+template <typename T>
+bool mpmc_queue<T>::try_enqueue(const T& value)
+{
+	Cell* _pCell = nullptr;
+	size_t _nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+	while (true)
+	{
+		_pCell = &m_pCells[_nPos & m_nMask];
+		size_t _nSequence = _pCell->m_nSequence.load(std::memory_order_acquire);
+		intptr_t _nDiff = static_cast<intptr_t>(_nSequence) - static_cast<intptr_t>(_nPos);
+		if (_nDiff == 0)
+		{
+			// 位置是空的，抢占它; CAS失败时_nPos被更新为最新的值
+			if (m_nEnqueuePos.compare_exchange_weak(_nPos, _nPos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (_nDiff < 0)
+		{
+			// 位置上还是上一圈的元素，没有被取走，队列为满
+			return false;
+		}
+		else
+		{
+			// 其它生产者已经抢占了这个位置
+			_nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	_pCell->m_value = value;
+	_pCell->m_nSequence.store(_nPos + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+bool mpmc_queue<T>::try_dequeue(T& value)
+{
+	Cell* _pCell = nullptr;
+	size_t _nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+	while (true)
+	{
+		_pCell = &m_pCells[_nPos & m_nMask];
+		size_t _nSequence = _pCell->m_nSequence.load(std::memory_order_acquire);
+		intptr_t _nDiff = static_cast<intptr_t>(_nSequence) - static_cast<intptr_t>(_nPos + 1);
+		if (_nDiff == 0)
+		{
+			if (m_nDequeuePos.compare_exchange_weak(_nPos, _nPos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (_nDiff < 0)
+		{
+			// 元素还没有写入，队列为空
+			return false;
+		}
+		else
+		{
+			_nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	value = _pCell->m_value;
+	_pCell->m_nSequence.store(_nPos + m_nMask + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+void mpmc_queue<T>::enqueue(const T& value)
+{
+	if (!try_enqueue(value))
+		WaitUntil([&]() { return try_enqueue(value); }, m_nWaitingProducers, m_notFull);
+	WakeIfWaiting(m_nWaitingConsumers, m_notEmpty);
+}
+
+template <typename T>
+void mpmc_queue<T>::dequeue(T& value)
+{
+	if (!try_dequeue(value))
+		WaitUntil([&]() { return try_dequeue(value); }, m_nWaitingConsumers, m_notEmpty);
+	WakeIfWaiting(m_nWaitingProducers, m_notFull);
+}
+
+// 睡眠之前先登记为等待的线程，再读出计数，然后再试一次：
+// 对方在操作成功之后检查有没有等待的线程(两边之间都有seq_cst的内存屏障), 所以要么这次再试能够
+// 成功，要么对方一定能看到等待的线程并且在读出计数之后修改计数，Wait()不会错过唤醒。
+template <typename T>
+template <typename TryFunc>
+void mpmc_queue<T>::WaitUntil(TryFunc tryFunc, std::atomic<int>& waiters, ParkingWord& word)
+{
+	while (true)
+	{
+		// 先忙等，再让出CPU(其它线程可能正在同一个CPU核上等着运行), 最后才睡眠
+		for (int i = 0; i < s_nSpinCount + s_nYieldCount; ++i)
+		{
+			if (tryFunc())
+				return;
+			if (i < s_nSpinCount)
+			{
+#if defined(__x86_64__) || defined(__i386__)
+				__builtin_ia32_pause();
+#endif
+			}
+			else
+				std::this_thread::yield();
+		}
+
+		waiters.fetch_add(1, std::memory_order_seq_cst);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		uint32_t _nEpoch = word.Epoch();
+		bool _bDone = tryFunc();
+		if (!_bDone)
+			word.Wait(_nEpoch);
+		waiters.fetch_sub(1, std::memory_order_relaxed);
+		if (_bDone)
+			return;
+	}
+}
+
+template <typename T>
+void mpmc_queue<T>::WakeIfWaiting(std::atomic<int>& waiters, ParkingWord& word)
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiters.load(std::memory_order_relaxed) > 0)
+		word.WakeOne();
+}
+
+template <typename T>
+size_t mpmc_queue<T>::size() const
+{
+	size_t _nDequeuePos = m_nDequeuePos.load(std::memory_order_relaxed);
+	size_t _nEnqueuePos = m_nEnqueuePos.load(std::memory_order_relaxed);
+	return _nEnqueuePos > _nDequeuePos ? _nEnqueuePos - _nDequeuePos : 0;
+}
+
+template <typename T>
+size_t mpmc_queue<T>::capicity() const
+{
+	return m_nMask + 1;
+}
+
+/*******************    用于对比的加锁的队列        *****************/
+template <typename T>
+class locked_queue
+{
+public:
+	explicit locked_queue(size_t nCapicity) : m_queue(nCapicity) {}
+
+	bool try_enqueue(const T& value)
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		return m_queue.enqueue(value);
+	}
+
+	bool try_dequeue(T& value)
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		if (m_queue.empty())
+			return false;
+		value = m_queue.front();
+		m_queue.dequeue();
+		return true;
+	}
+
+	// 与mpmc_queue的接口一致，等待时自旋并让出CPU
+	void enqueue(const T& value)
+	{
+		while (!try_enqueue(value))
+			std::this_thread::yield();
+	}
+
+	void dequeue(T& value)
+	{
+		while (!try_dequeue(value))
+			std::this_thread::yield();
+	}
+
+private:
+	std::mutex m_mutex;
+	ring_queue<T> m_queue;
+};
+
+/**********************    测试程序     *************************/
+// nThreads_个生产者与nThreads_个消费者共传递nTotal_个元素，返回每秒传递的元素个数(百万)。
+// 检查出队的元素之和等于入队的元素之和。
+template <typename QueueType>
+static double RunBenchmark(QueueType& queue_, int nThreads_, size_t nTotal_)
+{
+	size_t _nPerThread = nTotal_ / nThreads_;
+	std::atomic<unsigned long long> _nConsumed(0);
+	std::atomic<bool> _bStart(false);
+	std::vector<std::thread> _vecThreads;
+	for (int t = 0; t < nThreads_; ++t)
+	{
+		_vecThreads.push_back(std::thread([&, t]() {
+			while (!_bStart.load(std::memory_order_acquire))
+				std::this_thread::yield();
+			for (size_t i = 0; i < _nPerThread; ++i)
+				queue_.enqueue(t * _nPerThread + i);
+		}));
+		_vecThreads.push_back(std::thread([&]() {
+			while (!_bStart.load(std::memory_order_acquire))
+				std::this_thread::yield();
+			unsigned long long _nSum = 0;
+			size_t _nValue = 0;
+			for (size_t i = 0; i < _nPerThread; ++i)
+			{
+				queue_.dequeue(_nValue);
+				_nSum += _nValue;
+			}
+			_nConsumed.fetch_add(_nSum);
+		}));
+	}
+
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	_bStart.store(true, std::memory_order_release);
+	for (size_t i = 0; i < _vecThreads.size(); ++i)
+		_vecThreads[i].join();
+	std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+
+	unsigned long long _nCount = static_cast<unsigned long long>(_nPerThread) * nThreads_;
+	if (_nConsumed.load() != _nCount * (_nCount - 1) / 2)
+		std::cerr << "出队的元素与入队的元素不一致！" << std::endl;
+	return _nCount / _elapsed.count() / 1e6;
+}
+
+int main(int argc, char* argv[])
+{
+	// 单线程的基本操作
+	mpmc_queue<int> _queue(4);
+	for (int i = 0; i < 5; ++i)
+		std::cout << "入队" << i << (_queue.try_enqueue(i) ? "成功" : "失败, 队列为满") << std::endl;
+	int _nValue = 0;
+	while (_queue.try_dequeue(_nValue))
+		std::cout << "出队" << _nValue << std::endl;
+	std::cout << "队列为空，try_dequeue()返回false" << std::endl << std::endl;
+
+	size_t _nTotal = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+	size_t _nCapicity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+	std::cout << "CPU核数：" << std::thread::hardware_concurrency() << ", 每种配置共传递" << _nTotal
+		<< "个元素，队列容量为" << _nCapicity << ", 吞吐量的单位为百万个元素每秒" << std::endl;
+	std::cout << PadRight("生产者", 8) << PadRight("消费者", 8) << PadRight("加锁的队列", 12) << "mpmc_queue" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+	const int s_nThreads[] = {1, 2, 4, 8, 16, 32, 64};
+	for (size_t i = 0; i < sizeof(s_nThreads) / sizeof(s_nThreads[0]); ++i)
+	{
+		locked_queue<size_t> _lockedQueue(_nCapicity);
+		mpmc_queue<size_t> _mpmcQueue(_nCapicity);
+		std::cout << std::left << std::setw(8) << s_nThreads[i] << std::setw(8) << s_nThreads[i]
+			<< std::setw(12) << RunBenchmark(_lockedQueue, s_nThreads[i], _nTotal)
+			<< RunBenchmark(_mpmcQueue, s_nThreads[i], _nTotal) << std::endl;
+	}
+	return 0;
+}
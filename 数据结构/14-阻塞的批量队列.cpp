@@ -0,0 +1,376 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月21日 星期三 09时12分30秒
+*   Modifed Time: 2026年10月21日 星期三 10时47分58秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "queue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*******************    阻塞的批量队列的简单介绍    ************************/
+// 1. 生产者与消费者之间的任务队列：队列为空时消费者睡眠等待，队列为满时生产者睡眠等待，等待时
+// 不占用CPU. 这里用一把互斥锁与两个条件变量实现，底层是ring_queue.
+// 2. 减少唤醒的次数：每次入队都唤醒一个消费者的话，每个元素都会引起一次线程切换。这里只有在
+// 队列由空变为不空、并且有消费者在睡眠时才唤醒一个消费者。被唤醒的消费者用dequeue_batch()一次
+// 取走多个元素，如果取完之后队列中还有元素并且还有消费者在睡眠，再由它唤醒下一个消费者。
+// 队列由满变为不满时也是一样，一次批量出队只唤醒一次生产者。
+// 3. 背压(backpressure): 队列中的元素个数达到高水位时调用一次高水位的回调函数(例如通知上游
+// 暂停发送), 之后降到低水位时调用一次低水位的回调函数(通知上游恢复发送)。两个水位之间有一段
+// 距离，避免元素个数在一个值附近变化时反复调用回调函数。回调函数在锁外调用，可以访问队列。
+// 4. 关闭：close()之后入队全部失败，消费者继续取出队列中剩下的元素，取完之后dequeue()返回
+// false, dequeue_batch()返回0, 所有等待的线程都会被唤醒。这样停止服务时不会丢失已经入队的元素。
+//
+/*******************    阻塞的批量队列的定义        *****************/
+template <typename T>
+class blocking_queue
+{
+public:
+	typedef std::function<void()> Callback;
+
+	// nHighWatermark为0时不使用背压的回调函数
+	blocking_queue(size_t nCapicity, size_t nHighWatermark = 0, size_t nLowWatermark = 0);
+
+	void set_watermark_callbacks(const Callback& onHigh, const Callback& onLow);
+	void set_coalesce_notify(bool bCoalesce);		// 为false时每次入队出队都唤醒对方，用于对比
+
+	bool enqueue(const T& value);					// 队列为满时等待，队列关闭时返回false
+	bool try_enqueue(const T& value);				// 队列为满或者关闭时返回false
+	size_t enqueue_batch(const T* pValues, size_t nCount);	// 返回入队的个数，关闭时可能少于nCount
+
+	bool dequeue(T& value);							// 队列为空时等待，关闭并且取完时返回false
+	// 最多取出nMax个元素，队列为空时最多等待timeout, 超时或者关闭并且取完时返回0
+	size_t dequeue_batch(T* pValues, size_t nMax, std::chrono::milliseconds timeout);
+
+	void close();									// 关闭队列，唤醒所有等待的线程
+	bool closed() const;
+	size_t size() const;
+	size_t capicity() const;
+
+	unsigned long long notify_count() const;		// 唤醒对方的次数
+
+private:
+	blocking_queue(const blocking_queue&);
+	blocking_queue& operator=(const blocking_queue&);
+
+	// 以下函数都在加锁的情况下调用，返回需要在锁外调用的回调函数
+	Callback AfterEnqueue(size_t nSizeBefore);
+	Callback AfterDequeue(size_t nSizeBefore);
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_notEmpty;
+	std::condition_variable m_notFull;
+	ring_queue<T> m_queue;
+	size_t m_nCapicity;
+	size_t m_nHighWatermark;
+	size_t m_nLowWatermark;
+	bool m_bAboveHigh;						// 是否已经达到高水位，还没有降到低水位
+	bool m_bClosed;
+	bool m_bCoalesce;
+	int m_nWaitingConsumers;
+	int m_nWaitingProducers;
+	Callback m_onHigh;
+	Callback m_onLow;
+	std::atomic<unsigned long long> m_nNotifyCount;
+};
+
+/*******************    阻塞的批量队列的实现        *****************/
+template <typename T>
+blocking_queue<T>::blocking_queue(size_t capicity, size_t nHighWatermark, size_t nLowWatermark)
+	: m_queue(capicity), m_nCapicity(capicity), m_nHighWatermark(nHighWatermark),
+	m_nLowWatermark(nLowWatermark), m_bAboveHigh(false), m_bClosed(false), m_bCoalesce(true),
+	m_nWaitingConsumers(0), m_nWaitingProducers(0), m_nNotifyCount(0)
+{
+	if (capicity == 0 || nLowWatermark > nHighWatermark || nHighWatermark > capicity)
+		throw std::invalid_argument("参数不合法！");
+}
+
+template <typename T>
+void blocking_queue<T>::set_watermark_callbacks(const Callback& onHigh, const Callback& onLow)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	m_onHigh = onHigh;
+	m_onLow = onLow;
+}
+
+template <typename T>
+void blocking_queue<T>::set_coalesce_notify(bool bCoalesce)
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	m_bCoalesce = bCoalesce;
+}
+
+template <typename T>
+bool blocking_queue<T>::enqueue(const T& value)
+{
+	return enqueue_batch(&value, 1) == 1;
+}
+
+template <typename T>
+bool blocking_queue<T>::try_enqueue(const T& value)
+{
+	Callback _callback;
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		if (m_bClosed || m_queue.size() >= m_nCapicity)
+			return false;
+		size_t _nSizeBefore = m_queue.size();
+		m_queue.enqueue(value);
+		_callback = AfterEnqueue(_nSizeBefore);
+	}
+	if (_callback)
+		_callback();
+	return true;
+}
+
+// 队列的空间不够时先放入一部分，再等待消费者取走元素
+template <typename T>
+size_t blocking_queue<T>::enqueue_batch(const T* pValues, size_t nCount)
+{
+	size_t _nDone = 0;
+	while (_nDone < nCount)
+	{
+		Callback _callback;
+		{
+			std::unique_lock<std::mutex> _lock(m_mutex);
+			while (!m_bClosed && m_queue.size() >= m_nCapicity)
+			{
+				++m_nWaitingProducers;
+				m_notFull.wait(_lock);
+				--m_nWaitingProducers;
+			}
+			if (m_bClosed)
+				return _nDone;
+
+			size_t _nSizeBefore = m_queue.size();
+			size_t _nCount = std::min(nCount - _nDone, m_nCapicity - _nSizeBefore);
+			m_queue.enqueue(pValues + _nDone, _nCount);
+			_nDone += _nCount;
+			_callback = AfterEnqueue(_nSizeBefore);
+		}
+		if (_callback)
+			_callback();
+	}
+	return _nDone;
+}
+
+template <typename T>
+bool blocking_queue<T>::dequeue(T& value)
+{
+	return dequeue_batch(&value, 1, std::chrono::milliseconds::max()) == 1;
+}
+
+template <typename T>
+size_t blocking_queue<T>::dequeue_batch(T* pValues, size_t nMax, std::chrono::milliseconds timeout)
+{
+	size_t _nCount = 0;
+	Callback _callback;
+	{
+		std::unique_lock<std::mutex> _lock(m_mutex);
+		if (m_queue.empty() && !m_bClosed)
+		{
+			// milliseconds::max()表示一直等待，直接加到当前时间上会溢出
+			bool _bForever = timeout == std::chrono::milliseconds::max();
+			std::chrono::steady_clock::time_point _deadline = _bForever ? std::chrono::steady_clock::time_point::max()
+				: std::chrono::steady_clock::now() + timeout;
+			++m_nWaitingConsumers;
+			while (m_queue.empty() && !m_bClosed)
+			{
+				if (_bForever)
+					m_notEmpty.wait(_lock);
+				else if (m_notEmpty.wait_until(_lock, _deadline) == std::cv_status::timeout)
+					break;
+			}
+			--m_nWaitingConsumers;
+		}
+		if (m_queue.empty())
+			return 0;
+
+		size_t _nSizeBefore = m_queue.size();
+		_nCount = m_queue.dequeue(pValues, nMax);
+		_callback = AfterDequeue(_nSizeBefore);
+	}
+	if (_callback)
+		_callback();
+	return _nCount;
+}
+
+template <typename T>
+void blocking_queue<T>::close()
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_bClosed = true;
+	}
+	m_notEmpty.notify_all();
+	m_notFull.notify_all();
+}
+
+template <typename T>
+bool blocking_queue<T>::closed() const
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_bClosed;
+}
+
+template <typename T>
+size_t blocking_queue<T>::size() const
+{
+	std::lock_guard<std::mutex> _lock(m_mutex);
+	return m_queue.size();
+}
+
+template <typename T>
+size_t blocking_queue<T>::capicity() const
+{
+	return m_nCapicity;
+}
+
+template <typename T>
+unsigned long long blocking_queue<T>::notify_count() const
+{
+	return m_nNotifyCount.load(std::memory_order_relaxed);
+}
+
+// 队列由空变为不空时才唤醒一个消费者; 不合并时每次都唤醒。
+// 在锁内调用notify_one()是安全的，被唤醒的线程在拿到锁之后才会继续运行。
+template <typename T>
+typename blocking_queue<T>::Callback blocking_queue<T>::AfterEnqueue(size_t nSizeBefore)
+{
+	if (m_nWaitingConsumers > 0 && (nSizeBefore == 0 || !m_bCoalesce))
+	{
+		m_nNotifyCount.fetch_add(1, std::memory_order_relaxed);
+		m_notEmpty.notify_one();
+	}
+
+	if (m_nHighWatermark > 0 && !m_bAboveHigh && m_queue.size() >= m_nHighWatermark)
+	{
+		m_bAboveHigh = true;
+		return m_onHigh;
+	}
+	return Callback();
+}
+
+// 取完之后队列中还有元素时，唤醒下一个睡眠的消费者(链式唤醒); 队列由满变为不满时唤醒生产者。
+template <typename T>
+typename blocking_queue<T>::Callback blocking_queue<T>::AfterDequeue(size_t nSizeBefore)
+{
+	if (m_nWaitingConsumers > 0 && !m_queue.empty())
+	{
+		m_nNotifyCount.fetch_add(1, std::memory_order_relaxed);
+		m_notEmpty.notify_one();
+	}
+	if (m_nWaitingProducers > 0 && (nSizeBefore >= m_nCapicity || !m_bCoalesce))
+	{
+		m_nNotifyCount.fetch_add(1, std::memory_order_relaxed);
+		m_notFull.notify_all();
+	}
+
+	if (m_bAboveHigh && m_queue.size() <= m_nLowWatermark)
+	{
+		m_bAboveHigh = false;
+		return m_onLow;
+	}
+	return Callback();
+}
+
+/**********************    测试程序     *************************/
+// 两个生产者逐个入队，两个消费者批量出队，统计唤醒的次数与每次出队平均取到的元素个数
+static void RunPipeline(bool bCoalesce_, size_t nItems_)
+{
+	blocking_queue<size_t> _queue(1024);
+	_queue.set_coalesce_notify(bCoalesce_);
+	std::atomic<unsigned long long> _nSum(0);
+	std::atomic<unsigned long long> _nBatches(0);
+
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	std::vector<std::thread> _vecConsumers;
+	for (int c = 0; c < 2; ++c)
+	{
+		_vecConsumers.push_back(std::thread([&]() {
+			size_t _values[64];
+			unsigned long long _nLocalSum = 0;
+			unsigned long long _nLocalBatches = 0;
+			size_t _nCount = 0;
+			while ((_nCount = _queue.dequeue_batch(_values, 64, std::chrono::milliseconds(100))) > 0
+					|| !_queue.closed())
+			{
+				for (size_t i = 0; i < _nCount; ++i)
+					_nLocalSum += _values[i];
+				_nLocalBatches += _nCount > 0;
+			}
+			_nSum.fetch_add(_nLocalSum);
+			_nBatches.fetch_add(_nLocalBatches);
+		}));
+	}
+
+	std::vector<std::thread> _vecProducers;
+	for (int p = 0; p < 2; ++p)
+	{
+		_vecProducers.push_back(std::thread([&, p]() {
+			for (size_t i = p; i < nItems_; i += 2)
+				_queue.enqueue(i);
+		}));
+	}
+	for (size_t i = 0; i < _vecProducers.size(); ++i)
+		_vecProducers[i].join();
+	_queue.close();
+	for (size_t i = 0; i < _vecConsumers.size(); ++i)
+		_vecConsumers[i].join();
+	std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+
+	std::cout << (bCoalesce_ ? "合并唤醒：  " : "每次都唤醒：") << "用时" << _elapsed.count() << "秒, 唤醒"
+		<< _queue.notify_count() << "次, 每次出队平均取到" << static_cast<double>(nItems_) / _nBatches.load()
+		<< "个元素" << (_nSum.load() == nItems_ * (nItems_ - 1) / 2 ? "" : ", 元素不一致！") << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	// 背压与关闭
+	blocking_queue<int> _queue(8, 6, 2);
+	_queue.set_watermark_callbacks([]() { std::cout << "  达到高水位，通知上游暂停" << std::endl; },
+			[]() { std::cout << "  降到低水位，通知上游恢复" << std::endl; });
+	for (int i = 0; i < 8; ++i)
+	{
+		std::cout << "入队" << i << std::endl;
+		_queue.enqueue(i);
+	}
+	std::cout << "队列为满时try_enqueue()" << (_queue.try_enqueue(8) ? "成功" : "失败") << std::endl;
+
+	int _values[4];
+	size_t _nCount = 0;
+	_queue.close();
+	std::cout << "关闭之后入队" << (_queue.enqueue(9) ? "成功" : "失败") << ", 剩下的元素仍然可以取出：" << std::endl;
+	while ((_nCount = _queue.dequeue_batch(_values, 4, std::chrono::milliseconds(10))) > 0)
+	{
+		std::cout << "  取出" << _nCount << "个元素：";
+		for (size_t i = 0; i < _nCount; ++i)
+			std::cout << _values[i] << " ";
+		std::cout << std::endl;
+	}
+	std::cout << "取完之后dequeue_batch()返回0" << std::endl << std::endl;
+
+	size_t _nItems = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+	std::cout << "两个生产者逐个入队" << _nItems << "个元素，两个消费者每次最多取64个：" << std::endl;
+	RunPipeline(false, _nItems);
+	RunPipeline(true, _nItems);
+	return 0;
+}
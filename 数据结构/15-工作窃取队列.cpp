@@ -0,0 +1,557 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月21日 星期三 13时40分12秒
+*   Modifed Time: 2026年10月21日 星期三 16时05分37秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*******************    工作窃取队列的简单介绍    ************************/
+// 1. 并行排序、树的归约、图的遍历这类分治的程序会不断地产生小任务。所有的线程共用一个任务
+// 队列时，这个队列就成了瓶颈。工作窃取(work stealing)的做法是：每个线程有一个自己的双端队列，
+// 新产生的任务放在自己队列的尾部，也从尾部取任务执行(后进先出，刚产生的任务数据还在缓存中);
+// 自己的队列空了，就随机找一个线程，从它队列的首部"偷"一个任务(首部的任务最老，通常也最大)。
+// 2. 这里实现的是Chase-Lev双端队列(ws_deque): 底层是一个长度为2的幂的环形数组，bottom与top
+// 是两个一直增长的下标。只有所有者线程修改bottom, 所有者入队(push_back)与出队(pop_back)时
+// 不需要任何原子的读-改-写操作(CAS、fetch_add), 只有在队列中只剩一个元素、可能与窃取者争抢时
+// 才用一次CAS. 窃取者(steal)从top处读出元素，用CAS把top加1, 成功才算偷到。
+// 3. 数组满时所有者申请一个两倍大小的数组，把元素复制过去。窃取者可能还在读旧的数组，所以旧的
+// 数组不马上释放，等到队列析构时一起释放(每次增长一倍，旧数组加起来不超过当前数组的大小)。
+// 4. 元素在数组中以std::atomic<T>存放，要求T是可以平凡复制的类型，一般存放任务的指针。
+// 5. fork_join_pool是建立在ws_deque上的一个小线程池：task_group::spawn()产生子任务，
+// task_group::wait()等待所有的子任务完成，等待的时候自己也去执行任务，而不是睡眠，所以任务中
+// 可以递归地产生和等待子任务。所有线程都找不到任务时才睡眠，产生任务时如果有线程在睡眠才唤醒。
+// 任务中不能抛出异常。
+//
+/*******************    工作窃取队列的定义        *****************/
+template <typename T>
+class ws_deque
+{
+public:
+	explicit ws_deque(size_t nCapicity = 64);		// 容量向上取为2的幂
+	~ws_deque();
+
+	// 以下两个函数只能由所有者线程调用
+	void push_back(const T& value);					// 队满时数组增长一倍
+	bool pop_back(T& value);						// 队列为空时返回false
+
+	// 任何线程都可以调用，队列为空或者与其它线程争抢失败时返回false
+	bool steal(T& value);
+
+	size_t size() const;							// 并发时只是一个近似值
+	bool empty() const;
+
+private:
+	ws_deque(const ws_deque&);
+	ws_deque& operator=(const ws_deque&);
+
+	struct Array
+	{
+		int64_t m_nMask;
+		std::atomic<T>* m_pData;
+
+		explicit Array(int64_t nCapicity) : m_nMask(nCapicity - 1), m_pData(new std::atomic<T>[nCapicity]) {}
+		~Array() { delete[] m_pData; }
+		void put(int64_t nIndex, const T& value) { m_pData[nIndex & m_nMask].store(value, std::memory_order_relaxed); }
+		T get(int64_t nIndex) const { return m_pData[nIndex & m_nMask].load(std::memory_order_relaxed); }
+	};
+
+	Array* grow(Array* pArray, int64_t nBottom, int64_t nTop);
+
+	// top与bottom放在不同的缓存行上。线程池中的队列是new出来的，C++17之前new不保证alignas(64),
+	// 所以这里用填充而不是alignas.
+	std::atomic<int64_t> m_nTop;					// 窃取者修改
+	char m_padding1[64];
+	std::atomic<int64_t> m_nBottom;					// 只有所有者修改
+	std::atomic<Array*> m_pArray;
+	char m_padding2[64];
+	std::vector<Array*> m_vecRetired;				// 增长之后的旧数组，析构时释放
+};
+
+/*******************    工作窃取队列的实现        *****************/
+template <typename T>
+ws_deque<T>::ws_deque(size_t capicity) : m_nTop(0), m_nBottom(0)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "ws_deque的元素必须是可以平凡复制的类型");
+	int64_t _nCapicity = 2;
+	while (static_cast<size_t>(_nCapicity) < capicity)
+		_nCapicity <<= 1;
+	m_pArray.store(new Array(_nCapicity), std::memory_order_relaxed);
+}
+
+template <typename T>
+ws_deque<T>::~ws_deque()
+{
+	delete m_pArray.load(std::memory_order_relaxed);
+	for (size_t i = 0; i < m_vecRetired.size(); ++i)
+		delete m_vecRetired[i];
+}
+
+template <typename T>
+typename ws_deque<T>::Array* ws_deque<T>::grow(Array* pArray, int64_t nBottom, int64_t nTop)
+{
+	Array* _pNew = new Array((pArray->m_nMask + 1) * 2);
+	for (int64_t i = nTop; i < nBottom; ++i)
+		_pNew->put(i, pArray->get(i));
+	m_vecRetired.push_back(pArray);
+	m_pArray.store(_pNew, std::memory_order_release);
+	return _pNew;
+}
+
+// 先写入元素，再用release发布新的bottom, 窃取者读到新的bottom时一定能读到元素
+template <typename T>
+void ws_deque<T>::push_back(const T& value)
+{
+	int64_t _nBottom = m_nBottom.load(std::memory_order_relaxed);
+	int64_t _nTop = m_nTop.load(std::memory_order_acquire);
+	Array* _pArray = m_pArray.load(std::memory_order_relaxed);
+	if (_nBottom - _nTop > _pArray->m_nMask)
+		_pArray = grow(_pArray, _nBottom, _nTop);
+	_pArray->put(_nBottom, value);
+	m_nBottom.store(_nBottom + 1, std::memory_order_release);
+}
+
+// 先把bottom减1"占住"最后一个元素，再读top. 中间的seq_cst屏障保证窃取者与所有者至少有一方能
+// 看到对方的修改，不会把同一个元素取走两次。
+template <typename T>
+bool ws_deque<T>::pop_back(T& value)
+{
+	int64_t _nBottom = m_nBottom.load(std::memory_order_relaxed) - 1;
+	Array* _pArray = m_pArray.load(std::memory_order_relaxed);
+	m_nBottom.store(_nBottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t _nTop = m_nTop.load(std::memory_order_relaxed);
+
+	if (_nTop > _nBottom)		// 队列为空
+	{
+		m_nBottom.store(_nBottom + 1, std::memory_order_relaxed);
+		return false;
+	}
+	value = _pArray->get(_nBottom);
+	if (_nTop < _nBottom)		// 至少还剩一个元素，窃取者不会取到这个位置
+		return true;
+
+	// 只剩最后一个元素，与窃取者用CAS争抢
+	bool _bWon = m_nTop.compare_exchange_strong(_nTop, _nTop + 1, std::memory_order_seq_cst,
+			std::memory_order_relaxed);
+	m_nBottom.store(_nBottom + 1, std::memory_order_relaxed);
+	return _bWon;
+}
+
+template <typename T>
+bool ws_deque<T>::steal(T& value)
+{
+	int64_t _nTop = m_nTop.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t _nBottom = m_nBottom.load(std::memory_order_acquire);
+	if (_nTop >= _nBottom)
+		return false;
+
+	Array* _pArray = m_pArray.load(std::memory_order_acquire);
+	T _value = _pArray->get(_nTop);
+	if (!m_nTop.compare_exchange_strong(_nTop, _nTop + 1, std::memory_order_seq_cst,
+				std::memory_order_relaxed))
+		return false;
+	value = _value;
+	return true;
+}
+
+template <typename T>
+size_t ws_deque<T>::size() const
+{
+	int64_t _nSize = m_nBottom.load(std::memory_order_relaxed) - m_nTop.load(std::memory_order_relaxed);
+	return _nSize > 0 ? static_cast<size_t>(_nSize) : 0;
+}
+
+template <typename T>
+bool ws_deque<T>::empty() const
+{
+	return size() == 0;
+}
+
+/*******************    fork-join线程池        *****************/
+class fork_join_pool;
+
+class task_group
+{
+public:
+	explicit task_group(fork_join_pool& pool) : m_pool(pool), m_nPending(0) {}
+	~task_group() { wait(); }
+
+	void spawn(const std::function<void()>& func);
+	void wait();				// 等待期间执行其它的任务
+
+private:
+	task_group(const task_group&);
+	task_group& operator=(const task_group&);
+	friend class fork_join_pool;
+
+	fork_join_pool& m_pool;
+	std::atomic<int> m_nPending;
+};
+
+class fork_join_pool
+{
+public:
+	explicit fork_join_pool(size_t nThreads);
+	~fork_join_pool();
+
+	// 在线程池中执行func并等待它完成，func中可以使用task_group
+	void invoke(const std::function<void()>& func);
+
+	size_t thread_count() const { return m_vecWorkers.size(); }
+	unsigned long long steal_count() const;
+
+private:
+	fork_join_pool(const fork_join_pool&);
+	fork_join_pool& operator=(const fork_join_pool&);
+	friend class task_group;
+
+	struct Task
+	{
+		std::function<void()> m_func;
+		task_group* m_pGroup;
+	};
+
+	struct Worker
+	{
+		fork_join_pool* m_pPool;
+		size_t m_nIndex;
+		unsigned m_nSeed;
+		ws_deque<Task*> m_deque;
+		std::atomic<unsigned long long> m_nSteals;
+		std::thread m_thread;
+	};
+
+	void Submit(Task* pTask);
+	bool RunOne();							// 找到一个任务并执行，没有任务时返回false
+	Task* FindTask();
+	void WorkerLoop(Worker* pWorker);
+	void WakeIfSleeping();
+
+	std::vector<std::unique_ptr<Worker> > m_vecWorkers;
+
+	std::mutex m_injectMutex;				// 线程池之外的线程提交的任务
+	ring_queue<Task*> m_injectQueue;
+	std::atomic<size_t> m_nInjected;
+
+	std::mutex m_sleepMutex;
+	std::condition_variable m_sleepCond;
+	std::atomic<int> m_nSleeping;
+	unsigned long long m_nEpoch;			// 由m_sleepMutex保护，每次唤醒加1
+	bool m_bStop;							// 由m_sleepMutex保护
+
+	static thread_local Worker* s_pCurrent;
+};
+
+thread_local fork_join_pool::Worker* fork_join_pool::s_pCurrent = nullptr;
+
+void task_group::spawn(const std::function<void()>& func)
+{
+	m_nPending.fetch_add(1, std::memory_order_relaxed);
+	fork_join_pool::Task* _pTask = new fork_join_pool::Task;
+	_pTask->m_func = func;
+	_pTask->m_pGroup = this;
+	m_pool.Submit(_pTask);
+}
+
+void task_group::wait()
+{
+	while (m_nPending.load(std::memory_order_acquire) > 0)
+	{
+		if (!m_pool.RunOne())
+			std::this_thread::yield();
+	}
+}
+
+fork_join_pool::fork_join_pool(size_t nThreads)
+	: m_injectQueue(64, true), m_nInjected(0), m_nSleeping(0), m_nEpoch(0), m_bStop(false)
+{
+	if (nThreads == 0)
+		throw std::invalid_argument("参数不合法！");
+	for (size_t i = 0; i < nThreads; ++i)
+	{
+		m_vecWorkers.push_back(std::unique_ptr<Worker>(new Worker));
+		Worker* _pWorker = m_vecWorkers.back().get();
+		_pWorker->m_pPool = this;
+		_pWorker->m_nIndex = i;
+		_pWorker->m_nSeed = static_cast<unsigned>(i * 2654435761u + 1);
+		_pWorker->m_nSteals.store(0, std::memory_order_relaxed);
+	}
+	// 所有的Worker都创建好之后再启动线程，线程启动之后会访问其它线程的队列
+	for (size_t i = 0; i < nThreads; ++i)
+		m_vecWorkers[i]->m_thread = std::thread(&fork_join_pool::WorkerLoop, this, m_vecWorkers[i].get());
+}
+
+fork_join_pool::~fork_join_pool()
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_sleepMutex);
+		m_bStop = true;
+	}
+	m_sleepCond.notify_all();
+	for (size_t i = 0; i < m_vecWorkers.size(); ++i)
+		m_vecWorkers[i]->m_thread.join();
+}
+
+void fork_join_pool::invoke(const std::function<void()>& func)
+{
+	std::mutex _mutex;
+	std::condition_variable _cond;
+	bool _bDone = false;
+
+	Task* _pTask = new Task;
+	_pTask->m_pGroup = nullptr;
+	_pTask->m_func = [&]() {
+		func();
+		std::lock_guard<std::mutex> _lock(_mutex);
+		_bDone = true;
+		_cond.notify_one();
+	};
+	Submit(_pTask);
+
+	std::unique_lock<std::mutex> _lock(_mutex);
+	while (!_bDone)
+		_cond.wait(_lock);
+}
+
+unsigned long long fork_join_pool::steal_count() const
+{
+	unsigned long long _nSteals = 0;
+	for (size_t i = 0; i < m_vecWorkers.size(); ++i)
+		_nSteals += m_vecWorkers[i]->m_nSteals.load(std::memory_order_relaxed);
+	return _nSteals;
+}
+
+// 线程池中的线程放入自己的队列，其它线程放入公共的队列
+void fork_join_pool::Submit(Task* pTask)
+{
+	if (s_pCurrent != nullptr && s_pCurrent->m_pPool == this)
+	{
+		s_pCurrent->m_deque.push_back(pTask);
+	}
+	else
+	{
+		std::lock_guard<std::mutex> _lock(m_injectMutex);
+		m_injectQueue.enqueue(pTask);
+		m_nInjected.store(m_injectQueue.size(), std::memory_order_relaxed);
+	}
+	WakeIfSleeping();
+}
+
+// 与WorkerLoop中的m_nSleeping加1配对：要么这里看到有线程准备睡眠，要么睡眠前的检查能看到新任务
+void fork_join_pool::WakeIfSleeping()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (m_nSleeping.load(std::memory_order_relaxed) == 0)
+		return;
+	{
+		std::lock_guard<std::mutex> _lock(m_sleepMutex);
+		++m_nEpoch;
+	}
+	m_sleepCond.notify_one();
+}
+
+// 先取自己队列的尾部，再从一个随机的位置开始依次偷其它线程的队列，最后看公共的队列
+fork_join_pool::Task* fork_join_pool::FindTask()
+{
+	Task* _pTask = nullptr;
+	Worker* _pSelf = s_pCurrent != nullptr && s_pCurrent->m_pPool == this ? s_pCurrent : nullptr;
+	if (_pSelf != nullptr && _pSelf->m_deque.pop_back(_pTask))
+		return _pTask;
+
+	size_t _nWorkers = m_vecWorkers.size();
+	size_t _nStart = 0;
+	if (_pSelf != nullptr)
+	{
+		_pSelf->m_nSeed = _pSelf->m_nSeed * 1103515245u + 12345u;
+		_nStart = (_pSelf->m_nSeed >> 16) % _nWorkers;
+	}
+	for (size_t i = 0; i < _nWorkers; ++i)
+	{
+		Worker* _pVictim = m_vecWorkers[(_nStart + i) % _nWorkers].get();
+		if (_pVictim != _pSelf && _pVictim->m_deque.steal(_pTask))
+		{
+			if (_pSelf != nullptr)
+				_pSelf->m_nSteals.fetch_add(1, std::memory_order_relaxed);
+			return _pTask;
+		}
+	}
+
+	if (m_nInjected.load(std::memory_order_relaxed) > 0)
+	{
+		std::lock_guard<std::mutex> _lock(m_injectMutex);
+		if (!m_injectQueue.empty())
+		{
+			_pTask = m_injectQueue.front();
+			m_injectQueue.dequeue();
+			m_nInjected.store(m_injectQueue.size(), std::memory_order_relaxed);
+			return _pTask;
+		}
+	}
+	return nullptr;
+}
+
+bool fork_join_pool::RunOne()
+{
+	Task* _pTask = FindTask();
+	if (_pTask == nullptr)
+		return false;
+	_pTask->m_func();
+	if (_pTask->m_pGroup != nullptr)
+		_pTask->m_pGroup->m_nPending.fetch_sub(1, std::memory_order_release);
+	delete _pTask;
+	return true;
+}
+
+void fork_join_pool::WorkerLoop(Worker* pWorker)
+{
+	s_pCurrent = pWorker;
+	for (;;)
+	{
+		if (RunOne())
+			continue;
+
+		// 先让出几次CPU, 仍然没有任务再睡眠
+		bool _bFound = false;
+		for (int i = 0; i < 16 && !_bFound; ++i)
+		{
+			std::this_thread::yield();
+			_bFound = RunOne();
+		}
+		if (_bFound)
+			continue;
+
+		unsigned long long _nEpoch;
+		{
+			std::lock_guard<std::mutex> _lock(m_sleepMutex);
+			if (m_bStop)
+				break;
+			_nEpoch = m_nEpoch;
+		}
+		m_nSleeping.fetch_add(1, std::memory_order_seq_cst);
+		if (RunOne())
+		{
+			m_nSleeping.fetch_sub(1, std::memory_order_relaxed);
+			continue;
+		}
+		{
+			std::unique_lock<std::mutex> _lock(m_sleepMutex);
+			while (m_nEpoch == _nEpoch && !m_bStop)
+				m_sleepCond.wait(_lock);
+		}
+		m_nSleeping.fetch_sub(1, std::memory_order_relaxed);
+	}
+	s_pCurrent = nullptr;
+}
+
+/**********************    测试程序     *************************/
+static const size_t s_nGrain = 4096;		// 小于这个大小时不再拆分任务
+
+static long long ParallelSum(fork_join_pool& pool_, const int* pData_, size_t nCount_)
+{
+	if (nCount_ <= s_nGrain)
+	{
+		long long _nSum = 0;
+		for (size_t i = 0; i < nCount_; ++i)
+			_nSum += pData_[i];
+		return _nSum;
+	}
+	long long _nLeft = 0;
+	task_group _group(pool_);
+	_group.spawn([&]() { _nLeft = ParallelSum(pool_, pData_, nCount_ / 2); });
+	long long _nRight = ParallelSum(pool_, pData_ + nCount_ / 2, nCount_ - nCount_ / 2);
+	_group.wait();
+	return _nLeft + _nRight;
+}
+
+static void ParallelSort(fork_join_pool& pool_, int* pBegin_, int* pEnd_)
+{
+	if (static_cast<size_t>(pEnd_ - pBegin_) <= s_nGrain)
+	{
+		std::sort(pBegin_, pEnd_);
+		return;
+	}
+	int _nPivot = pBegin_[(pEnd_ - pBegin_) / 2];
+	int* _pMid1 = std::partition(pBegin_, pEnd_, [=](int x) { return x < _nPivot; });
+	int* _pMid2 = std::partition(_pMid1, pEnd_, [=](int x) { return !(_nPivot < x); });
+	task_group _group(pool_);
+	_group.spawn([=, &pool_]() { ParallelSort(pool_, pBegin_, _pMid1); });
+	ParallelSort(pool_, _pMid2, pEnd_);
+	_group.wait();
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start_)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+}
+
+int main(int argc, char* argv[])
+{
+	// 单线程下的基本操作：所有者从尾部后进先出，窃取者从首部先进先出
+	ws_deque<int> _deque(2);
+	for (int i = 0; i < 6; ++i)
+		_deque.push_back(i);
+	int _nValue = 0;
+	_deque.steal(_nValue);
+	std::cout << "从首部偷到" << _nValue << ", 所有者从尾部依次取出：";
+	while (_deque.pop_back(_nValue))
+		std::cout << _nValue << " ";
+	std::cout << std::endl << std::endl;
+
+	size_t _nCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+	size_t _nMaxThreads = std::max(4u, std::thread::hardware_concurrency());
+	std::vector<int> _vecData(_nCount);
+	srand(1);
+	for (size_t i = 0; i < _nCount; ++i)
+		_vecData[i] = rand();
+	std::vector<int> _vecSorted(_vecData);
+	std::sort(_vecSorted.begin(), _vecSorted.end());
+	long long _nExpected = 0;
+	for (size_t i = 0; i < _nCount; ++i)
+		_nExpected += _vecData[i];
+
+	std::cout << _nCount << "个int的并行求和与并行排序(本机有" << std::thread::hardware_concurrency()
+		<< "个CPU):" << std::endl;
+	for (size_t _nThreads = 1; _nThreads <= _nMaxThreads; _nThreads *= 2)
+	{
+		fork_join_pool _pool(_nThreads);
+		long long _nSum = 0;
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		_pool.invoke([&]() { _nSum = ParallelSum(_pool, _vecData.data(), _vecData.size()); });
+		double _dSumSeconds = Seconds(_start);
+
+		std::vector<int> _vecWork(_vecData);
+		_start = std::chrono::steady_clock::now();
+		_pool.invoke([&]() { ParallelSort(_pool, _vecWork.data(), _vecWork.data() + _vecWork.size()); });
+		double _dSortSeconds = Seconds(_start);
+
+		std::cout << "  " << _nThreads << "个线程：求和" << _dSumSeconds << "秒, 排序" << _dSortSeconds
+			<< "秒, 窃取" << _pool.steal_count() << "次"
+			<< (_nSum == _nExpected && _vecWork == _vecSorted ? "" : ", 结果错误！") << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,603 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月22日 星期四 09时35分18秒
+*   Modifed Time: 2026年10月22日 星期四 14时02分51秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/*******************    基于内存映射的磁盘队列的简单介绍    ************************/
+// 1. 消费者跟不上生产者时，内存中的queue<T>要么满了丢弃数据，要么无限制地占用内存。磁盘队列把
+// 积压的记录写到磁盘上，内存中只保留正在写和正在读的一小部分。
+// 2. 记录写在一个个固定大小的段文件(segment-<段号>)中，第n个段存放第n * R到第(n + 1) * R - 1
+// 条记录(R为每段的记录数)。正在写的段与正在读的段通过mmap映射到内存：入队就是一次memcpy,
+// 出队时peek()直接返回映射中记录的指针(零拷贝), 处理完之后用consume()前进。任何时候最多只映射
+// 两个段，积压再多，进程占用的内存(RSS)也不会超过两个段的大小。写完一个段再换下一个段，对磁盘
+// 来说是顺序写，读也是顺序读。
+// 3. 一个段的记录全部被取走之后，段文件不删除，而是改名为备用文件(spare-<编号>), 下次需要新的段
+// 时直接改名使用，避免反复地创建文件、分配磁盘空间。最多保留两个备用文件。
+// 4. 检查点(checkpoint文件)只记录读位置与写位置。写检查点时先把映射的数据同步到磁盘，再把检查点
+// 写入临时文件后改名(rename是原子的), 所以崩溃时检查点要么是旧的，要么是新的，不会是半个。
+// 每写满一个段、以及正常析构时都会自动写一次检查点，也可以调用checkpoint()。崩溃之后重新打开
+// 队列时从检查点恢复：检查点之后入队的记录丢失，检查点之后取走的记录会再被取出一次(至少一次)。
+// 5. 记录必须是可以平凡复制的类型(直接按字节写入磁盘)。队列本身不是线程安全的。只支持Linux等
+// 提供mmap的系统。
+//
+/*******************    磁盘队列的定义        *****************/
+template <typename T>
+class disk_queue
+{
+public:
+	// 目录不存在时创建，存在检查点时从检查点恢复; 每个段的大小向下取为记录大小的整数倍
+	disk_queue(const std::string& strDir, size_t nSegmentBytes = 64 << 20);
+	~disk_queue();
+
+	void enqueue(const T& value);
+	void enqueue(const T* pValues, size_t nCount);	// 批量入队，跨段时分两次复制
+
+	// 返回当前段中可以连续读取的记录，nCount为记录的个数; 队列为空时返回nullptr.
+	// 返回的指针在consume()之前一直有效。
+	const T* peek(size_t& nCount);
+	void consume(size_t nCount);					// 取走peek()返回的前nCount条记录
+	bool dequeue(T& value);							// 复制一条记录再取走，队列为空时返回false
+
+	void checkpoint();								// 同步数据并记录当前的读写位置
+	uint64_t size() const;
+	bool empty() const;
+	size_t mapped_segments() const;					// 正在映射的段的个数，最多为2
+
+private:
+	disk_queue(const disk_queue&);
+	disk_queue& operator=(const disk_queue&);
+
+	struct Checkpoint
+	{
+		uint64_t m_nMagic;
+		uint64_t m_nRecordSize;
+		uint64_t m_nRecordsPerSegment;
+		uint64_t m_nReadPos;
+		uint64_t m_nWritePos;
+		uint64_t m_nChecksum;
+	};
+
+	static const uint64_t s_nMagic = 0x315545555144534BULL;	// "KSDQUEU1"
+	static const size_t s_nMaxSpareFiles = 2;
+
+	void Recover();
+	void OpenWriteSegment(uint64_t nSegment);
+	void CloseWriteSegment();
+	void OpenReadSegment(uint64_t nSegment);
+	void CloseReadSegment();
+	void RecycleSegment(uint64_t nSegment);
+	void* MapFile(const std::string& strPath, int nProt);
+	void SyncWriteSegment();
+	void WriteCheckpoint();
+	std::string SegmentPath(uint64_t nSegment) const;
+	std::string SparePath(unsigned nId) const;
+	static uint64_t Checksum(const Checkpoint& checkpoint);
+	static void ThrowError(const std::string& strWhat);
+
+	std::string m_strDir;
+	size_t m_nRecordsPerSegment;
+	size_t m_nSegmentBytes;
+	uint64_t m_nReadPos;			// 下一条要读的记录的序号
+	uint64_t m_nWritePos;			// 下一条要写的记录的序号
+	uint64_t m_nCheckpointWritePos;	// 最近一次检查点的写位置，之后的数据还没有同步到磁盘
+	T* m_pWriteData;				// 正在写的段的映射，nullptr表示没有映射
+	uint64_t m_nWriteSegment;
+	const T* m_pReadData;			// 正在读的段的映射，nullptr表示没有映射
+	uint64_t m_nReadSegment;
+	std::vector<std::string> m_vecSpareFiles;
+	unsigned m_nNextSpareId;
+};
+
+/*******************    磁盘队列的实现        *****************/
+template <typename T>
+disk_queue<T>::disk_queue(const std::string& strDir, size_t nSegmentBytes)
+	: m_strDir(strDir), m_nRecordsPerSegment(nSegmentBytes / sizeof(T)),
+	m_nSegmentBytes(m_nRecordsPerSegment * sizeof(T)), m_nReadPos(0), m_nWritePos(0),
+	m_nCheckpointWritePos(0), m_pWriteData(nullptr), m_nWriteSegment(0), m_pReadData(nullptr),
+	m_nReadSegment(0), m_nNextSpareId(0)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "disk_queue的记录必须是可以平凡复制的类型");
+	if (m_nRecordsPerSegment == 0)
+		throw std::invalid_argument("参数不合法！");
+	if (::mkdir(m_strDir.c_str(), 0755) != 0 && errno != EEXIST)
+		ThrowError("创建目录失败：" + m_strDir);
+	Recover();
+}
+
+template <typename T>
+disk_queue<T>::~disk_queue()
+{
+	try
+	{
+		checkpoint();
+	}
+	catch (std::exception& _error)
+	{
+		std::cerr << _error.what() << std::endl;
+	}
+	CloseWriteSegment();
+	CloseReadSegment();
+}
+
+template <typename T>
+void disk_queue<T>::enqueue(const T& value)
+{
+	enqueue(&value, 1);
+}
+
+template <typename T>
+void disk_queue<T>::enqueue(const T* pValues, size_t nCount)
+{
+	while (nCount > 0)
+	{
+		uint64_t _nSegment = m_nWritePos / m_nRecordsPerSegment;
+		if (m_pWriteData == nullptr || _nSegment != m_nWriteSegment)
+			OpenWriteSegment(_nSegment);
+
+		size_t _nOffset = m_nWritePos % m_nRecordsPerSegment;
+		size_t _nCount = std::min(nCount, m_nRecordsPerSegment - _nOffset);
+		std::memcpy(m_pWriteData + _nOffset, pValues, _nCount * sizeof(T));
+		m_nWritePos += _nCount;
+		pValues += _nCount;
+		nCount -= _nCount;
+	}
+}
+
+template <typename T>
+const T* disk_queue<T>::peek(size_t& nCount)
+{
+	nCount = 0;
+	if (m_nReadPos == m_nWritePos)
+		return nullptr;
+
+	uint64_t _nSegment = m_nReadPos / m_nRecordsPerSegment;
+	if (m_pReadData == nullptr || _nSegment != m_nReadSegment)
+		OpenReadSegment(_nSegment);
+
+	size_t _nOffset = m_nReadPos % m_nRecordsPerSegment;
+	nCount = static_cast<size_t>(std::min<uint64_t>(m_nWritePos - m_nReadPos, m_nRecordsPerSegment - _nOffset));
+	return m_pReadData + _nOffset;
+}
+
+// 读完一个段之后马上解除映射并回收段文件。回收之前先写检查点，否则崩溃之后检查点中的读位置
+// 可能还在已经回收的段中。
+template <typename T>
+void disk_queue<T>::consume(size_t nCount)
+{
+	if (nCount > m_nWritePos - m_nReadPos)
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+
+	uint64_t _nOldSegment = m_nReadPos / m_nRecordsPerSegment;
+	m_nReadPos += nCount;
+	uint64_t _nNewSegment = m_nReadPos / m_nRecordsPerSegment;
+	if (_nNewSegment != _nOldSegment)
+	{
+		CloseReadSegment();
+		checkpoint();
+		for (uint64_t _nSegment = _nOldSegment; _nSegment < _nNewSegment; ++_nSegment)
+			RecycleSegment(_nSegment);
+	}
+}
+
+template <typename T>
+bool disk_queue<T>::dequeue(T& value)
+{
+	size_t _nCount = 0;
+	const T* _pRecord = peek(_nCount);
+	if (_pRecord == nullptr)
+		return false;
+	value = *_pRecord;
+	consume(1);
+	return true;
+}
+
+template <typename T>
+void disk_queue<T>::checkpoint()
+{
+	SyncWriteSegment();
+	WriteCheckpoint();
+}
+
+template <typename T>
+uint64_t disk_queue<T>::size() const
+{
+	return m_nWritePos - m_nReadPos;
+}
+
+template <typename T>
+bool disk_queue<T>::empty() const
+{
+	return m_nWritePos == m_nReadPos;
+}
+
+template <typename T>
+size_t disk_queue<T>::mapped_segments() const
+{
+	return (m_pWriteData != nullptr ? 1 : 0) + (m_pReadData != nullptr ? 1 : 0);
+}
+
+// 读出检查点，检查点之外的段文件作为备用文件或者删除。已有的备用文件原样保留，新的备用文件从
+// 已有的最大编号之后开始编号，不会覆盖已有的备用文件。
+template <typename T>
+void disk_queue<T>::Recover()
+{
+	std::string _strPath = m_strDir + "/checkpoint";
+	FILE* _pFile = std::fopen(_strPath.c_str(), "rb");
+	if (_pFile != nullptr)
+	{
+		Checkpoint _checkpoint;
+		bool _bValid = std::fread(&_checkpoint, sizeof(_checkpoint), 1, _pFile) == 1
+			&& _checkpoint.m_nMagic == s_nMagic && _checkpoint.m_nChecksum == Checksum(_checkpoint)
+			&& _checkpoint.m_nReadPos <= _checkpoint.m_nWritePos;
+		std::fclose(_pFile);
+		if (!_bValid)
+			throw std::runtime_error("检查点文件已损坏：" + _strPath);
+		if (_checkpoint.m_nRecordSize != sizeof(T) || _checkpoint.m_nRecordsPerSegment != m_nRecordsPerSegment)
+			throw std::invalid_argument("检查点中的记录大小或段大小与参数不一致：" + _strPath);
+		m_nReadPos = _checkpoint.m_nReadPos;
+		m_nWritePos = m_nCheckpointWritePos = _checkpoint.m_nWritePos;
+	}
+
+	uint64_t _nFirstSegment = m_nReadPos / m_nRecordsPerSegment;
+	uint64_t _nLastSegment = m_nWritePos / m_nRecordsPerSegment;
+	DIR* _pDir = ::opendir(m_strDir.c_str());
+	if (_pDir == nullptr)
+		ThrowError("打开目录失败：" + m_strDir);
+	std::vector<std::string> _vecUnused;
+	while (struct dirent* _pEntry = ::readdir(_pDir))
+	{
+		std::string _strName = _pEntry->d_name;
+		if (_strName.compare(0, 8, "segment-") == 0)
+		{
+			uint64_t _nSegment = std::strtoull(_strName.c_str() + 8, nullptr, 16);
+			if (_nSegment < _nFirstSegment || _nSegment > _nLastSegment)
+				_vecUnused.push_back(m_strDir + "/" + _strName);
+		}
+		else if (_strName.compare(0, 6, "spare-") == 0)
+		{
+			unsigned _nId = static_cast<unsigned>(std::strtoul(_strName.c_str() + 6, nullptr, 10));
+			m_nNextSpareId = std::max(m_nNextSpareId, _nId + 1);
+			if (m_vecSpareFiles.size() < s_nMaxSpareFiles)
+				m_vecSpareFiles.push_back(m_strDir + "/" + _strName);
+			else
+				_vecUnused.push_back(m_strDir + "/" + _strName);
+		}
+	}
+	::closedir(_pDir);
+
+	for (size_t i = 0; i < _vecUnused.size(); ++i)
+	{
+		if (m_vecSpareFiles.size() < s_nMaxSpareFiles)
+		{
+			std::string _strSpare = SparePath(m_nNextSpareId++);
+			if (::rename(_vecUnused[i].c_str(), _strSpare.c_str()) == 0)
+			{
+				m_vecSpareFiles.push_back(_strSpare);
+				continue;
+			}
+		}
+		::unlink(_vecUnused[i].c_str());
+	}
+}
+
+// 写位置在段的开头时是一个新的段，优先把备用文件改名使用; 否则是恢复之后继续写一个已有的段
+template <typename T>
+void disk_queue<T>::OpenWriteSegment(uint64_t nSegment)
+{
+	bool _bFull = m_pWriteData != nullptr;
+	CloseWriteSegment();
+	if (_bFull)
+		WriteCheckpoint();		// 上一个段已经在CloseWriteSegment()中同步到磁盘
+
+	std::string _strPath = SegmentPath(nSegment);
+	if (m_nWritePos % m_nRecordsPerSegment == 0 && !m_vecSpareFiles.empty())
+	{
+		if (::rename(m_vecSpareFiles.back().c_str(), _strPath.c_str()) != 0)
+			ThrowError("备用文件改名失败：" + m_vecSpareFiles.back());
+		m_vecSpareFiles.pop_back();
+	}
+	m_pWriteData = static_cast<T*>(MapFile(_strPath, PROT_READ | PROT_WRITE));
+	m_nWriteSegment = nSegment;
+}
+
+template <typename T>
+void disk_queue<T>::CloseWriteSegment()
+{
+	if (m_pWriteData == nullptr)
+		return;
+	SyncWriteSegment();
+	::munmap(m_pWriteData, m_nSegmentBytes);
+	m_pWriteData = nullptr;
+}
+
+template <typename T>
+void disk_queue<T>::OpenReadSegment(uint64_t nSegment)
+{
+	CloseReadSegment();
+	m_pReadData = static_cast<const T*>(MapFile(SegmentPath(nSegment), PROT_READ));
+	m_nReadSegment = nSegment;
+	::madvise(const_cast<T*>(m_pReadData), m_nSegmentBytes, MADV_SEQUENTIAL);
+}
+
+template <typename T>
+void disk_queue<T>::CloseReadSegment()
+{
+	if (m_pReadData == nullptr)
+		return;
+	::munmap(const_cast<T*>(m_pReadData), m_nSegmentBytes);
+	m_pReadData = nullptr;
+}
+
+// 写的一方可能还映射着这个段(写满了但是还没有换到下一个段), 改名不影响已有的映射
+template <typename T>
+void disk_queue<T>::RecycleSegment(uint64_t nSegment)
+{
+	std::string _strPath = SegmentPath(nSegment);
+	if (m_vecSpareFiles.size() < s_nMaxSpareFiles)
+	{
+		std::string _strSpare = SparePath(m_nNextSpareId++);
+		if (::rename(_strPath.c_str(), _strSpare.c_str()) == 0)
+		{
+			m_vecSpareFiles.push_back(_strSpare);
+			return;
+		}
+	}
+	::unlink(_strPath.c_str());
+}
+
+template <typename T>
+void* disk_queue<T>::MapFile(const std::string& strPath, int nProt)
+{
+	int _nFlags = (nProt & PROT_WRITE) ? O_RDWR | O_CREAT : O_RDONLY;
+	int _fd = ::open(strPath.c_str(), _nFlags, 0644);
+	if (_fd < 0)
+		ThrowError("打开段文件失败：" + strPath);
+	if ((nProt & PROT_WRITE) && ::ftruncate(_fd, m_nSegmentBytes) != 0)
+	{
+		::close(_fd);
+		ThrowError("设置段文件的大小失败：" + strPath);
+	}
+	void* _pData = ::mmap(nullptr, m_nSegmentBytes, nProt, MAP_SHARED, _fd, 0);
+	::close(_fd);		// 映射建立之后文件描述符就不需要了
+	if (_pData == MAP_FAILED)
+		ThrowError("映射段文件失败：" + strPath);
+	return _pData;
+}
+
+// 只同步上次检查点之后写入的部分
+template <typename T>
+void disk_queue<T>::SyncWriteSegment()
+{
+	if (m_pWriteData == nullptr || m_nCheckpointWritePos == m_nWritePos)
+		return;
+	uint64_t _nSegmentStart = m_nWriteSegment * m_nRecordsPerSegment;
+	uint64_t _nFrom = std::max(m_nCheckpointWritePos, _nSegmentStart) - _nSegmentStart;
+	size_t _nPageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+	size_t _nBegin = _nFrom * sizeof(T) / _nPageSize * _nPageSize;
+	size_t _nEnd = (m_nWritePos - _nSegmentStart) * sizeof(T);
+	if (::msync(reinterpret_cast<char*>(m_pWriteData) + _nBegin, _nEnd - _nBegin, MS_SYNC) != 0)
+		ThrowError("同步段文件失败");
+}
+
+template <typename T>
+void disk_queue<T>::WriteCheckpoint()
+{
+	Checkpoint _checkpoint;
+	_checkpoint.m_nMagic = s_nMagic;
+	_checkpoint.m_nRecordSize = sizeof(T);
+	_checkpoint.m_nRecordsPerSegment = m_nRecordsPerSegment;
+	_checkpoint.m_nReadPos = m_nReadPos;
+	_checkpoint.m_nWritePos = m_nWritePos;
+	_checkpoint.m_nChecksum = Checksum(_checkpoint);
+
+	std::string _strTemp = m_strDir + "/checkpoint.tmp";
+	int _fd = ::open(_strTemp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (_fd < 0)
+		ThrowError("打开检查点文件失败：" + _strTemp);
+	bool _bOk = ::write(_fd, &_checkpoint, sizeof(_checkpoint)) == static_cast<ssize_t>(sizeof(_checkpoint))
+		&& ::fsync(_fd) == 0;
+	::close(_fd);
+	if (!_bOk || ::rename(_strTemp.c_str(), (m_strDir + "/checkpoint").c_str()) != 0)
+		ThrowError("写检查点文件失败：" + _strTemp);
+	m_nCheckpointWritePos = m_nWritePos;
+}
+
+template <typename T>
+std::string disk_queue<T>::SegmentPath(uint64_t nSegment) const
+{
+	char _szName[32];
+	std::snprintf(_szName, sizeof(_szName), "/segment-%016llx", static_cast<unsigned long long>(nSegment));
+	return m_strDir + _szName;
+}
+
+template <typename T>
+std::string disk_queue<T>::SparePath(unsigned nId) const
+{
+	return m_strDir + "/spare-" + std::to_string(nId);
+}
+
+// FNV-1a, 只用于发现被截断或者写坏的检查点
+template <typename T>
+uint64_t disk_queue<T>::Checksum(const Checkpoint& checkpoint)
+{
+	const unsigned char* _pBytes = reinterpret_cast<const unsigned char*>(&checkpoint);
+	uint64_t _nHash = 14695981039346656037ULL;
+	for (size_t i = 0; i < offsetof(Checkpoint, m_nChecksum); ++i)
+		_nHash = (_nHash ^ _pBytes[i]) * 1099511628211ULL;
+	return _nHash;
+}
+
+template <typename T>
+void disk_queue<T>::ThrowError(const std::string& strWhat)
+{
+	throw std::runtime_error(strWhat + ": " + std::strerror(errno));
+}
+
+/**********************    测试程序     *************************/
+struct Record
+{
+	uint64_t m_nId;
+	uint64_t m_nTimestamp;
+	char m_payload[48];
+};
+
+static void RemoveQueueDir(const std::string& strDir_)
+{
+	DIR* _pDir = ::opendir(strDir_.c_str());
+	if (_pDir == nullptr)
+		return;
+	while (struct dirent* _pEntry = ::readdir(_pDir))
+	{
+		std::string _strName = _pEntry->d_name;
+		if (_strName != "." && _strName != "..")
+			::unlink((strDir_ + "/" + _strName).c_str());
+	}
+	::closedir(_pDir);
+	::rmdir(strDir_.c_str());
+}
+
+// 在目录中创建空文件，模拟上一次运行留下的段文件与备用文件
+static void CreateFiles(const std::string& strDir_, const char* names_[], size_t nCount_)
+{
+	::mkdir(strDir_.c_str(), 0755);
+	for (size_t i = 0; i < nCount_; ++i)
+		::close(::open((strDir_ + "/" + names_[i]).c_str(), O_WRONLY | O_CREAT, 0644));
+}
+
+static long MaxRssMB()
+{
+	struct rusage _usage;
+	::getrusage(RUSAGE_SELF, &_usage);
+	return _usage.ru_maxrss / 1024;
+}
+
+int main(int argc, char* argv[])
+{
+	std::string _strDir = argc > 1 ? argv[1] : "/tmp/disk_queue_demo";
+	RemoveQueueDir(_strDir);
+
+	// 崩溃恢复：子进程入队10条，取走3条之后写检查点，再入队5条、取走2条，然后不析构直接退出
+	pid_t _pid = ::fork();
+	if (_pid == 0)
+	{
+		disk_queue<uint64_t>* _pQueue = new disk_queue<uint64_t>(_strDir, 4096);
+		for (uint64_t i = 0; i < 10; ++i)
+			_pQueue->enqueue(i);
+		uint64_t _nValue = 0;
+		for (int i = 0; i < 3; ++i)
+			_pQueue->dequeue(_nValue);
+		_pQueue->checkpoint();
+		for (uint64_t i = 10; i < 15; ++i)
+			_pQueue->enqueue(i);
+		_pQueue->dequeue(_nValue);
+		_pQueue->dequeue(_nValue);
+		::_exit(0);
+	}
+	::waitpid(_pid, nullptr, 0);
+	{
+		disk_queue<uint64_t> _queue(_strDir, 4096);
+		std::cout << "崩溃之后恢复到检查点，队列中有" << _queue.size() << "条记录：";
+		uint64_t _nValue = 0;
+		while (_queue.dequeue(_nValue))
+			std::cout << _nValue << " ";
+		std::cout << std::endl << std::endl;
+	}
+	RemoveQueueDir(_strDir);
+
+	// 恢复时目录中已有备用文件：新的备用文件不能覆盖它们，之后写满三个段要用到两个备用文件
+	const char* _leftovers[][2] = {{"spare-2", "spare-0"}, {"segment-000000000000000c", "spare-0"}};
+	for (size_t k = 0; k < sizeof(_leftovers) / sizeof(_leftovers[0]); ++k)
+	{
+		CreateFiles(_strDir, _leftovers[k], 2);
+		try
+		{
+			disk_queue<uint64_t> _queue(_strDir, 4096);
+			for (uint64_t i = 0; i < 3 * 4096 / sizeof(uint64_t); ++i)
+				_queue.enqueue(i);
+			std::cout << "目录中已有" << _leftovers[k][0] << "与" << _leftovers[k][1] << ", 恢复之后写入"
+				<< _queue.size() << "条记录" << std::endl;
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << "目录中已有" << _leftovers[k][0] << "与" << _leftovers[k][1] << ", 错误：" << e.what() << std::endl;
+		}
+		RemoveQueueDir(_strDir);
+	}
+	std::cout << std::endl;
+
+	// 吞吐量与内存：先积压全部记录，再全部读出。参数可以指定写入的总大小(MB), 默认为512MB
+	size_t _nTotalMB = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 512;
+	const size_t _nSegmentMB = 16;
+	uint64_t _nRecords = static_cast<uint64_t>(_nTotalMB) * (1 << 20) / sizeof(Record);
+	{
+		disk_queue<Record> _queue(_strDir, _nSegmentMB << 20);
+		Record _batch[256];
+		std::memset(_batch, 'x', sizeof(_batch));
+
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		for (uint64_t i = 0; i < _nRecords; i += 256)
+		{
+			size_t _nCount = static_cast<size_t>(std::min<uint64_t>(256, _nRecords - i));
+			for (size_t j = 0; j < _nCount; ++j)
+				_batch[j].m_nId = i + j;
+			_queue.enqueue(_batch, _nCount);
+		}
+		_queue.checkpoint();
+		std::chrono::duration<double> _writeSeconds = std::chrono::steady_clock::now() - _start;
+		std::cout << "积压" << _nTotalMB << "MB(" << _nRecords << "条记录，每段" << _nSegmentMB << "MB): 写入"
+			<< _nTotalMB / _writeSeconds.count() << "MB/s, 进程的最大RSS为" << MaxRssMB() << "MB" << std::endl;
+
+		_start = std::chrono::steady_clock::now();
+		uint64_t _nExpected = 0;
+		bool _bInOrder = true;
+		size_t _nCount = 0;
+		while (const Record* _pRecords = _queue.peek(_nCount))
+		{
+			for (size_t i = 0; i < _nCount; ++i)
+				_bInOrder &= _pRecords[i].m_nId == _nExpected++;
+			_queue.consume(_nCount);
+		}
+		std::chrono::duration<double> _readSeconds = std::chrono::steady_clock::now() - _start;
+		std::cout << "零拷贝读出：" << _nTotalMB / _readSeconds.count() << "MB/s, 进程的最大RSS为" << MaxRssMB()
+			<< "MB, 记录" << (_bInOrder && _nExpected == _nRecords ? "完整有序" : "不一致！") << std::endl;
+	}
+	RemoveQueueDir(_strDir);
+	return 0;
+}
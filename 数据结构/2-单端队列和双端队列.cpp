@@ -15,8 +15,15 @@
 *   Github: https://github.com/yinheyi
 *   
 ***********************************************************************/
+#include "queue.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
 /*******************    队列的简单介绍    ************************/
 // 1. 队列是实现一种先进先出的策略，本来队列就是在一端进一端出的数据对构，即单端队列。在
@@ -52,276 +59,32 @@
 //        当队列为空时，有head == tail && m_bEmpty==true;
 //        当队列为满时，有head == tail && m_bEmpty!=true
 // 我个人更倾向于方案一，简洁，不需要添加多余的变量. 下面队列的实现采用方案一。
+// 5. 上面的方案每次入队出队都要计算一次取模(%), 也就是一次整数除法。如果数组的长度为2的幂，
+// 取模就可以换成与运算：i % N == i & (N - 1). 更进一步，head与tail可以一直增加而不回绕，使用
+// 时再与(N - 1)进行与运算得到下标，此时：
+//        队列中元素的个数为 tail - head (无符号数相减，即使tail溢出回绕了结果也是正确的)
+//        当队列为空时，有head == tail
+//        当队列为满时，有tail - head == N
+// 这样长度为N的数组可以存放N个元素。ring_queue就是这样实现的，它还支持一次入队/出队多个元素,
+// 因为数组是环形的，一批元素最多被分为两段连续的内存，每段只需要一次memcpy. 构造时可以指定
+// 为可增长的，队列满时容量扩大为原来的两倍，否则入队失败时返回false, 不输出错误信息。
+// 6. 队列的定义与实现在queue.h中，其它程序(例如多线程的队列)也可以使用它们。
+// 7. 上面的deque容量是固定的，也不能按下标访问。block_deque与stl中的deque类似：元素存放在一个个
+// 固定大小的内存块中(块的大小由模板参数指定，必须是2的幂), 另外用一个环形数组(map)记录内存块的
+// 指针。第i个元素在第(offset + i) / BlockSize个内存块中，所以按下标访问是O(1)的。两端入队时最多
+// 申请一个内存块，map满时只把内存块的指针复制到两倍大小的map中，已经入队的元素从来不会被复制
+// 或移动，指向它们的指针在出队之前一直有效。出队空出来的内存块保留一个作为备用，像滑动窗口
+// 这样一端入队另一端出队时就不会反复地申请释放内存。它还提供了迭代器，可以用于范围for循环。
+// 8. 编译时加上-DQUEUE_STATS, queue与deque会在一个与元素数组平行的数组中记录每个元素的入队时间，
+// 出队时把停留的时间记入直方图(queue_stats.h), 同时统计队列长度的最大值、队满时入队与队空时出队
+// 的次数。stats().snapshot()可以在其它线程中随时读取，不需要加锁。开启之后每个元素入队与出队时
+// 各要读一次时钟; 不加这个选项时没有任何额外的代码与内存，下面的测试会输出sizeof(queue<int>).
+// 9. front()返回元素的副本，元素很大时先复制出来再出队，内存的读写量就翻倍了。queue、deque与
+// ring_queue都提供了不复制元素的接口：peek()返回队内所有元素所在的区间，因为数组是环形的，最多
+// 分为两段连续的内存(queue_spans的first与second), 可以直接在队列中处理(例如向量化地计算，或者
+// 把两段内存作为两个iovec直接交给writev), 处理完之后用release(n)让前n个元素出队; 生产者用
+// reserve(n)得到队尾之后最多n个空位置(同样最多两段), 直接在其中写入元素，再用commit(n)让它们入队。
 //
-/*******************    基于数组来实现单端队列        *****************/
-template <typename T>
-class queue
-{
-public:
-	queue();
-	queue(size_t nCapicity);
-	~queue();
-	void enqueue(const T& value);		// 入队
-	void dequeue();						// 出队
-	T front() const;					// 获取队首元素
-	size_t size() const;				// 队内元素的个数
-	size_t capicity() const;			// 队容量大小
-	bool empty() const;					// 队是否为满
-	bool full() const;					// 队是否为空
-
-private:
-	size_t m_nArrayLength;				// 底层数组的长度
-	size_t m_nHead;						// 队首元素的下标
-	size_t m_nTail;						// 队尾元素的下一个位置的下标，即指向一个为空的位置
-	T* m_pArray;
-};
-
-template <typename T>
-queue<T>::queue()
-{
-	m_nArrayLength = 1001;
-	m_nHead = 0;
-	m_nTail = 0;
-	m_pArray = new T[m_nArrayLength];
-}
-
-template <typename T>
-queue<T>::queue(size_t capicity)
-{
-	m_nArrayLength = capicity + 1;
-	m_nHead = 0;
-	m_nTail = 0;
-	m_pArray = new T[m_nArrayLength];
-}
-
-template <typename T>
-queue<T>::~queue()
-{
-	m_pArray = nullptr;
-}
-
-template <typename T>
-void queue<T>::enqueue(const T& value)
-{
-	// 队列为满判断
-	if ((m_nTail + 1) % m_nArrayLength == m_nHead)
-	{
-		std::cerr << "队列为满，入队失败" << std::endl;
-		return;
-	}
-
-	m_pArray[m_nTail] = value;
-	m_nTail = (m_nTail + 1) % m_nArrayLength;
-}
-
-template <typename T>
-void queue<T>::dequeue()
-{
-	// 队列的空判断
-	if (m_nHead == m_nTail)
-	{
-		std::cerr << "队列为空，出队失败" << std::endl;
-		return;
-	}
-
-	m_nHead = (m_nHead + 1) % m_nArrayLength;
-}
-
-template <typename T>
-T queue<T>::front() const
-{
-	// 队列为空判断
-	if (m_nHead == m_nTail)
-	{
-		throw std::out_of_range("队列为空，不存在队首的元素。");
-	}
-
-	return m_pArray[m_nHead];
-}
-
-template <typename T>
-size_t queue<T>::size() const
-{
-	if (m_nHead <= m_nTail)
-		return m_nTail - m_nHead;
-	else
-		return m_nTail + m_nArrayLength - m_nHead;
-}
-
-template <typename T>
-size_t queue<T>::capicity() const
-{
-	return m_nArrayLength - 1;
-}
-
-template <typename T>
-bool queue<T>::empty() const
-{
-	return m_nHead == m_nTail;
-}
-
-template <typename T>
-bool queue<T>::full() const
-{
-	return (m_nTail + 1) % m_nArrayLength == m_nHead;
-}
-
-/*******************    基于数组来实现双端队列        *****************/
-template <typename T>
-class deque
-{
-public:
-	deque();
-	deque(size_t nCapicity);
-	~deque();
-	void push_front(const T& value);	// 队首入队
-	void pop_front();		  	  		// 队首出队
-	T front() const;		  	  		// 队首元素
-	void push_back(const T& value);		// 队尾入队
-	void pop_back();		  	  		// 队尾出队
-	T back() const;			  	  		// 队尾元素
-	size_t size() const;	 		  	// 队内元素的个数
-	size_t capicity() const;			// 队容量大小
-	bool empty()const;					// 队是否为满
-	bool full() const;					// 队是否为空
-                                                                                         
-private:                                                                                 
-	size_t m_nArrayLength;          // 底层数组的长度
-	size_t m_nHead;                 // 队首元素的下标
-	size_t m_nTail;                 // 队尾元素的下一个位置的下标，即指向一个为空的位置
-	T* m_pArray;
-};
-
-template <typename T>
-deque<T>::deque()
-{
-	m_nArrayLength = 1001;
-	m_nHead = 0;
-	m_nTail = 0;
-	m_pArray = new T[m_nArrayLength];
-}
-
-template <typename T>
-deque<T>::deque(size_t capicity)
-{
-	m_nArrayLength = capicity + 1;
-	m_nHead = 0;
-	m_nTail = 0;
-	m_pArray = new T[m_nArrayLength];
-}
-
-template <typename T>
-deque<T>::~deque()
-{
-	m_pArray = nullptr;
-}
-
-template <typename T>
-void deque<T>::push_front(const T& value)
-{
-	// 队列为满判断
-	if ((m_nTail + 1) % m_nArrayLength == m_nHead)
-	{
-		std::cerr << "队列为满，本次在队首入队失败" << std::endl;
-		return;
-	}
-
-	m_nHead = (m_nHead  + m_nArrayLength - 1) % m_nArrayLength;
-	m_pArray[m_nHead] = value;
-}
-
-template <typename T>
-void deque<T>::pop_front()
-{
-	// 队列为空判断
-	if (m_nHead == m_nTail)
-	{
-		std::cerr << "队列为空，本次在队首出队失败。" << std::endl;
-		return;
-	}
-
-	m_nHead = (m_nHead + 1) % m_nArrayLength;
-}
-
-template <typename T>
-T deque<T>::front() const
-{
-	// 队列为空时，抛出异常
-	if (m_nHead == m_nTail)
-	{
-		throw std::out_of_range("队列为空，不存在队首元素");
-	}
-
-	return m_pArray[m_nHead];
-}
-
-template <typename T>
-void deque<T>::push_back(const T& value)
-{
-	// 队列为满判断
-	if ((m_nTail + 1) % m_nArrayLength == m_nHead)
-	{
-		std::cerr << "队列为满，本次在队尾入队失败" << std::endl;
-		return;
-	}
-
-	m_pArray[m_nTail] = value;
-	m_nTail = (m_nTail + 1) % m_nArrayLength;
-}
-
-template <typename T>
-void deque<T>::pop_back()
-{
-	// 队列为空判断
-	if (m_nHead == m_nTail)
-	{
-		std::cerr << "队列为空，本次在队尾出队失败。" << std::endl;
-		return;
-	}
-
-	m_nTail = (m_nTail + m_nArrayLength - 1) % m_nArrayLength;
-}
-
-template <typename T>
-T deque<T>::back() const
-{
-	// 队列为空时，抛出异常
-	if (m_nHead == m_nTail)
-	{
-		throw std::out_of_range("队列为空，不存在队尾元素");
-	}
-
-	size_t _nIndex = (m_nTail + m_nArrayLength - 1) % m_nArrayLength;
-	return m_pArray[_nIndex];
-}
-
-template <typename T>
-size_t deque<T>::size() const
-{
-	if (m_nHead <= m_nTail)
-		return m_nTail - m_nHead;
-	else
-		return m_nTail + m_nArrayLength - m_nHead;
-}
-
-template <typename T>
-size_t deque<T>::capicity() const
-{
-	return m_nArrayLength - 1;
-}
-
-template <typename T>
-bool deque<T>::empty() const
-{
-	return m_nHead == m_nTail;
-}
-
-template <typename T>
-bool deque<T>::full() const
-{
-	return (m_nTail + 1) % m_nArrayLength == m_nHead;
-}
-
 /**********************    测试程序     *************************/
 int main(int argc, char* argv[])
 {
@@ -402,6 +165,254 @@ int main(int argc, char* argv[])
 		std::cout << _error.what() << std::endl;
 	}
 
+	// 环形队列的测试
+	std::cout << std::endl;
+	std::cout << "环形队列的测试输出结果：" << std::endl;
+	ring_queue<int> _ringQueue(5);
+	std::cout << "容量5向上取为2的幂：" << _ringQueue.capicity() << std::endl;
+	int _values[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+	_ringQueue.enqueue(_values, 6);
+	_ringQueue.dequeue();
+	_ringQueue.dequeue();
+	_ringQueue.dequeue();
+	std::cout << "批量入队10个元素，实际入队：" << _ringQueue.enqueue(_values, 10) << "个" << std::endl;
+	std::cout << "队列" << (_ringQueue.full() ? "为满" : "不满") << ", 再入队" << (_ringQueue.enqueue(10) ? "成功" : "失败") << std::endl;
+	int _outputs[10];
+	size_t _nOutput = _ringQueue.dequeue(_outputs, 10);
+	std::cout << "批量出队" << _nOutput << "个元素：";
+	for (size_t i = 0; i < _nOutput; ++i)
+		std::cout << _outputs[i] << " ";
+	std::cout << std::endl;
+
+	ring_queue<int> _growableQueue(2, true);
+	_growableQueue.enqueue(_values, 10);
+	_growableQueue.enqueue(10);
+	std::cout << "可增长的队列中有" << _growableQueue.size() << "个元素，容量为" << _growableQueue.capicity()
+		<< ", 队首元素为" << _growableQueue.front() << std::endl;
+
+	// 入队的元素引用队列自己的元素时，增长之前要先把它复制到新的数组中
+	ring_queue<std::string> _stringQueue(2, true);
+	_stringQueue.enqueue("first");
+	_stringQueue.enqueue("second");
+	_stringQueue.enqueue(_stringQueue.front());
+	queue_spans<std::string> _spans = _stringQueue.peek();
+	_stringQueue.enqueue(_spans.first.pData, _spans.first.nCount);
+	std::cout << "入队自己的元素之后：";
+	while (!_stringQueue.empty())
+	{
+		std::cout << _stringQueue.front() << " ";
+		_stringQueue.dequeue();
+	}
+	std::cout << std::endl;
+
+	// 统计信息的测试：生产者每次突发地入队0到40个元素，消费者每次出队16个元素
+	std::cout << std::endl;
+	std::cout << "sizeof(queue<int>) = " << sizeof(queue<int>) << std::endl;
+#ifdef QUEUE_STATS
+	{
+		queue<int> _statsQueue(32);
+		std::streambuf* _pOldBuf = std::cerr.rdbuf(nullptr);	// 不输出队满、队空的提示
+		srand(1);
+		for (int _nRound = 0; _nRound < 10000; ++_nRound)
+		{
+			int _nBurst = rand() % 41;
+			for (int i = 0; i < _nBurst; ++i)
+				_statsQueue.enqueue(i);
+			for (int i = 0; i < 16; ++i)
+				_statsQueue.dequeue();
+		}
+		std::cerr.rdbuf(_pOldBuf);
+
+		queue_stats_snapshot _snapshot = _statsQueue.stats().snapshot();
+		std::cout << "入队" << _snapshot.nEnqueues << "次，出队" << _snapshot.nDequeues << "次，队满"
+			<< _snapshot.nFullEvents << "次，队空" << _snapshot.nEmptyEvents << "次，当前长度" << _snapshot.nDepth
+			<< ", 最大长度" << _snapshot.nHighWater << std::endl;
+		std::cout << "停留时间(纳秒): p50=" << _snapshot.nP50 << ", p99=" << _snapshot.nP99 << ", p99.9="
+			<< _snapshot.nP999 << ", 最大值" << _snapshot.nMax << std::endl;
+	}
+#endif
+
+	// 不复制元素的读写
+	std::cout << std::endl;
+	std::cout << "不复制元素的读写：" << std::endl;
+	queue<int> _spanQueue(5);
+	for (int i = 0; i < 4; ++i)
+		_spanQueue.enqueue(i);
+	_spanQueue.release(3);
+	queue_spans<int> _writable = _spanQueue.reserve(10);
+	std::cout << "队尾之后有" << _writable.size() << "个空位置，分为" << _writable.first.nCount << "个和"
+		<< _writable.second.nCount << "个" << std::endl;
+	for (size_t i = 0; i < _writable.size(); ++i)
+		_writable[i] = static_cast<int>(10 + i);
+	_spanQueue.commit(_writable.size());
+	queue_spans<int> _readable = _spanQueue.peek();
+	std::cout << "提交之后队内的元素为：";
+	for (size_t i = 0; i < _readable.size(); ++i)
+		std::cout << _readable[i] << " ";
+	std::cout << "(第一段" << _readable.first.nCount << "个，第二段" << _readable.second.nCount << "个)" << std::endl;
+
+	// 256字节的记录通过队列：逐个复制入队、复制出队，与在队列中直接写入、直接处理对比
+	{
+		struct LargeRecord
+		{
+			uint64_t nId;
+			char payload[248];
+		};
+		const size_t _nRecords = 4000000;
+		queue<LargeRecord> _recordQueue(1023);
+		LargeRecord _record;
+		std::memset(&_record, 0, sizeof(_record));
+		uint64_t _nCopySum = 0;
+		uint64_t _nSpanSum = 0;
+
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		for (size_t _nDone = 0; _nDone < _nRecords; )
+		{
+			while (!_recordQueue.full())
+			{
+				_record.nId = _nDone++;
+				_recordQueue.enqueue(_record);
+			}
+			while (!_recordQueue.empty())
+			{
+				_nCopySum += _recordQueue.front().nId;
+				_recordQueue.dequeue();
+			}
+		}
+		std::chrono::duration<double> _copySeconds = std::chrono::steady_clock::now() - _start;
+
+		_start = std::chrono::steady_clock::now();
+		for (size_t _nDone = 0; _nDone < _nRecords; )
+		{
+			queue_spans<LargeRecord> _slots = _recordQueue.reserve(_recordQueue.capicity());
+			for (size_t i = 0; i < _slots.size(); ++i)
+				_slots[i].nId = _nDone++;
+			_recordQueue.commit(_slots.size());
+
+			queue_spans<LargeRecord> _items = _recordQueue.peek();
+			for (size_t i = 0; i < _items.first.nCount; ++i)
+				_nSpanSum += _items.first.pData[i].nId;
+			for (size_t i = 0; i < _items.second.nCount; ++i)
+				_nSpanSum += _items.second.pData[i].nId;
+			_recordQueue.release(_items.size());
+		}
+		std::chrono::duration<double> _spanSeconds = std::chrono::steady_clock::now() - _start;
+
+		std::cout << _nRecords << "条256字节的记录：复制入队出队用时" << _copySeconds.count() << "秒, 在队列中直接读写用时"
+			<< _spanSeconds.count() << "秒" << (_nCopySum == _nSpanSum ? "" : ", 结果不一致！") << std::endl;
+	}
+
+	// 分块的双端队列的测试
+	std::cout << std::endl;
+	std::cout << "分块的双端队列的测试输出结果：" << std::endl;
+	block_deque<int, 4> _blockDeque;
+	for (int i = 0; i < 5; ++i)
+	{
+		_blockDeque.push_back(i + 5);
+		_blockDeque.push_front(4 - i);
+	}
+	_blockDeque.push_back(10);
+	std::cout << "队列中有" << _blockDeque.size() << "个元素，占用" << _blockDeque.block_count() << "个内存块：";
+	for (int _nValue : _blockDeque)
+		std::cout << _nValue << " ";
+	std::cout << std::endl;
+
+	const int* _pFifth = &_blockDeque[5];
+	for (int i = 0; i < 1000; ++i)
+	{
+		_blockDeque.push_back(0);
+		_blockDeque.push_front(0);
+	}
+	std::cout << "两端各入队1000个元素之后，原来的第5个元素" << _blockDeque[1005] << "的地址"
+		<< (_pFifth == &_blockDeque[1005] ? "没有改变" : "改变了") << std::endl;
+	for (int i = 0; i < 1000; ++i)
+	{
+		_blockDeque.pop_back();
+		_blockDeque.pop_front();
+	}
+	_blockDeque.pop_front();
+	_blockDeque.pop_back();
+	std::cout << "两端各出队一个之后，队首为" << _blockDeque.front() << ", 队尾为" << _blockDeque.back() << std::endl;
+
+	// 滑动窗口：一千万个元素依次入队，窗口中保持一百万个元素，每次读取窗口中间的元素
+	{
+		const size_t _nItems = 10000000;
+		const size_t _nWindow = 1000000;
+		long long _nBlockSum = 0;
+		long long _nStdSum = 0;
+		block_deque<int> _window;
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < _nItems; ++i)
+		{
+			_window.push_back(static_cast<int>(i));
+			if (_window.size() > _nWindow)
+				_window.pop_front();
+			_nBlockSum += _window[_window.size() / 2];
+		}
+		std::chrono::duration<double> _blockSeconds = std::chrono::steady_clock::now() - _start;
+
+		std::deque<int> _stdWindow;
+		_start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < _nItems; ++i)
+		{
+			_stdWindow.push_back(static_cast<int>(i));
+			if (_stdWindow.size() > _nWindow)
+				_stdWindow.pop_front();
+			_nStdSum += _stdWindow[_stdWindow.size() / 2];
+		}
+		std::chrono::duration<double> _stdSeconds = std::chrono::steady_clock::now() - _start;
+
+		std::cout << _nItems << "个元素通过长度为" << _nWindow << "的滑动窗口：block_deque用时" << _blockSeconds.count()
+			<< "秒, std::deque用时" << _stdSeconds.count() << "秒" << (_nBlockSum == _nStdSum ? "" : ", 结果不一致！")
+			<< std::endl;
+	}
+	std::cout << std::endl;
+
+	// 吞吐量对比：每次入队一个元素出队一个元素，保持队列中有一半的元素。
+	// 容量由参数指定(默认为1024), 如果是编译时的常量，编译器会把取模优化为与运算，就看不出差别了。
+	const size_t _nMessages = 1 << 24;
+	size_t _nCapicity = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+	long long _nSum = 0;
+	queue<int> _moduloQueue(_nCapicity - 1);
+	ring_queue<int> _maskQueue(_nCapicity);
+	for (size_t i = 0; i < _nCapicity / 2; ++i)
+	{
+		_moduloQueue.enqueue(static_cast<int>(i));
+		_maskQueue.enqueue(static_cast<int>(i));
+	}
+
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < _nMessages; ++i)
+	{
+		_moduloQueue.enqueue(static_cast<int>(i));
+		_nSum += _moduloQueue.front();
+		_moduloQueue.dequeue();
+	}
+	std::chrono::duration<double> _moduloSeconds = std::chrono::steady_clock::now() - _start;
+
+	_start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < _nMessages; ++i)
+	{
+		_maskQueue.enqueue(static_cast<int>(i));
+		_nSum -= _maskQueue.front();
+		_maskQueue.dequeue();
+	}
+	std::chrono::duration<double> _maskSeconds = std::chrono::steady_clock::now() - _start;
+
+	_start = std::chrono::steady_clock::now();
+	int _batch[64];
+	for (size_t i = 0; i < _nMessages; i += 64)
+	{
+		for (int j = 0; j < 64; ++j)
+			_batch[j] = static_cast<int>(i + j);
+		_maskQueue.enqueue(_batch, 64);
+		_maskQueue.dequeue(_batch, 64);
+		_nSum += _batch[0];
+	}
+	std::chrono::duration<double> _batchSeconds = std::chrono::steady_clock::now() - _start;
+
+	std::cout << _nMessages << "个元素入队出队：取模的队列用时" << _moduloSeconds.count() << "秒, 2的幂的环形队列用时"
+		<< _maskSeconds.count() << "秒, 每批64个元素用时" << _batchSeconds.count() << "秒(" << _nSum % 2 << ")" << std::endl;
 
 	return 0;
 }
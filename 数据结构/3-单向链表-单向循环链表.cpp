@@ -15,7 +15,11 @@
 *   Github: https://github.com/yinheyi
 *   
 ***********************************************************************/
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include "list_sort.h"
+#include "node_pool.h"
 
 // 链表，没有什么好多说的，很常用的数据结构.
 // 在单向链表中，非循环的链表的最后一个节点的next指针为空;如果是循环链表，则最后一个节
@@ -35,6 +39,9 @@
 // 1. 单向链表适合在给定的节点之后进行插入或删除节点。
 // 2. 为了不处理特殊的头节点，使代码很简单, 使用一个哨兵节点来表示为空。
 // 3. 当链表为空时，存在一个哨兵节点，它的pNext 为空。
+// 4. 节点通过模板参数Alloc分配，默认是std::allocator, 与直接new/delete相同。频繁插入删除时可以
+// 使用node_pool.h中的pool_allocator: 节点从大块内存中连续地切出来，释放的节点挂在空闲链表上
+// 重复使用，不再每次都调用全局的内存分配器，遍历时相邻的节点大多也在相邻的内存中。
 /*******************    单向链表     ********************/
 // 单向链表节点的定义
 template <typename T>
@@ -58,7 +65,7 @@ Node<T>::Node(const T& value_, Node<T>* pNext_)
 	pNext = pNext_;
 }
 
-template <typename T>
+template <typename T, typename Alloc = std::allocator<T> >
 class forward_list
 {
 public:
@@ -69,44 +76,59 @@ public:
 	Node<T>* Head() const;							// 获得链表的头节点
 	bool empty() const;								// 判断链表是否为空
 	size_t size() const;							// 链表内元素的个数
+	void sort();									// 从小到大排序
+	template <typename Compare>
+	void sort(Compare comp_);						// 按给定的比较谓词排序
+	void merge(forward_list<T, Alloc>& other_);			// 合并另一个有序链表
+	template <typename Compare>
+	void merge(forward_list<T, Alloc>& other_, Compare comp_);
 
 private:
+	Node<T>* Detach(Node<T>*& pEnd_);				// 摘下所有节点
+	void Attach(Node<T>* pFirst_, Node<T>* pLast_, Node<T>* pEnd_);	// 挂回节点
+
+	// 用分配器分配并构造节点、析构并释放节点, 代替new/delete
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node<T> > NodeAllocator;
+	typedef std::allocator_traits<NodeAllocator> NodeTraits;
+	template <typename... Args>
+	Node<T>* CreateNode(const Args&... args_);
+	void DestroyNode(Node<T>* pNode_);
+
+	NodeAllocator m_allocator;
 	Node<T>* m_pHead;
 	size_t m_nSize;
 };
 
-template <typename T>
-forward_list<T>::forward_list()
-{
-	m_pHead = new Node<T>;
-	m_nSize = 0;
-}
-
-template <typename T>
-forward_list<T>::~forward_list()
+// 构造函数在后面"实现单向循环链表类"中定义。
+// 析构时从哨兵节点之后开始释放，遇到nullptr(非循环链表)或者回到哨兵节点(循环链表)时结束。
+template <typename T, typename Alloc>
+forward_list<T, Alloc>::~forward_list()
 {
-	while (m_pHead != nullptr)
+	Node<T>* _pNode = m_pHead->pNext;
+	while (_pNode != nullptr && _pNode != m_pHead)
 	{
-		Node<T>* _pTemp = m_pHead;
-		m_pHead = m_pHead->pNext;
-		delete _pTemp;
+		Node<T>* _pTemp = _pNode;
+		_pNode = _pNode->pNext;
+		DestroyNode(_pTemp);
 		_pTemp = nullptr;
 	}
+	DestroyNode(m_pHead);
+	m_pHead = nullptr;
 }
 
-template <typename T>
-void forward_list<T>::insert_after(Node<T>* pCurrent, const T& value)
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::insert_after(Node<T>* pCurrent, const T& value)
 {
 	if (nullptr == pCurrent)
 	{
 		std::cerr << "指针为空, 插入失败" << std::endl;
 	}
-	pCurrent->pNext = new Node<T>(value, pCurrent->pNext);
+	pCurrent->pNext = CreateNode(value, pCurrent->pNext);
 	++m_nSize;
 }
 
-template <typename T>
-void forward_list<T>::erase_after(Node<T>* pCurrent)
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::erase_after(Node<T>* pCurrent)
 {
 	if (nullptr == pCurrent)
 	{
@@ -115,51 +137,233 @@ void forward_list<T>::erase_after(Node<T>* pCurrent)
 
 	Node<T>* _pTemp = pCurrent->pNext;
 	pCurrent->pNext = _pTemp->pNext;
-	delete _pTemp;
+	DestroyNode(_pTemp);
 	_pTemp = nullptr;
 	--m_nSize;
 }
 
-template <typename T>
-Node<T>* forward_list<T>::Head() const
+// 分配节点的内存之后再在上面构造节点，构造时抛出异常要把内存还回去
+template <typename T, typename Alloc>
+template <typename... Args>
+Node<T>* forward_list<T, Alloc>::CreateNode(const Args&... args_)
+{
+	Node<T>* _pNode = NodeTraits::allocate(m_allocator, 1);
+	try
+	{
+		NodeTraits::construct(m_allocator, _pNode, args_...);
+	}
+	catch (...)
+	{
+		NodeTraits::deallocate(m_allocator, _pNode, 1);
+		throw;
+	}
+	return _pNode;
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::DestroyNode(Node<T>* pNode_)
+{
+	NodeTraits::destroy(m_allocator, pNode_);
+	NodeTraits::deallocate(m_allocator, pNode_, 1);
+}
+
+template <typename T, typename Alloc>
+Node<T>* forward_list<T, Alloc>::Head() const
 {
 	return m_pHead;
 }
 
-template <typename T>
-bool forward_list<T>::empty() const
+template <typename T, typename Alloc>
+bool forward_list<T, Alloc>::empty() const
 {
 	return 0 == m_nSize;
 }
 
-template <typename T>
-size_t forward_list<T>::size() const
+template <typename T, typename Alloc>
+size_t forward_list<T, Alloc>::size() const
 {
 	return m_nSize;
 }
 
+/********************    链表的归并排序    *************/
+// 对链表排序时，不需要把元素拷贝到数组中再拷贝回来，直接修改节点的pNext指针即可。这里使
+// 用自底向上的归并排序:
+//     第一趟：把链表看作n个长度为1的有序段，两两合并，得到长度为2的有序段;
+//     第二趟：两两合并长度为2的有序段，得到长度为4的有序段;
+//     ......直到有序段的长度不小于n为止。
+// 说明：1. 整个过程只是在摘下/挂上已有的节点，不new新节点，也不拷贝元素的值;
+//       2. 不使用递归，额外的空间为O(1), 时间复杂度为O(NlogN);
+//       3. 合并时相等的元素优先取前一段的，所以是稳定排序。
+//
+// 拆分与合并节点串的辅助函数SplitNodes/MergeNodes与双向链表共用，在list_sort.h中。
+//
+// 把所有节点从哨兵节点上摘下来，变成一个以nullptr结尾的节点串并返回第一个节点。
+// pEnd_返回原来最后一个节点的pNext值：非循环链表中为nullptr, 循环链表中为哨兵节点。
+template <typename T, typename Alloc>
+Node<T>* forward_list<T, Alloc>::Detach(Node<T>*& pEnd_)
+{
+	Node<T>* _pLast = m_pHead;
+	for (size_t i = 0; i < m_nSize; ++i)
+		_pLast = _pLast->pNext;
+
+	pEnd_ = _pLast->pNext;
+	_pLast->pNext = nullptr;
+
+	Node<T>* _pFirst = m_pHead->pNext;
+	m_pHead->pNext = pEnd_;
+	return m_nSize == 0 ? nullptr : _pFirst;
+}
+
+// 把以pFirst_开始以pLast_结束的节点串挂回到哨兵节点之后，最后一个节点指向pEnd_.
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::Attach(Node<T>* pFirst_, Node<T>* pLast_, Node<T>* pEnd_)
+{
+	if (pFirst_ == nullptr)
+	{
+		m_pHead->pNext = pEnd_;
+		return;
+	}
+
+	m_pHead->pNext = pFirst_;
+	pLast_->pNext = pEnd_;
+}
+
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::sort()
+{
+	sort(LessValue<T>);
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void forward_list<T, Alloc>::sort(Compare comp_)
+{
+	if (m_nSize < 2)
+		return;
+
+	Node<T>* _pEnd = nullptr;
+	Node<T>* _pFirst = Detach(_pEnd);
+	Node<T>* _pLast = nullptr;
+
+	// nWidth表示当前有序段的长度
+	for (size_t _nWidth = 1; _nWidth < m_nSize; _nWidth <<= 1)
+	{
+		Node<T> _dummy;
+		Node<T>* _pTail = &_dummy;		// 已合并部分的最后一个节点
+		Node<T>* _pCurrent = _pFirst;
+		while (_pCurrent != nullptr)
+		{
+			// 依次摘下两个长度为nWidth的有序段，合并后追加到已合并部分的尾部
+			Node<T>* _pLeft = _pCurrent;
+			Node<T>* _pRight = SplitNodes(_pLeft, _nWidth);
+			_pCurrent = SplitNodes(_pRight, _nWidth);
+
+			_pTail->pNext = MergeNodes(_pLeft, _pRight, comp_, _pLast);
+			_pTail = _pLast;
+		}
+		_pFirst = _dummy.pNext;
+	}
+
+	Attach(_pFirst, _pLast, _pEnd);
+}
+
+// 合并两个有序的链表, 合并完成之后other_为空。时间复杂度为O(N+M).
+// other_的节点直接挂到当前链表上，以后由当前链表的分配器释放，所以两个链表的分配器必须相等,
+// std::allocator与pool_allocator都没有状态，总是相等的。
+template <typename T, typename Alloc>
+void forward_list<T, Alloc>::merge(forward_list<T, Alloc>& other_)
+{
+	merge(other_, LessValue<T>);
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void forward_list<T, Alloc>::merge(forward_list<T, Alloc>& other_, Compare comp_)
+{
+	if (&other_ == this || other_.m_nSize == 0)
+		return;
+
+	Node<T>* _pEnd = nullptr;
+	Node<T>* _pOtherEnd = nullptr;
+	Node<T>* _pFirst = Detach(_pEnd);
+	Node<T>* _pOtherFirst = other_.Detach(_pOtherEnd);
+
+	Node<T>* _pLast = nullptr;
+	_pFirst = MergeNodes(_pFirst, _pOtherFirst, comp_, _pLast);
+	Attach(_pFirst, _pLast, _pEnd);
+
+	m_nSize += other_.m_nSize;
+	other_.m_nSize = 0;
+}
+
 /********************    实现单向循环链表类    *************/
 // 对于实现单向循环链表类的话，很简单，对上面的类只需要改动一处
-// 即可， 即把构造函数修改如下：
+// 即可， 即把构造函数修改如下(编译时定义CIRCULAR_LIST得到的就是循环链表)：
 //
+#ifndef CIRCULAR_LIST
 // 修改前：
-template <typename T>
-forward_list<T>::forward_list()
+template <typename T, typename Alloc>
+forward_list<T, Alloc>::forward_list()
 {
-	m_pHead = new Node<T>;
+	m_pHead = CreateNode();
 	m_nSize = 0;
 }
-
+#else
 // 修改后：
-template <typename T>
-forward_list<T>::forward_list()
+template <typename T, typename Alloc>
+forward_list<T, Alloc>::forward_list()
 {
-	m_pHead = new Node<T>;
+	m_pHead = CreateNode();
 	m_pHead->pNext = m_pHead;
 	m_nSize = 0;
 }
+#endif	// CIRCULAR_LIST
 
 /**********************    测试程序     *************************/
+// 是否到了链表的末尾：非循环链表的最后一个节点之后是nullptr, 循环链表的是哨兵节点
+static bool IsEnd(const Node<int>* pHead_, const Node<int>* pNode_)
+{
+	return pNode_ == nullptr || pNode_ == pHead_;
+}
+
+// 插入删除交替进行：每一轮删除一半的节点，再在剩下的每个节点之后插入一个新节点，最后遍历整个
+// 链表。返回遍历时所有元素的和，插入删除与遍历分别用的时间通过参数返回。
+template <typename Alloc>
+static long long ChurnBenchmark(size_t nSize_, int nRounds_, double& dChurnSeconds_, double& dTraverseSeconds_)
+{
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	forward_list<int, Alloc> _list;
+	Node<int>* _pHead = _list.Head();
+	for (size_t i = 0; i < nSize_; ++i)
+		_list.insert_after(_pHead, static_cast<int>(i));
+	for (int _nRound = 0; _nRound < nRounds_; ++_nRound)
+	{
+		for (Node<int>* _pNode = _pHead; !IsEnd(_pHead, _pNode->pNext); )
+		{
+			_list.erase_after(_pNode);
+			_pNode = _pNode->pNext;
+			if (IsEnd(_pHead, _pNode))
+				break;
+		}
+		for (Node<int>* _pNode = _pHead->pNext; !IsEnd(_pHead, _pNode); _pNode = _pNode->pNext->pNext)
+			_list.insert_after(_pNode, _nRound);
+	}
+	std::chrono::duration<double> _churnSeconds = std::chrono::steady_clock::now() - _start;
+
+	_start = std::chrono::steady_clock::now();
+	long long _nSum = 0;
+	for (int _nRound = 0; _nRound < nRounds_; ++_nRound)
+	{
+		for (Node<int>* _pNode = _pHead->pNext; !IsEnd(_pHead, _pNode); _pNode = _pNode->pNext)
+			_nSum += _pNode->value;
+	}
+	std::chrono::duration<double> _traverseSeconds = std::chrono::steady_clock::now() - _start;
+
+	dChurnSeconds_ = _churnSeconds.count();
+	dTraverseSeconds_ = _traverseSeconds.count();
+	return _nSum;
+}
+
 int main(int argc, char* argv[])
 {
 	forward_list<int> _slist;
@@ -178,6 +382,51 @@ int main(int argc, char* argv[])
 	std::cout << "链表是否为空：" << _slist.empty() << std::endl;
 	std::cout << "链表内元素个数为：" << _slist.size() << std::endl;
 
+	// 排序与合并的测试
+	forward_list<int> _slist1;
+	forward_list<int> _slist2;
+	int _array1[] = {5, -3, 9, 0, 5, 12, -7};
+	int _array2[] = {8, 1, -3, 20};
+	for (int i = 0; i < 7; ++i)
+		_slist1.insert_after(_slist1.Head(), _array1[i]);
+	for (int i = 0; i < 4; ++i)
+		_slist2.insert_after(_slist2.Head(), _array2[i]);
+	_slist1.sort();
+	_slist2.sort();
+	_slist1.merge(_slist2);
+	std::cout << "排序并合并之后的链表为：";
+	for (Node<int>* _pNode = _slist1.Head()->pNext; _pNode != nullptr && _pNode != _slist1.Head(); _pNode = _pNode->pNext)
+		std::cout << _pNode->value << " ";
+	std::cout << std::endl;
+	std::cout << "合并之后另一个链表的元素个数为：" << _slist2.size() << std::endl;
+
+	// 使用内存池：节点从内存池的chunk中连续地切出来，释放的节点重复使用
+	{
+		forward_list<int, pool_allocator<int> > _pooledList;
+		for (int i = 0; i < 1000; ++i)
+			_pooledList.insert_after(_pooledList.Head(), i);
+		for (int i = 0; i < 500; ++i)
+			_pooledList.erase_after(_pooledList.Head());
+		node_pool& _pool = pool_allocator<Node<int> >::pool();
+		std::cout << "内存池中已分配的节点个数为：" << _pool.in_use() << ", 可以容纳的节点个数为："
+			<< _pool.capicity() << ", chunk的个数为：" << _pool.chunk_count() << std::endl;
+	}
+
+	// 插入删除的性能对比：std::allocator、共享的内存池与线程局部的内存池
+	const size_t _nSize = 200000;
+	const int _nRounds = 20;
+	double _dChurn[3];
+	double _dTraverse[3];
+	long long _nSum = ChurnBenchmark<std::allocator<int> >(_nSize, _nRounds, _dChurn[0], _dTraverse[0]);
+	_nSum -= ChurnBenchmark<pool_allocator<int> >(_nSize, _nRounds, _dChurn[1], _dTraverse[1]);
+	_nSum -= ChurnBenchmark<pool_allocator<int, true> >(_nSize, _nRounds, _dChurn[2], _dTraverse[2]);
+	const char* _names[] = {"std::allocator", "共享的内存池", "线程局部的内存池"};
+	for (int i = 0; i < 3; ++i)
+	{
+		std::cout << _nSize << "个节点" << _nRounds << "轮插入删除：" << _names[i] << "用时" << _dChurn[i]
+			<< "秒, 遍历用时" << _dTraverse[i] << "秒(" << _nSum % 2 << ")" << std::endl;
+	}
+
 	return 0;
 }
 
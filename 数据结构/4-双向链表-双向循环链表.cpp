@@ -16,6 +16,10 @@
 *   
 ***********************************************************************/
 #include <iostream>
+#include <utility>
+#include <memory>
+#include "list_sort.h"
+#include "node_pool.h"
 
 
 // 1. 双向链表与单向链表相比， 增加了一个指向上一个上一个节点的指针，除此之外没有什么特别了。
@@ -30,6 +34,9 @@
 // 会分成三种情况：在链表首部/在链表中间/和链表尾部 进行插入与删除操作。为了不这么麻烦，我
 // 们可以增加一个哨兵结点，很代码很简洁，不需要区分三种情况了。
 //
+// 3. 节点通过模板参数Alloc分配，默认的std::allocator与直接new/delete相同。插入删除很频繁时可以
+// 使用node_pool.h中的pool_allocator, 节点从同一个内存池中分配，释放之后重复使用，与单向链表相同。
+//
 //
 // 双向链表节点的定义如下(模板类）：
 template <typename T>
@@ -60,7 +67,7 @@ Node<T>::Node(const T& value_, Node<T>* pPre_, Node<T>* pNext_)
 }
 
 /**********************    双向链表模版类的定义与实现      ***************/
-template <typename T>
+template <typename T, typename Alloc = std::allocator<T> >
 class list
 {
 public:
@@ -71,34 +78,49 @@ public:
 	Node<T>* Head() const;									// 返回链表头指针
 	bool empty() const;
 	size_t size() const;
+	void sort();											// 从小到大排序
+	template <typename Compare>
+	void sort(Compare comp_);								// 按给定的比较谓词排序
+	void merge(list<T, Alloc>& other_);							// 合并另一个有序链表
+	template <typename Compare>
+	void merge(list<T, Alloc>& other_, Compare comp_);
 
 private:
+	Node<T>* Detach(Node<T>*& pEnd_);						// 摘下所有节点
+	void Attach(Node<T>* pFirst_, Node<T>* pEnd_);			// 挂回节点并修正pPre指针
+
+	// 用分配器分配并构造节点、析构并释放节点, 代替new/delete
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node<T> > NodeAllocator;
+	typedef std::allocator_traits<NodeAllocator> NodeTraits;
+	template <typename... Args>
+	Node<T>* CreateNode(const Args&... args_);
+	void DestroyNode(Node<T>* pNode_);
+
+	NodeAllocator m_allocator;
 	Node<T>* m_pHead;
 	size_t m_nSize;
 };
 
-template <typename T>
-list<T>::list()
-{
-	// new出来一个哨兵节点
-	m_pHead = new Node<T>;
-	m_nSize = 0;
-}
-
-template <typename T>
-list<T>::~list()
+// 构造函数在后面"双向链表的循环链表的实现"中定义。
+// 析构时从哨兵节点之后开始释放，遇到nullptr(非循环链表)或者回到哨兵节点(循环链表)时结束。
+template <typename T, typename Alloc>
+list<T, Alloc>::~list()
 {
-	while (m_pHead != nullptr)
+	Node<T>* _pNode = m_pHead->pNext;
+	while (_pNode != nullptr && _pNode != m_pHead)
 	{
-		Node<T>* _pNext = m_pHead->pNext;
-		delete m_pHead;
-		m_pHead = _pNext;
+		Node<T>* _pNext = _pNode->pNext;
+		DestroyNode(_pNode);
+		_pNode = _pNext;
 	}
+	DestroyNode(m_pHead);
+	m_pHead = nullptr;
 }
 
-// 在给定结点之前插入一个节点
-template <typename T>
-void list<T>::insert(Node<T>* pCurrent_, const T& value_)
+// 在给定结点之前插入一个节点。在哨兵节点之前插入表示插入到链表的末尾：循环链表中哨兵节点的
+// pPre就是最后一个节点; 非循环链表中哨兵节点没有前驱，需要先沿pNext找到最后一个节点, 为O(n).
+template <typename T, typename Alloc>
+void list<T, Alloc>::insert(Node<T>* pCurrent_, const T& value_)
 {
 	if (nullptr == pCurrent_)
 	{
@@ -106,8 +128,18 @@ void list<T>::insert(Node<T>* pCurrent_, const T& value_)
 		return;
 	}
 
-	// 新new并初始化一个结点
-	Node<T>* _pNew = new Node<T>(value_, pCurrent_->pPre, pCurrent_);
+	if (pCurrent_ == m_pHead && m_pHead->pPre == nullptr)
+	{
+		Node<T>* _pLast = m_pHead;
+		while (_pLast->pNext != nullptr)
+			_pLast = _pLast->pNext;
+		_pLast->pNext = CreateNode(value_, _pLast, nullptr);
+		++m_nSize;
+		return;
+	}
+
+	// 分配并初始化一个结点
+	Node<T>* _pNew = CreateNode(value_, pCurrent_->pPre, pCurrent_);
 	// 更新前驱节点的pNext的值和后驱节点的pPre的值
 	pCurrent_->pPre->pNext = _pNew;
 	pCurrent_->pPre = _pNew;
@@ -115,8 +147,8 @@ void list<T>::insert(Node<T>* pCurrent_, const T& value_)
 	++m_nSize;
 }
 
-template <typename T>
-void list<T>::erase(Node<T>* pCurrent_)
+template <typename T, typename Alloc>
+void list<T, Alloc>::erase(Node<T>* pCurrent_)
 {
 	if (nullptr == pCurrent_)
 	{
@@ -124,52 +156,313 @@ void list<T>::erase(Node<T>* pCurrent_)
 		return;
 	}
 
-	// 更新前驱节点的pNext的值和后驱节点的pPre的值
+	// 更新前驱节点的pNext的值和后驱节点的pPre的值, 非循环链表的最后一个节点没有后驱节点
 	pCurrent_->pPre->pNext = pCurrent_->pNext;
-	pCurrent_->pNext->pPre = pCurrent_->pPre;
-	// delete掉当前节点
-	delete pCurrent_;
+	if (pCurrent_->pNext != nullptr)
+		pCurrent_->pNext->pPre = pCurrent_->pPre;
+	// 释放当前节点
+	DestroyNode(pCurrent_);
 	pCurrent_ = nullptr;
 
 	--m_nSize;
 }
 
-template <typename T>
-bool list<T>::empty() const
+// 分配节点的内存之后再在上面构造节点，构造时抛出异常要把内存还回去
+template <typename T, typename Alloc>
+template <typename... Args>
+Node<T>* list<T, Alloc>::CreateNode(const Args&... args_)
+{
+	Node<T>* _pNode = NodeTraits::allocate(m_allocator, 1);
+	try
+	{
+		NodeTraits::construct(m_allocator, _pNode, args_...);
+	}
+	catch (...)
+	{
+		NodeTraits::deallocate(m_allocator, _pNode, 1);
+		throw;
+	}
+	return _pNode;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::DestroyNode(Node<T>* pNode_)
+{
+	NodeTraits::destroy(m_allocator, pNode_);
+	NodeTraits::deallocate(m_allocator, pNode_, 1);
+}
+
+template <typename T, typename Alloc>
+Node<T>* list<T, Alloc>::Head() const
+{
+	return m_pHead;
+}
+
+template <typename T, typename Alloc>
+bool list<T, Alloc>::empty() const
 {
 	return 0 == m_nSize;
 }
 
-template <typename T>
-size_t list<T>::size() const
+template <typename T, typename Alloc>
+size_t list<T, Alloc>::size() const
 {
 	return m_nSize;
 }
 
 
+/************    双向链表的归并排序    ***************/
+// 与单向链表一样，使用自底向上的归并排序，只修改节点的指针，不new新节点，也不拷贝元素。
+// 排序过程中只维护pNext指针，把双向链表当作单向链表来处理; 排序完成后再从头到尾走一遍，
+// 把每个节点的pPre指针修正过来，这一遍只需要O(n)的时间。
+// 拆分与合并节点串的辅助函数与单向链表共用，在list_sort.h中。
+//
+// 把所有节点从哨兵节点上摘下来，变成一个沿pNext以nullptr结尾的节点串并返回第一个节点。
+// pEnd_返回原来最后一个节点的pNext值：非循环链表中为nullptr, 循环链表中为哨兵节点。
+template <typename T, typename Alloc>
+Node<T>* list<T, Alloc>::Detach(Node<T>*& pEnd_)
+{
+	Node<T>* _pLast = m_pHead;
+	for (size_t i = 0; i < m_nSize; ++i)
+		_pLast = _pLast->pNext;
+
+	pEnd_ = _pLast->pNext;
+	_pLast->pNext = nullptr;
+
+	Node<T>* _pFirst = m_pHead->pNext;
+	m_pHead->pNext = pEnd_;
+	if (pEnd_ != nullptr)
+		pEnd_->pPre = m_pHead;
+	return m_nSize == 0 ? nullptr : _pFirst;
+}
+
+// 把节点串挂回到哨兵节点之后，同时修正所有节点的pPre指针, 最后一个节点指向pEnd_.
+template <typename T, typename Alloc>
+void list<T, Alloc>::Attach(Node<T>* pFirst_, Node<T>* pEnd_)
+{
+	Node<T>* _pPre = m_pHead;
+	for (Node<T>* _pNode = pFirst_; _pNode != nullptr; _pNode = _pNode->pNext)
+	{
+		_pPre->pNext = _pNode;
+		_pNode->pPre = _pPre;
+		_pPre = _pNode;
+	}
+
+	_pPre->pNext = pEnd_;
+	if (pEnd_ != nullptr)
+		pEnd_->pPre = _pPre;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::sort()
+{
+	sort(LessValue<T>);
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::sort(Compare comp_)
+{
+	if (m_nSize < 2)
+		return;
+
+	Node<T>* _pEnd = nullptr;
+	Node<T>* _pFirst = Detach(_pEnd);
+	Node<T>* _pLast = nullptr;
+
+	// nWidth表示当前有序段的长度
+	for (size_t _nWidth = 1; _nWidth < m_nSize; _nWidth <<= 1)
+	{
+		Node<T> _dummy;
+		Node<T>* _pTail = &_dummy;
+		Node<T>* _pCurrent = _pFirst;
+		while (_pCurrent != nullptr)
+		{
+			Node<T>* _pLeft = _pCurrent;
+			Node<T>* _pRight = SplitNodes(_pLeft, _nWidth);
+			_pCurrent = SplitNodes(_pRight, _nWidth);
+
+			_pTail->pNext = MergeNodes(_pLeft, _pRight, comp_, _pLast);
+			_pTail = _pLast;
+		}
+		_pFirst = _dummy.pNext;
+	}
+
+	Attach(_pFirst, _pEnd);
+}
+
+// 合并两个有序的链表, 合并完成之后other_为空。时间复杂度为O(N+M).
+template <typename T, typename Alloc>
+void list<T, Alloc>::merge(list<T, Alloc>& other_)
+{
+	merge(other_, LessValue<T>);
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::merge(list<T, Alloc>& other_, Compare comp_)
+{
+	if (&other_ == this || other_.m_nSize == 0)
+		return;
+
+	Node<T>* _pEnd = nullptr;
+	Node<T>* _pOtherEnd = nullptr;
+	Node<T>* _pFirst = Detach(_pEnd);
+	Node<T>* _pOtherFirst = other_.Detach(_pOtherEnd);
+
+	Node<T>* _pLast = nullptr;
+	Attach(MergeNodes(_pFirst, _pOtherFirst, comp_, _pLast), _pEnd);
+
+	m_nSize += other_.m_nSize;
+	other_.m_nSize = 0;
+}
+
 /************    双向链表的循环链表的实现    ***************/
-// 由双向链表实现循环链表，只需要修改一处代码即可，即：
+// 由双向链表实现循环链表，只需要修改一处代码即可(编译时定义CIRCULAR_LIST得到的就是循环链表)，即：
 // 把list的构造函数由修改前的：
-template <typename T>
-list<T>::list()
+#ifndef CIRCULAR_LIST
+template <typename T, typename Alloc>
+list<T, Alloc>::list()
 {
-	m_pHead = new Node<T>;
+	m_pHead = CreateNode();
 	m_nSize = 0;
 }
-
+#else
 // 修改为：
-template <typename T>
-list<T>::list()
+template <typename T, typename Alloc>
+list<T, Alloc>::list()
 {
-	m_pHead = new Node<T>;
+	m_pHead = CreateNode();
 	m_pHead->pPre = m_pHead;
 	m_pHead->pNext = m_pHead;
 	m_nSize = 0;
 }
+#endif	// CIRCULAR_LIST
 
 /**********************    测试程序     *************************/
+// 元素为(键, 插入的序号), 只按键比较，用序号检查排序是否稳定
+typedef std::pair<int, int> KeyAndOrder;
+
+static bool LessKey(const KeyAndOrder& lhs, const KeyAndOrder& rhs)
+{
+	return lhs.first < rhs.first;
+}
+
+// 检查链表：元素个数正确，每个节点的pPre指向它的前一个节点，最后一个节点之后是nullptr(非循环
+// 链表)或者哨兵节点(循环链表), 按键有序，键相等时按序号有序(稳定).
+template <typename Alloc>
+static bool CheckList(const list<KeyAndOrder, Alloc>& list_)
+{
+	Node<KeyAndOrder>* _pHead = list_.Head();
+	Node<KeyAndOrder>* _pPre = _pHead;
+	size_t _nCount = 0;
+	for (Node<KeyAndOrder>* _pNode = _pHead->pNext; _pNode != nullptr && _pNode != _pHead; _pNode = _pNode->pNext)
+	{
+		if (_pNode->pPre != _pPre)
+			return false;
+		if (_pPre != _pHead && (_pNode->value.first < _pPre->value.first
+			|| (_pNode->value.first == _pPre->value.first && _pNode->value.second < _pPre->value.second)))
+			return false;
+		_pPre = _pNode;
+		++_nCount;
+	}
+
+	if (_pHead->pPre != nullptr && _pHead->pPre != _pPre)
+		return false;
+	return _nCount == list_.size();
+}
+
+// 使用内存池的链表：每一轮在每个节点之前插入一个新节点，再隔一个删除一个，节点反复地从空闲链表
+// 中分配与释放。最后排序、合并并检查链表，两个链表析构之后内存池中的节点全部归还。
+template <typename Alloc>
+static bool CheckPooledList(int nRounds_)
+{
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node<KeyAndOrder> > NodeAllocator;
+	node_pool& _pool = NodeAllocator::pool();
+	size_t _nInUse = _pool.in_use();
+	bool _bOk = true;
+	{
+		list<KeyAndOrder, Alloc> _list;
+		for (int i = 0; i < 1000; ++i)
+			_list.insert(_list.Head(), KeyAndOrder(i % 13, 0));
+
+		int _nNext = 0;
+		for (int _nRound = 0; _nRound < nRounds_; ++_nRound)
+		{
+			Node<KeyAndOrder>* _pHead = _list.Head();
+			for (Node<KeyAndOrder>* _pNode = _pHead->pNext; _pNode != nullptr && _pNode != _pHead; _pNode = _pNode->pNext)
+				_list.insert(_pNode, KeyAndOrder(_nNext++ % 13, 0));
+
+			Node<KeyAndOrder>* _pNode = _pHead->pNext;
+			while (_pNode != nullptr && _pNode != _pHead)
+			{
+				Node<KeyAndOrder>* _pNext = _pNode->pNext;
+				_list.erase(_pNode);
+				_pNode = (_pNext != nullptr && _pNext != _pHead) ? _pNext->pNext : _pNext;
+			}
+		}
+
+		// 序号按当前的位置重新编号，用于检查排序的稳定性
+		int _nOrder = 0;
+		for (Node<KeyAndOrder>* _pNode = _list.Head()->pNext; _pNode != nullptr && _pNode != _list.Head(); _pNode = _pNode->pNext)
+			_pNode->value.second = _nOrder++;
+		_list.sort(LessKey);
+
+		list<KeyAndOrder, Alloc> _other;
+		for (int i = 0; i < 100; ++i)
+			_other.insert(_other.Head(), KeyAndOrder(i % 5, _nOrder++));
+		_other.sort(LessKey);
+		_list.merge(_other, LessKey);
+		_bOk = CheckList(_list) && _list.size() == 1100 && _other.empty();
+	}
+	return _bOk && _pool.in_use() == _nInUse;
+}
+
 int main(int argc, char* argv[])
 {
+	// 排序：键只有0到4, 有很多相等的键
+	list<KeyAndOrder> _list1;
+	for (int i = 0; i < 50; ++i)
+		_list1.insert(_list1.Head(), KeyAndOrder((i * 7) % 5, i));
+	_list1.sort(LessKey);
+	std::cout << "排序之后的链表检查" << (CheckList(_list1) ? "正确" : "错误") << ", 元素个数为：" << _list1.size() << std::endl;
+
+	// 合并：键相等时当前链表中的元素排在other_的前面，other_的序号都比当前链表的大
+	list<KeyAndOrder> _list2;
+	for (int i = 0; i < 30; ++i)
+		_list2.insert(_list2.Head(), KeyAndOrder((i * 3) % 7, 100 + i));
+	_list2.sort(LessKey);
+	_list1.merge(_list2, LessKey);
+	std::cout << "合并之后的链表检查" << (CheckList(_list1) ? "正确" : "错误") << ", 元素个数为：" << _list1.size()
+		<< ", 另一个链表的元素个数为：" << _list2.size() << std::endl;
+
+	// 合并之后两个链表仍然可以正常插入删除
+	_list2.insert(_list2.Head(), KeyAndOrder(1, 0));
+	_list1.erase(_list1.Head()->pNext);
+	std::cout << "合并之后插入删除的检查" << (CheckList(_list1) && CheckList(_list2) ? "正确" : "错误") << std::endl;
+
+	// 使用默认的operator<排序与合并
+	list<int> _list3;
+	list<int> _list4;
+	int _array1[] = {5, -3, 9, 0, 5, 12, -7};
+	int _array2[] = {8, 1, -3, 20};
+	for (int i = 0; i < 7; ++i)
+		_list3.insert(_list3.Head(), _array1[i]);
+	for (int i = 0; i < 4; ++i)
+		_list4.insert(_list4.Head(), _array2[i]);
+	_list3.sort();
+	_list4.sort();
+	_list3.merge(_list4);
+	std::cout << "排序并合并之后的链表为：";
+	for (Node<int>* _pNode = _list3.Head()->pNext; _pNode != nullptr && _pNode != _list3.Head(); _pNode = _pNode->pNext)
+		std::cout << _pNode->value << " ";
+	std::cout << std::endl;
+
+	// 使用共享的内存池与线程局部的内存池
+	std::cout << "共享的内存池的链表检查" << (CheckPooledList<pool_allocator<KeyAndOrder> >(50) ? "正确" : "错误")
+		<< ", 线程局部的内存池的链表检查" << (CheckPooledList<pool_allocator<KeyAndOrder, true> >(50) ? "正确" : "错误")
+		<< std::endl;
+
 	return 0;
 }
 
@@ -18,6 +18,9 @@
 #include <iostream>
 #include <vector>
 #include <stdexcept>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // 1. 最大堆或最小堆是使用一个数组表示的完全二叉树，除了最底层之外，其它层都为满的，并且最
 // 底层从左到右填充。在最大堆中，父结点大于或等于左右子结点，在最小堆中，父结点小于或等
@@ -153,7 +156,9 @@ class MaxHeap
 public:
 	void Insert(int value_);
 	void PopMaximum();
+	void ReplaceMaximum(int nValue_);		// 用新值替换最大值
 	void ModifyValue(size_t nIndex_, int nValue_);
+	void Reserve(size_t nCapacity_);		// 预先分配空间
 	int Maximum() const;
 	bool empty() const;
 	size_t size() const;
@@ -186,6 +191,25 @@ void MaxHeap::PopMaximum()
 	MaxHeapify(0);
 }
 
+// 删除最大值再插入一个新值需要一次向下调整和一次向上调整; 直接把新值放到堆顶，只需要一次
+// 向下调整即可，复杂度为O(logN).
+void MaxHeap::ReplaceMaximum(int nValue_)
+{
+	if (m_vecArray.empty())
+	{
+		std::cerr << "最大堆为空，无法替换最大值." << std::endl;
+		return;
+	}
+
+	m_vecArray[0] = nValue_;
+	MaxHeapify(0);
+}
+
+void MaxHeap::Reserve(size_t nCapacity_)
+{
+	m_vecArray.reserve(nCapacity_);
+}
+
 void MaxHeap::ModifyValue(size_t nIndex_, int nValue_)
 {
 	if (nIndex_ >= m_vecArray.size() || nIndex_ < 0)
@@ -251,6 +275,101 @@ void MaxHeap::MaxHeapify(size_t nIndex_)
 	}
 }
 
+/*************************  最小的K个数    **************************/
+// 从一个无穷的数据流中找出最小的K个数，不需要保存所有的数据，只需要维护一个大小为K的最大堆：
+//     1. 堆中元素不足K个时，直接插入;
+//     2. 堆满之后，堆顶就是当前第K小的数，新来的数只有比堆顶小才可能属于最小的K个数，此
+//     时用它替换堆顶，再向下调整一次即可; 否则直接丢弃。
+// 空间复杂度为O(K), 每个元素的时间复杂度为O(logK).
+//
+// 当数据流很长时，绝大多数元素都比堆顶大，只需要一次比较就被丢弃了。所以批量输入时，先
+// 用SIMD指令一次把4个元素与堆顶比较，4个都不小于堆顶时直接跳过，这样被丢弃的元素平均下来
+// 连一次比较都不到。
+class TopKSelector
+{
+public:
+	explicit TopKSelector(size_t nK_);
+	void Push(int nValue_);								// 输入一个元素
+	void PushBatch(const int array[], size_t nLength_);	// 批量输入元素
+	std::vector<int> SortedResult() const;				// 从小到大输出最小的K个数
+	size_t size() const;
+private:
+	size_t m_nK;
+	MaxHeap m_heap;
+};
+
+TopKSelector::TopKSelector(size_t nK_)
+{
+	m_nK = nK_;
+	m_heap.Reserve(nK_);
+}
+
+void TopKSelector::Push(int nValue_)
+{
+	if (m_heap.size() < m_nK)
+		m_heap.Insert(nValue_);
+	else if (m_nK > 0 && nValue_ < m_heap.Maximum())
+		m_heap.ReplaceMaximum(nValue_);
+}
+
+void TopKSelector::PushBatch(const int array[], size_t nLength_)
+{
+	if (array == nullptr || m_nK == 0)
+		return;
+
+	// 堆还没有满时，逐个插入
+	size_t i = 0;
+	while (i < nLength_ && m_heap.size() < m_nK)
+		m_heap.Insert(array[i++]);
+
+	int _nThreshold = m_heap.empty() ? 0 : m_heap.Maximum();
+#if defined(__SSE2__)
+	for (; i + 4 <= nLength_; i += 4)
+	{
+		__m128i _values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(array + i));
+		__m128i _less = _mm_cmplt_epi32(_values, _mm_set1_epi32(_nThreshold));
+		if (_mm_movemask_epi8(_less) == 0)
+			continue;
+
+		// 4个数中存在比堆顶小的数，逐个处理; 每次替换之后堆顶会变小，所以要重新比较。
+		for (size_t j = i; j < i + 4; ++j)
+		{
+			if (array[j] < _nThreshold)
+			{
+				m_heap.ReplaceMaximum(array[j]);
+				_nThreshold = m_heap.Maximum();
+			}
+		}
+	}
+#endif
+	for (; i < nLength_; ++i)
+	{
+		if (array[i] < _nThreshold)
+		{
+			m_heap.ReplaceMaximum(array[i]);
+			_nThreshold = m_heap.Maximum();
+		}
+	}
+}
+
+// 把堆拷贝一份，依次删除最大值并从后向前填充，复杂度为O(KlogK).
+std::vector<int> TopKSelector::SortedResult() const
+{
+	MaxHeap _heap = m_heap;
+	std::vector<int> _vecResult(_heap.size());
+	for (size_t i = _vecResult.size(); i > 0; --i)
+	{
+		_vecResult[i - 1] = _heap.Maximum();
+		_heap.PopMaximum();
+	}
+	return _vecResult;
+}
+
+size_t TopKSelector::size() const
+{
+	return m_heap.size();
+}
+
 /**********************    测试程序     *************************/
 
 int main(int argc, char* argv[])
@@ -313,6 +432,17 @@ int main(int argc, char* argv[])
 	std::cout << "从最小堆中删除了4个最大值，此时应该输出7" << std::endl;
 	std::cout << _maxHeap.Maximum()  << std::endl;
 
+	// 最小的K个数测试代码
+	TopKSelector _topK(5);
+	int _array[] = {45, 3, 99, -7, 12, 3, 88, 0, 61, -20, 5, 77, 14, 2, 100, -1, 33};
+	_topK.PushBatch(_array, sizeof(_array) / sizeof(_array[0]));
+	_topK.Push(-100);
+	std::cout << "最小的5个数为，此时应该输出-100 -20 -7 -1 0" << std::endl;
+	std::vector<int> _vecTopK = _topK.SortedResult();
+	for (size_t i = 0; i < _vecTopK.size(); ++i)
+		std::cout << _vecTopK[i] << " ";
+	std::cout << std::endl;
+
 	return 0;
 }
 
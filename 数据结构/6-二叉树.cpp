@@ -15,7 +15,7 @@
 *   Github: https://github.com/yinheyi
 *   
 ***********************************************************************/
-#include <stack>
+#include "stack.h"
 #include <queue>
 #include <iostream>
 #include <cassert>
@@ -47,6 +47,8 @@
 // 都是使用递归来实现的, 使用递归来实现的代码非常简洁明了。 这里，我们同时给出基于循环的前序/
 // 中序/后序的遍历方法, 基于循环的遍历方法会直接使用到栈数据结构。对于层次遍历算法，是基于队
 // 列的数据结构来实现。
+// 8. 基于循环的遍历使用stack.h中的Stack<BinaryNode*, 64>, 栈中不超过64个结点时(也就是树的
+// 高度不太大时)结点指针都存放在局部变量的内部数组中，遍历过程中不需要申请内存。
 
 
 /* 二叉树结点的定义: 为了简单，不使用模板，直接使用int类型 */
@@ -90,24 +92,24 @@ void PreorderTraversal_ByLoop(BinaryNode* pRoot_, pFunc CallbackFunc_)
 		return;
 
 	// 定义一个栈, 并把根结点的指针存放在栈中
-	std::stack<BinaryNode*> _stackContainter;
-	_stackContainter.push(pRoot_);
+	Stack<BinaryNode*, 64> _stackContainter;
+	_stackContainter.Push(pRoot_);
 
 	// 进行遍历操作
-	while (!_stackContainter.empty())
+	while (!_stackContainter.Empty())
 	{
 		// 遍历栈顶元素并出栈
-		BinaryNode* _pCurrentNode = _stackContainter.top();
+		BinaryNode* _pCurrentNode = _stackContainter.Top();
 		assert(_pCurrentNode != nullptr);
 		CallbackFunc_(_pCurrentNode);
-		_stackContainter.pop();
+		_stackContainter.Pop();
 
 		// 如果右子树与左子树不为空，则入栈。注意：一定要先添加右子树，
 		// 再添加左子树, 这样才能保证出栈的时候先遍历左子树再遍历右子树.
 		if (_pCurrentNode->m_pRight != nullptr)
-			_stackContainter.push(_pCurrentNode->m_pRight);
+			_stackContainter.Push(_pCurrentNode->m_pRight);
 		if (_pCurrentNode->m_pLeft != nullptr)
-			_stackContainter.push(_pCurrentNode->m_pLeft);
+			_stackContainter.Push(_pCurrentNode->m_pLeft);
 	}
 }
 
@@ -131,27 +133,27 @@ void InorderTraversal_ByLoop(BinaryNode* pRoot_, pFunc CallbackFunc_)
 	if (nullptr == pRoot_ || nullptr == CallbackFunc_)
 		return;
 
-	std::stack<BinaryNode*> _stackContainer;
+	Stack<BinaryNode*, 64> _stackContainer;
 
 	// 一路找下去，直到找到最左的子结点
 	while (pRoot_ != nullptr)
 	{
-		_stackContainer.push(pRoot_);
+		_stackContainer.Push(pRoot_);
 		pRoot_ = pRoot_->m_pLeft;
 	}
 
-	while (!_stackContainer.empty())
+	while (!_stackContainer.Empty())
 	{
 		// 遍历栈顶的结点
-		BinaryNode* _pCurrentNode = _stackContainer.top();
+		BinaryNode* _pCurrentNode = _stackContainer.Top();
 		CallbackFunc_(_pCurrentNode);
-		_stackContainer.pop();
+		_stackContainer.Pop();
 
 		// 接下来，找到当前结点的右子树中最左的子结点
 		_pCurrentNode = _pCurrentNode->m_pRight;
 		while (_pCurrentNode != nullptr)
 		{
-			_stackContainer.push(_pCurrentNode);
+			_stackContainer.Push(_pCurrentNode);
 			_pCurrentNode = _pCurrentNode->m_pLeft;
 		}
 	}
@@ -177,35 +179,35 @@ void PostorderTraversal_ByLoop(BinaryNode* pRoot_, pFunc CallbackFunc_)
 	if (nullptr == pRoot_ || nullptr == CallbackFunc_)
 		return;
 
-	std::stack<BinaryNode*> _stackContainer;
+	Stack<BinaryNode*, 64> _stackContainer;
 
 	// 一路找下去，一直找到最左的子结点
 	while (pRoot_ != nullptr)
 	{
-		_stackContainer.push(pRoot_);
+		_stackContainer.Push(pRoot_);
 		pRoot_ = pRoot_->m_pLeft;
 	}
 
-	while (!_stackContainer.empty())
+	while (!_stackContainer.Empty())
 	{
 		// 接下来，不能遍历栈顶的结点，因为如果该结点存在右子树,则需要去遍历右子树上的结点.
 		// 只要右子树不为空，就需要找右子树上最左的子结点, 重复该过程直到某个最左子结点的右
 		// 子树为空为止。
-		while (_stackContainer.top() ->m_pRight != nullptr)
+		while (_stackContainer.Top() ->m_pRight != nullptr)
 		{
 			// 还是一路找右子树上的最左子结点
-			BinaryNode* _pCurrentNode = _stackContainer.top()->m_pRight;
+			BinaryNode* _pCurrentNode = _stackContainer.Top()->m_pRight;
 			while (_pCurrentNode != nullptr)
 			{
-				_stackContainer.push(_pCurrentNode);
+				_stackContainer.Push(_pCurrentNode);
 				_pCurrentNode = _pCurrentNode->m_pLeft;
 			}
 		}
 
 		// 到此时，我们就可以遍历栈顶的元素了。
-		BinaryNode* _pCurrentNode = _stackContainer.top();
+		BinaryNode* _pCurrentNode = _stackContainer.Top();
 		CallbackFunc_(_pCurrentNode);
-		_stackContainer.pop();
+		_stackContainer.Pop();
 
 		// 把当前结点出栈之后，此时栈顶的元素肯定是当前结点的父结点,我们需要判断当前结点是
 		// 父结点的左子结点还是右子结点:
@@ -213,11 +215,11 @@ void PostorderTraversal_ByLoop(BinaryNode* pRoot_, pFunc CallbackFunc_)
 		// 上面的过程。
 		// b. 如果当前结点是父结点的右子结点，则接下来我们直接去遍历父结点即可,遍历完父结点后，
 		// 还需要继续判断父结点是否为祖结点的右子结点, 重复此过程，直接不满足条件为止。
-		while (!_stackContainer.empty() && _pCurrentNode == _stackContainer.top()->m_pRight)
+		while (!_stackContainer.Empty() && _pCurrentNode == _stackContainer.Top()->m_pRight)
 		{
-			_pCurrentNode = _stackContainer.top();
+			_pCurrentNode = _stackContainer.Top();
 			CallbackFunc_(_pCurrentNode);
-			_stackContainer.pop();
+			_stackContainer.Pop();
 		}
 	}
 }
@@ -15,6 +15,7 @@
 *   Github: https://github.com/yinheyi
 *   
 ***********************************************************************/
+#include "binary_search_tree.h"
 #include <iostream>
 #include <cassert>		// 使用assert()断言
 
@@ -40,15 +41,14 @@
 //     f. 插入元素
 //     g. 删除元素
 // 4. 由于在进行求前驱结点/后驱结点/删除元素等操作时，需要通过子结点获取父结点的指针，
-// 因此，在结点的struct内增加指向父结点的指针一项，即node的定义如下：
-struct Node
-{
-	int m_nValue;
-	Node* m_pParent;
-	Node* m_pLeft;
-	Node* m_pRight;
-	Node(int value_ = 0, Node* pParent_ = nullptr, Node* pLeft_ = nullptr, Node* pRight_ = nullptr);
-};
+// 因此，在结点的struct内增加指向父结点的指针一项，node的定义在binary_search_tree.h中：
+//     struct Node
+//     {
+//         int m_nValue;
+//         Node* m_pParent;
+//         Node* m_pLeft;
+//         Node* m_pRight;
+//     };
 
 // node的构造函数
 Node::Node(int value_, Node* pParent_, Node* pLeft_, Node* pRight_)
@@ -307,11 +307,11 @@ void Delete(Node*& pRoot_, Node* pDeleteNode_)
 }
 
 /**********************    测试程序     *************************/
-typedef void (*pFunc)(Node*);
 void BuildBinaryTree(Node*& pRoot_, std::istream& cin_);
 void PrintNode(Node* pNode_);
-void InorderTraversal_ByRecursion(Node* pRoot_, pFunc CallbackFunc_);
 
+// 编译时定义宏BST_NO_MAIN可以去掉测试程序，以便与其它程序链接在一起
+#ifndef BST_NO_MAIN
 int main(int argc, char* argv[])
 {
 	std::cout << "输入二叉搜索树的前序遍历结果, 建立一个二叉搜索树. 假设所有节点的为正整数 " << std::endl;
@@ -413,6 +413,7 @@ void PrintNode(Node* pNode_)
 		return;
 	std::cout << pNode_->m_nValue << " ";
 }
+#endif	// BST_NO_MAIN
 
 void InorderTraversal_ByRecursion(Node* pRoot_, pFunc CallbackFunc_)
 {
@@ -0,0 +1,414 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 14时31分08秒
+*   Modifed Time: 2026年10月20日 星期二 16时02分45秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#include "stack.h"
+#include "pad_right.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*************************   无锁栈的简单介绍     ****************************/
+// 1. 1-栈.cpp中的栈不是线程安全的，多个线程共享一个栈(例如空闲链表、任务栈)时，最简单的办法
+// 是用互斥锁保护它，但是线程多的时候大部分时间都花在了等锁上。
+// 2. Treiber栈是最简单的无锁栈：栈由单向链表实现，入栈时把新结点的next指向当前的栈顶，再通过
+// CAS(compare and swap)把栈顶换成新结点；出栈时读出栈顶结点的next, 再通过CAS把栈顶换成next.
+// CAS失败说明栈顶被其它线程修改了，重新读取栈顶再试一次。
+// 3. ABA问题：线程A读到栈顶为X, next为Y, 准备CAS之前，其它线程弹出了X和Y, 又把X压了回来，
+// 此时栈顶仍然为X, A的CAS会成功，但是把已经不在栈中的Y设为了栈顶。解决的办法是给栈顶加上一个
+// 版本号(tag), 每次修改栈顶时加1, CAS同时比较指针和版本号。
+// 4. 内存回收：出栈的结点可能还在被其它线程读取(读next), 不能直接释放。这里所有的结点都从一个
+// 预先分配好的数组中获取，出栈之后放回空闲链表重复使用，从不释放，读到的next即使已经过期，
+// 版本号也保证了后面的CAS一定失败。结点用数组中的下标(32位)来表示，下标与版本号合在一起正好
+// 是64位，普通的64位CAS就可以完成，不需要128位的CAS.
+// 5. 退避(backoff): CAS失败说明竞争激烈，马上重试多半还会失败，而且会让缓存行在CPU之间来回
+// 传递。失败之后先等待一段时间，等待的时间每次加倍，直到一个上限。
+// 6. 消除(elimination): 一个入栈和一个出栈同时发生时，相当于什么都没有做，入栈的元素可以直接
+// 交给出栈的线程，不需要修改栈顶。CAS失败之后，入栈的线程把它的结点放在消除数组中随机的一个
+// 位置上等待一会儿，出栈的线程CAS失败之后到消除数组中随机的位置上去取，取到就直接返回。竞争
+// 越激烈，成功消除的比例越高，栈顶上的竞争就越小。
+// 7. 栈的容量在构造时确定，空闲结点用完时入栈失败，返回false.
+// 8. 测试程序对比互斥锁保护的Stack<T>与三种无锁栈在1~64个线程下的吞吐量，编译时需要加上
+// -pthread, 例如: g++ -O2 -std=c++11 -pthread 9-无锁栈.cpp. 只有一个CPU核时线程之间没有真正的
+// 竞争，各种实现的差别不大，消除也几乎不会发生。
+//
+//
+/*************************   无锁栈的定义     ****************************/
+struct LockFreeStackOptions
+{
+	bool bBackoff = false;					// CAS失败之后是否指数退避
+	size_t nEliminationSlots = 0;			// 消除数组的大小，为0时不使用消除
+};
+
+template <typename T>
+class LockFreeStack
+{
+public:
+	explicit LockFreeStack(size_t capicity, const LockFreeStackOptions& options = LockFreeStackOptions());
+	~LockFreeStack();
+
+	bool Push(const T& value);				// 空闲结点用完时返回false
+	bool Pop(T& value);						// 栈为空时返回false
+	bool Empty() const;
+	size_t Capicity() const;
+	unsigned long long EliminatedCount() const;		// 通过消除完成的入栈/出栈对的个数
+
+private:
+	LockFreeStack(const LockFreeStack&);
+	LockFreeStack& operator=(const LockFreeStack&);
+
+	// 栈顶与空闲链表的表头都是一个64位的字：低32位为结点的下标(0表示空)，高32位为版本号
+	static uint32_t IndexOf(uint64_t nHead) { return static_cast<uint32_t>(nHead); }
+	static uint64_t MakeHead(uint32_t nIndex, uint64_t nOldHead) { return ((nOldHead >> 32) + 1) << 32 | nIndex; }
+
+	bool PushNode(std::atomic<uint64_t>& head, uint32_t nIndex, bool bEliminate);
+	uint32_t PopNode(std::atomic<uint64_t>& head, bool bEliminate);
+	bool TryEliminatePush(uint32_t nIndex);
+	uint32_t TryEliminatePop();
+	void Backoff(unsigned& nDelay) const;
+
+	struct Node
+	{
+		T m_value;
+		std::atomic<uint32_t> m_nNext;
+	};
+
+	// 消除数组中一个位置的状态：0表示空，TAKEN表示结点已经被出栈的线程取走，其它值为等待交换的结点下标
+	static const uint32_t TAKEN = UINT32_MAX;
+
+	// 栈顶与空闲链表的表头各占一个缓存行，避免互相干扰
+	alignas(64) std::atomic<uint64_t> m_nTop;
+	alignas(64) std::atomic<uint64_t> m_nFreeList;
+	alignas(64) std::atomic<unsigned long long> m_nEliminated;
+	size_t m_nCapicity;
+	Node* m_pNodes;							// 下标从1开始，0表示空
+	std::atomic<uint32_t>* m_pSlots;		// 消除数组
+	LockFreeStackOptions m_options;
+};
+
+/*************************   无锁栈的实现     ****************************/
+template <typename T>
+LockFreeStack<T>::LockFreeStack(size_t capicity, const LockFreeStackOptions& options)
+	: m_nTop(0), m_nFreeList(0), m_nEliminated(0), m_nCapicity(capicity), m_options(options)
+{
+	if (capicity >= TAKEN)
+		throw std::invalid_argument("参数不合法！");
+
+	// 开始时所有的结点都在空闲链表中
+	m_pNodes = new Node[capicity + 1];
+	for (size_t i = 1; i <= capicity; ++i)
+		m_pNodes[i].m_nNext.store(i < capicity ? static_cast<uint32_t>(i + 1) : 0, std::memory_order_relaxed);
+	m_nFreeList.store(capicity > 0 ? 1 : 0, std::memory_order_relaxed);
+
+	m_pSlots = new std::atomic<uint32_t>[m_options.nEliminationSlots + 1];
+	for (size_t i = 0; i <= m_options.nEliminationSlots; ++i)
+		m_pSlots[i].store(0, std::memory_order_relaxed);
+}
+
+template <typename T>
+LockFreeStack<T>::~LockFreeStack()
+{
+	delete[] m_pNodes;
+	delete[] m_pSlots;
+}
+
+template <typename T>
+bool LockFreeStack<T>::Push(const T& value)
+{
+	uint32_t _nIndex = PopNode(m_nFreeList, false);
+	if (_nIndex == 0)
+		return false;
+
+	// 结点的值在CAS之前写入，CAS的release保证其它线程出栈时能看到它
+	m_pNodes[_nIndex].m_value = value;
+	PushNode(m_nTop, _nIndex, m_options.nEliminationSlots > 0);
+	return true;
+}
+
+template <typename T>
+bool LockFreeStack<T>::Pop(T& value)
+{
+	uint32_t _nIndex = PopNode(m_nTop, m_options.nEliminationSlots > 0);
+	if (_nIndex == 0)
+		return false;
+
+	value = m_pNodes[_nIndex].m_value;
+	PushNode(m_nFreeList, _nIndex, false);
+	return true;
+}
+
+template <typename T>
+bool LockFreeStack<T>::Empty() const
+{
+	return IndexOf(m_nTop.load(std::memory_order_acquire)) == 0;
+}
+
+template <typename T>
+size_t LockFreeStack<T>::Capicity() const
+{
+	return m_nCapicity;
+}
+
+template <typename T>
+unsigned long long LockFreeStack<T>::EliminatedCount() const
+{
+	return m_nEliminated.load(std::memory_order_relaxed);
+}
+
+// 把结点nIndex压入链表head, bEliminate为true时CAS失败之后先尝试与出栈的线程交换。
+// 返回值表示结点是否通过消除交给了出栈的线程。
+template <typename T>
+bool LockFreeStack<T>::PushNode(std::atomic<uint64_t>& head, uint32_t nIndex, bool bEliminate)
+{
+	unsigned _nDelay = 1;
+	uint64_t _nHead = head.load(std::memory_order_relaxed);
+	while (true)
+	{
+		m_pNodes[nIndex].m_nNext.store(IndexOf(_nHead), std::memory_order_relaxed);
+		if (head.compare_exchange_weak(_nHead, MakeHead(nIndex, _nHead),
+					std::memory_order_release, std::memory_order_relaxed))
+			return false;
+
+		if (bEliminate && TryEliminatePush(nIndex))
+			return true;
+		if (m_options.bBackoff)
+			Backoff(_nDelay);
+	}
+}
+
+// 从链表head中弹出一个结点，链表为空时返回0.
+// 结点从不释放，读到的next可能已经过期(结点被其它线程弹出后又压入)，但是此时版本号一定变了，CAS会失败。
+template <typename T>
+uint32_t LockFreeStack<T>::PopNode(std::atomic<uint64_t>& head, bool bEliminate)
+{
+	unsigned _nDelay = 1;
+	uint64_t _nHead = head.load(std::memory_order_acquire);
+	while (true)
+	{
+		uint32_t _nIndex = IndexOf(_nHead);
+		if (_nIndex == 0)
+			return 0;
+
+		uint32_t _nNext = m_pNodes[_nIndex].m_nNext.load(std::memory_order_relaxed);
+		if (head.compare_exchange_weak(_nHead, MakeHead(_nNext, _nHead),
+					std::memory_order_acquire, std::memory_order_acquire))
+			return _nIndex;
+
+		if (bEliminate)
+		{
+			uint32_t _nEliminated = TryEliminatePop();
+			if (_nEliminated != 0)
+				return _nEliminated;
+		}
+		if (m_options.bBackoff)
+			Backoff(_nDelay);
+	}
+}
+
+// 每个线程使用自己的随机数选择消除数组中的位置
+static inline uint32_t NextRandom()
+{
+	static thread_local uint32_t s_nState = static_cast<uint32_t>(
+			std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+	s_nState ^= s_nState << 13;
+	s_nState ^= s_nState >> 17;
+	s_nState ^= s_nState << 5;
+	return s_nState;
+}
+
+// 入栈的线程把结点放在一个空的位置上等待一会儿，被取走返回true, 否则收回结点返回false.
+template <typename T>
+bool LockFreeStack<T>::TryEliminatePush(uint32_t nIndex)
+{
+	std::atomic<uint32_t>& _slot = m_pSlots[NextRandom() % m_options.nEliminationSlots];
+	uint32_t _nExpected = 0;
+	if (!_slot.compare_exchange_strong(_nExpected, nIndex, std::memory_order_release, std::memory_order_relaxed))
+		return false;
+
+	for (int i = 0; i < 64 && _slot.load(std::memory_order_relaxed) == nIndex; ++i)
+		std::this_thread::yield();
+
+	// 收回失败说明出栈的线程已经把它改为了TAKEN, 由入栈的线程把位置清空
+	_nExpected = nIndex;
+	if (_slot.compare_exchange_strong(_nExpected, 0, std::memory_order_relaxed, std::memory_order_relaxed))
+		return false;
+	_slot.store(0, std::memory_order_relaxed);
+	m_nEliminated.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+// 出栈的线程查看一个随机的位置，上面有等待交换的结点时取走它。
+template <typename T>
+uint32_t LockFreeStack<T>::TryEliminatePop()
+{
+	std::atomic<uint32_t>& _slot = m_pSlots[NextRandom() % m_options.nEliminationSlots];
+	uint32_t _nIndex = _slot.load(std::memory_order_relaxed);
+	if (_nIndex == 0 || _nIndex == TAKEN)
+		return 0;
+	if (!_slot.compare_exchange_strong(_nIndex, TAKEN, std::memory_order_acquire, std::memory_order_relaxed))
+		return 0;
+	return _nIndex;
+}
+
+// 指数退避：等待的时间每次加倍，超过上限之后让出CPU
+template <typename T>
+void LockFreeStack<T>::Backoff(unsigned& nDelay) const
+{
+	const unsigned _nMaxDelay = 1024;
+	for (unsigned i = 0; i < nDelay; ++i)
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#endif
+	}
+	if (nDelay < _nMaxDelay)
+		nDelay *= 2;
+	else
+		std::this_thread::yield();
+}
+
+/*************************   用于对比的加锁的栈     ****************************/
+template <typename T>
+class MutexStack
+{
+public:
+	explicit MutexStack(size_t capicity) : m_stack(capicity, true) {}
+
+	bool Push(const T& value)
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_stack.Push(value);
+		return true;
+	}
+
+	bool Pop(T& value)
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		if (m_stack.Empty())
+			return false;
+		value = m_stack.Top();
+		m_stack.Pop();
+		return true;
+	}
+
+private:
+	std::mutex m_mutex;
+	Stack<T> m_stack;
+};
+
+/***************    测试程序   ****************************/
+// 每个线程交替地入栈与出栈nOpsPerThread_/2次, 返回每秒完成的操作数(百万次)。
+// 所有线程都就绪之后再一起开始，并检查出栈的元素之和等于入栈的元素之和。
+template <typename StackType>
+static double RunBenchmark(StackType& stack_, int nThreads_, size_t nOpsPerThread_)
+{
+	std::atomic<int> _nReady(0);
+	std::atomic<bool> _bStart(false);
+	std::atomic<long long> _nBalance(0);
+	std::vector<std::thread> _vecThreads;
+	for (int t = 0; t < nThreads_; ++t)
+	{
+		_vecThreads.push_back(std::thread([&, t]() {
+			long long _nLocalBalance = 0;
+			_nReady.fetch_add(1);
+			while (!_bStart.load(std::memory_order_acquire))
+				std::this_thread::yield();
+			for (size_t i = 0; i < nOpsPerThread_ / 2; ++i)
+			{
+				int _nValue = static_cast<int>(t * nOpsPerThread_ + i);
+				if (stack_.Push(_nValue))
+					_nLocalBalance += _nValue;
+				if (stack_.Pop(_nValue))
+					_nLocalBalance -= _nValue;
+			}
+			_nBalance.fetch_add(_nLocalBalance);
+		}));
+	}
+	while (_nReady.load() != nThreads_)
+		std::this_thread::yield();
+
+	std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+	_bStart.store(true, std::memory_order_release);
+	for (size_t i = 0; i < _vecThreads.size(); ++i)
+		_vecThreads[i].join();
+	std::chrono::duration<double> _elapsed = std::chrono::steady_clock::now() - _start;
+
+	// 剩在栈中的元素也要计算在内
+	int _nValue = 0;
+	long long _nRemain = 0;
+	while (stack_.Pop(_nValue))
+		_nRemain += _nValue;
+	if (_nBalance.load() != _nRemain)
+		std::cerr << "入栈与出栈的元素不一致！" << std::endl;
+
+	return nThreads_ * (nOpsPerThread_ / 2 * 2) / _elapsed.count() / 1e6;
+}
+
+int main(int argc, char* argv[])
+{
+	// 单线程的基本操作
+	LockFreeStack<std::string> _stringStack(3);
+	_stringStack.Push("第一个");
+	_stringStack.Push("第二个");
+	_stringStack.Push("第三个");
+	std::cout << "栈满时入栈" << (_stringStack.Push("第四个") ? "成功" : "失败") << std::endl;
+	std::string _strValue;
+	while (_stringStack.Pop(_strValue))
+		std::cout << "出栈：" << _strValue << std::endl;
+	std::cout << "栈" << (_stringStack.Empty() ? "为空" : "不为空") << std::endl << std::endl;
+
+	// 多线程的吞吐量，单位为百万次操作每秒。参数可以指定总的操作次数
+	size_t _nTotalOps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 21;
+	std::cout << "CPU核数：" << std::thread::hardware_concurrency() << ", 每种配置共" << _nTotalOps
+		<< "次操作，吞吐量的单位为Mops/s" << std::endl;
+	std::cout << PadRight("线程数", 8) << PadRight("互斥锁", 12) << PadRight("Treiber", 12)
+		<< PadRight("+退避", 12) << PadRight("+消除", 12) << "消除的比例" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+
+	const int s_nThreads[] = {1, 2, 4, 8, 16, 32, 64};
+	for (size_t i = 0; i < sizeof(s_nThreads) / sizeof(s_nThreads[0]); ++i)
+	{
+		int _nThreads = s_nThreads[i];
+		size_t _nOpsPerThread = _nTotalOps / _nThreads;
+		size_t _nCapicity = 2 * _nThreads;
+
+		MutexStack<int> _mutexStack(_nCapicity);
+		LockFreeStack<int> _treiberStack(_nCapicity);
+		LockFreeStackOptions _options;
+		_options.bBackoff = true;
+		LockFreeStack<int> _backoffStack(_nCapicity, _options);
+		_options.nEliminationSlots = 16;
+		LockFreeStack<int> _eliminationStack(_nCapicity, _options);
+
+		std::cout << std::left << std::setw(8) << _nThreads
+			<< std::setw(12) << RunBenchmark(_mutexStack, _nThreads, _nOpsPerThread)
+			<< std::setw(12) << RunBenchmark(_treiberStack, _nThreads, _nOpsPerThread)
+			<< std::setw(12) << RunBenchmark(_backoffStack, _nThreads, _nOpsPerThread)
+			<< std::setw(12) << RunBenchmark(_eliminationStack, _nThreads, _nOpsPerThread)
+			<< 100.0 * 2 * _eliminationStack.EliminatedCount() / (_nOpsPerThread / 2 * 2 * _nThreads) << "%"
+			<< std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,48 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 20时03分51秒
+*   Modifed Time: 2026年10月19日 星期一 20时03分51秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef BINARY_SEARCH_TREE_H
+#define BINARY_SEARCH_TREE_H
+
+// 7-二叉搜索树.cpp中的结点定义与函数声明, 供其它程序调用。
+// 编译7-二叉搜索树.cpp时定义宏BST_NO_MAIN即可去掉其中的测试程序，然后与调用者的程序链接在一起，
+// 例如：
+//     g++ -DBST_NO_MAIN -c 7-二叉搜索树.cpp
+//
+// 结点中增加了指向父结点的指针，求前驱结点/后驱结点/删除元素时需要通过子结点找到父结点。
+struct Node
+{
+	int m_nValue;
+	Node* m_pParent;
+	Node* m_pLeft;
+	Node* m_pRight;
+	Node(int value_ = 0, Node* pParent_ = nullptr, Node* pLeft_ = nullptr, Node* pRight_ = nullptr);
+};
+
+typedef void (*pFunc)(Node*);
+
+Node* Search(Node* pRoot_, int nValue_);			// 不存在时返回nullptr
+Node* Minimum(Node* pRoot_);
+Node* Maximum(Node* pRoot_);
+Node* PrecursorNode(Node* pNode_);					// 中序遍历的前一个结点
+Node* SuccessorNode(Node* pNode_);					// 中序遍历的后一个结点
+void Insert(Node*& pRoot_, int nValue_);
+void Transplant(Node*& pRoot_, Node* pOldNode_, Node* pNewNode_);
+void Delete(Node*& pRoot_, Node* pDeleteNode_);
+void InorderTraversal_ByRecursion(Node* pRoot_, pFunc CallbackFunc_);
+
+#endif	// BINARY_SEARCH_TREE_H
@@ -0,0 +1,77 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月19日 星期一 16时02分44秒
+*   Modifed Time: 2026年10月19日 星期一 16时40分13秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef LIST_SORT_H
+#define LIST_SORT_H
+#include <cstddef>
+
+// 单向链表与双向链表的归并排序共用的辅助函数。它们只使用节点的value与pNext, 操作的是以nullptr
+// 结尾的节点串，所以对两种节点都适用(双向链表排序时只维护pNext, 完成之后再修正pPre).
+
+// 从pStart_开始数nCount_个节点，把它们从后面断开，返回剩余部分的第一个节点。
+template <typename NodeT>
+NodeT* SplitNodes(NodeT* pStart_, size_t nCount_)
+{
+	for (size_t i = 1; pStart_ != nullptr && i < nCount_; ++i)
+		pStart_ = pStart_->pNext;
+
+	if (pStart_ == nullptr)
+		return nullptr;
+
+	NodeT* _pRest = pStart_->pNext;
+	pStart_->pNext = nullptr;
+	return _pRest;
+}
+
+// 合并两个有序的节点串，返回合并后的第一个节点, pLast_返回合并后的最后一个节点。
+template <typename NodeT, typename Compare>
+NodeT* MergeNodes(NodeT* pLeft_, NodeT* pRight_, Compare comp_, NodeT*& pLast_)
+{
+	NodeT _dummy;				// 临时的哨兵节点，省去对第一个节点的特殊处理
+	NodeT* _pTail = &_dummy;
+	while (pLeft_ != nullptr && pRight_ != nullptr)
+	{
+		// 只有右边严格小于左边时才取右边的节点，保证排序的稳定性
+		if (comp_(pRight_->value, pLeft_->value))
+		{
+			_pTail->pNext = pRight_;
+			pRight_ = pRight_->pNext;
+		}
+		else
+		{
+			_pTail->pNext = pLeft_;
+			pLeft_ = pLeft_->pNext;
+		}
+		_pTail = _pTail->pNext;
+	}
+
+	// 把剩余的节点串直接接上去，并找到最后一个节点
+	_pTail->pNext = (pLeft_ != nullptr) ? pLeft_ : pRight_;
+	while (_pTail->pNext != nullptr)
+		_pTail = _pTail->pNext;
+
+	pLast_ = _pTail;
+	return _dummy.pNext;
+}
+
+template <typename T>
+bool LessValue(const T& lhs, const T& rhs)
+{
+	return lhs < rhs;
+}
+
+#endif	// LIST_SORT_H
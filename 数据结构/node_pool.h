@@ -0,0 +1,254 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月24日 星期六 10时12分37秒
+*   Modifed Time: 2026年10月24日 星期六 15时46分02秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+// 链表节点的内存池：链表每插入一个元素就new一个节点，删除时再delete, 频繁插入删除时大部分时间
+// 花在全局的内存分配器上，并且节点散落在堆的各个地方，遍历链表时缓存不友好。
+//
+// 1. node_pool只分配一种固定大小的内存块(一个节点). 它从系统申请一大块内存(chunk), 从中依次切
+// 出节点(移动指针即可，与10-栈式内存分配器.cpp相同), 所以连续插入的节点在内存中也是连续的。
+// 2. 释放的节点不还给系统，而是挂在空闲链表上(链表的指针就存放在节点自己的内存中), 下一次分配
+// 时优先从空闲链表头部取，后进先出，刚释放的节点还在缓存中。空闲链表为空时才继续从chunk中切。
+// 3. 一个chunk用完之后，申请下一个两倍大小的chunk(最大256KB), chunk只在内存池析构时释放。
+// 4. pool_allocator是符合标准库要求的分配器，每种节点类型一个内存池，链表通过模板参数使用它。
+// 一次只分配一个对象时使用内存池，分配多个对象时直接使用::operator new.
+// 5. pool_allocator<T>使用整个进程共享的内存池，加锁访问; pool_allocator<T, true>使用线程局部
+// 的内存池，不需要加锁，但是节点必须在分配它的线程中释放，并且使用它的链表不能比线程活得更长
+// (线程退出时线程局部的内存池就析构了).
+// 6. 内存池析构时如果还有节点没有释放，就不释放chunk(宁可泄漏也不让还在使用的节点失效).
+//
+/*******************    固定大小的内存池        *****************/
+class node_pool
+{
+public:
+	node_pool(size_t nNodeBytes, size_t nAlignment, size_t nFirstChunkBytes = 4096)
+	{
+		if (nAlignment == 0 || (nAlignment & (nAlignment - 1)) != 0)
+		{
+			assert(false);
+			throw std::invalid_argument("参数不合法！");
+		}
+
+		// 空闲的节点中要存放空闲链表的指针，所以节点不能小于一个指针
+		if (nNodeBytes < sizeof(FreeNode))
+			nNodeBytes = sizeof(FreeNode);
+		if (nAlignment < alignof(FreeNode))
+			nAlignment = alignof(FreeNode);
+		m_nNodeBytes = (nNodeBytes + nAlignment - 1) & ~(nAlignment - 1);
+		m_nAlignment = nAlignment;
+		m_nNextChunkBytes = nFirstChunkBytes < m_nNodeBytes ? m_nNodeBytes : nFirstChunkBytes;
+
+		m_pFree = nullptr;
+		m_pTop = nullptr;
+		m_pEnd = nullptr;
+		m_pChunks = nullptr;
+		m_nInUse = 0;
+		m_nCapicity = 0;
+	}
+
+	~node_pool()
+	{
+		if (m_nInUse != 0)
+			return;
+
+		while (m_pChunks != nullptr)
+		{
+			Chunk* _pNext = m_pChunks->m_pNext;
+			::operator delete(m_pChunks);
+			m_pChunks = _pNext;
+		}
+	}
+
+	// 快速路径：从空闲链表头部取一个节点，或者在当前chunk中移动一次指针。
+	// 分配成功之后才增加计数，AllocateSlow()抛出bad_alloc时计数不变。
+	void* allocate()
+	{
+		void* _pNode = nullptr;
+		if (m_pFree != nullptr)
+		{
+			_pNode = m_pFree;
+			m_pFree = m_pFree->m_pNext;
+		}
+		else if (m_pTop != m_pEnd)
+		{
+			_pNode = m_pTop;
+			m_pTop += m_nNodeBytes;
+		}
+		else
+		{
+			_pNode = AllocateSlow();
+		}
+		++m_nInUse;
+		return _pNode;
+	}
+
+	void deallocate(void* p)
+	{
+		FreeNode* _pNode = static_cast<FreeNode*>(p);
+		_pNode->m_pNext = m_pFree;
+		m_pFree = _pNode;
+		--m_nInUse;
+	}
+
+	size_t node_bytes() const { return m_nNodeBytes; }
+	size_t in_use() const { return m_nInUse; }			// 已经分配出去的节点个数
+	size_t capicity() const { return m_nCapicity; }		// 所有chunk一共可以容纳的节点个数
+
+	size_t chunk_count() const
+	{
+		size_t _nCount = 0;
+		for (Chunk* _pChunk = m_pChunks; _pChunk != nullptr; _pChunk = _pChunk->m_pNext)
+			++_nCount;
+		return _nCount;
+	}
+
+private:
+	node_pool(const node_pool&);
+	node_pool& operator=(const node_pool&);
+
+	struct FreeNode
+	{
+		FreeNode* m_pNext;
+	};
+
+	// chunk的头部，节点从头部之后第一个满足对齐要求的地址开始
+	struct Chunk
+	{
+		Chunk* m_pNext;
+	};
+
+	static const size_t s_nMaxChunkBytes = 256 * 1024;
+
+	// 空闲链表与当前chunk都用完了，申请一个新的chunk. 多申请m_nAlignment个字节，用于把第一个节点
+	// 的地址按对齐要求补齐。
+	void* AllocateSlow()
+	{
+		size_t _nNodes = m_nNextChunkBytes / m_nNodeBytes;
+		Chunk* _pChunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + m_nAlignment + _nNodes * m_nNodeBytes));
+		_pChunk->m_pNext = m_pChunks;
+		m_pChunks = _pChunk;
+		m_nCapicity += _nNodes;
+		if (m_nNextChunkBytes < s_nMaxChunkBytes)
+			m_nNextChunkBytes *= 2;
+
+		uintptr_t _nBegin = reinterpret_cast<uintptr_t>(_pChunk + 1);
+		char* _pBegin = reinterpret_cast<char*>((_nBegin + m_nAlignment - 1) & ~(m_nAlignment - 1));
+		m_pTop = _pBegin + m_nNodeBytes;
+		m_pEnd = _pBegin + _nNodes * m_nNodeBytes;
+		return _pBegin;
+	}
+
+	size_t m_nNodeBytes;
+	size_t m_nAlignment;
+	size_t m_nNextChunkBytes;	// 下一个chunk的字节数
+	FreeNode* m_pFree;			// 空闲链表
+	char* m_pTop;				// 当前chunk中下一个没有切出去的节点
+	char* m_pEnd;				// 当前chunk的结束位置
+	Chunk* m_pChunks;			// 所有的chunk, 最新的在最前面
+	size_t m_nInUse;
+	size_t m_nCapicity;
+};
+
+/*******************    使用内存池的分配器        *****************/
+// 分配器本身没有状态，同一种类型的所有分配器共享同一个内存池，所以任意两个分配器都相等，一个链表
+// 的节点可以直接挂到另一个链表上(merge).
+template <typename T, bool bThreadLocal = false>
+class pool_allocator
+{
+public:
+	typedef T value_type;
+
+	// 模板参数中有非类型参数，std::allocator_traits不能自动推导，需要自己提供rebind
+	template <typename U>
+	struct rebind
+	{
+		typedef pool_allocator<U, bThreadLocal> other;
+	};
+
+	pool_allocator() {}
+	template <typename U>
+	pool_allocator(const pool_allocator<U, bThreadLocal>&) {}
+
+	T* allocate(size_t n)
+	{
+		if (n != 1)
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		if (bThreadLocal)
+			return static_cast<T*>(pool().allocate());
+
+		std::lock_guard<std::mutex> _lock(pool_mutex());
+		return static_cast<T*>(pool().allocate());
+	}
+
+	void deallocate(T* p, size_t n)
+	{
+		if (n != 1)
+		{
+			::operator delete(p);
+			return;
+		}
+		if (bThreadLocal)
+		{
+			pool().deallocate(p);
+			return;
+		}
+
+		std::lock_guard<std::mutex> _lock(pool_mutex());
+		pool().deallocate(p);
+	}
+
+	// 当前线程使用的内存池(共享的内存池需要在pool_mutex()的保护下访问)
+	static node_pool& pool()
+	{
+		if (bThreadLocal)
+		{
+			static thread_local node_pool s_pool(sizeof(T), alignof(T));
+			return s_pool;
+		}
+
+		static node_pool s_pool(sizeof(T), alignof(T));
+		return s_pool;
+	}
+
+	static std::mutex& pool_mutex()
+	{
+		static std::mutex s_mutex;
+		return s_mutex;
+	}
+};
+
+template <typename T, typename U, bool bThreadLocal>
+bool operator==(const pool_allocator<T, bThreadLocal>&, const pool_allocator<U, bThreadLocal>&)
+{
+	return true;
+}
+
+template <typename T, typename U, bool bThreadLocal>
+bool operator!=(const pool_allocator<T, bThreadLocal>&, const pool_allocator<U, bThreadLocal>&)
+{
+	return false;
+}
+
+#endif	// NODE_POOL_H
@@ -0,0 +1,42 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月25日 星期日 10时21分36秒
+*   Modifed Time: 2026年10月25日 星期日 10时34分02秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef PAD_RIGHT_H
+#define PAD_RIGHT_H
+#include <cstddef>
+#include <string>
+
+// 输出表格时按显示宽度对齐。std::setw按字节数计算宽度，而一个汉字在UTF-8中占3个字节、显示
+// 宽度为2, 表头中有汉字时就对不齐了。
+
+// 在字符串后面补空格，使它的显示宽度为nWidth_. ASCII字符的显示宽度为1, 其它字符为2.
+inline std::string PadRight(const std::string& str_, size_t nWidth_)
+{
+	size_t _nDisplayWidth = 0;
+	for (size_t i = 0; i < str_.size(); ++i)
+	{
+		// 只在多字节字符的第一个字节(0xC0以上)计算宽度，后续字节(0x80~0xBF)不计算
+		unsigned char _ch = str_[i];
+		if (_ch < 0x80)
+			_nDisplayWidth += 1;
+		else if (_ch >= 0xC0)
+			_nDisplayWidth += 2;
+	}
+	return _nDisplayWidth >= nWidth_ ? str_ : str_ + std::string(nWidth_ - _nDisplayWidth, ' ');
+}
+
+#endif	// PAD_RIGHT_H
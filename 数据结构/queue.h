@@ -0,0 +1,1098 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 19时02分11秒
+*   Modifed Time: 2026年10月23日 星期五 11时08分27秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef QUEUE_H
+#define QUEUE_H
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// 编译时定义QUEUE_STATS(例如g++ -DQUEUE_STATS)时，queue与deque记录每个元素的入队时间，并统计停留
+// 时间、高水位、队满与队空的次数，通过stats()读取; 没有定义时不增加任何代码和成员。
+#ifdef QUEUE_STATS
+#include "queue_stats.h"
+#define QUEUE_STATS_DO(statement) statement
+#else
+#define QUEUE_STATS_DO(statement)
+#endif
+
+// 基于数组实现的单端队列queue, 环形队列ring_queue与双端队列deque, 以及分块的双端队列block_deque,
+// 说明见2-单端队列和双端队列.cpp.
+//
+/*******************    环形数组中的连续区间        *****************/
+// 环形数组中一段连续的元素最多被数组的末尾分为两段：first从起始下标到数组末尾，second从数组开头
+// 开始。peek()返回可以读的元素，reserve()返回可以写的位置，都用queue_spans表示。
+template <typename T>
+struct queue_span
+{
+	T* pData;
+	size_t nCount;
+};
+
+template <typename T>
+struct queue_spans
+{
+	queue_span<T> first;
+	queue_span<T> second;
+
+	size_t size() const { return first.nCount + second.nCount; }
+	T& operator[](size_t nIndex) const
+	{
+		return nIndex < first.nCount ? first.pData[nIndex] : second.pData[nIndex - first.nCount];
+	}
+};
+
+// 从下标nIndex开始的nCount个元素(nCount不超过数组的长度)
+template <typename T>
+queue_spans<T> make_queue_spans(T* pArray, size_t nArrayLength, size_t nIndex, size_t nCount)
+{
+	queue_spans<T> _spans;
+	_spans.first.pData = pArray + nIndex;
+	_spans.first.nCount = std::min(nCount, nArrayLength - nIndex);
+	_spans.second.pData = pArray;
+	_spans.second.nCount = nCount - _spans.first.nCount;
+	return _spans;
+}
+
+/*******************    基于数组来实现单端队列        *****************/
+template <typename T>
+class queue
+{
+public:
+	queue();
+	queue(size_t nCapicity);
+	~queue();
+	void enqueue(const T& value);		// 入队
+	void dequeue();						// 出队
+	T front() const;					// 获取队首元素
+	size_t size() const;				// 队内元素的个数
+	size_t capicity() const;			// 队容量大小
+	bool empty() const;					// 队是否为满
+	bool full() const;					// 队是否为空
+
+	// 不复制元素的读写：peek()返回队内所有的元素，处理完之后release()前nCount个元素出队;
+	// reserve()返回队尾之后最多nCount个空位置，直接写入之后commit()前nCount个位置入队。
+	queue_spans<T> peek();
+	void release(size_t nCount);
+	queue_spans<T> reserve(size_t nCount);
+	void commit(size_t nCount);
+#ifdef QUEUE_STATS
+	const queue_stats& stats() const { return m_stats; }	// 统计信息，其它线程也可以读取
+#endif
+
+private:
+	queue(const queue&);
+	queue& operator=(const queue&);
+
+	size_t m_nArrayLength;				// 底层数组的长度
+	size_t m_nHead;						// 队首元素的下标
+	size_t m_nTail;						// 队尾元素的下一个位置的下标，即指向一个为空的位置
+	T* m_pArray;
+#ifdef QUEUE_STATS
+	uint64_t* m_pEnqueueTimes;			// 与m_pArray一一对应，记录每个元素的入队时间
+	queue_stats m_stats;
+#endif
+};
+
+template <typename T>
+queue<T>::queue()
+{
+	m_nArrayLength = 1001;
+	m_nHead = 0;
+	m_nTail = 0;
+	m_pArray = new T[m_nArrayLength];
+	QUEUE_STATS_DO(m_pEnqueueTimes = new uint64_t[m_nArrayLength]);
+}
+
+template <typename T>
+queue<T>::queue(size_t capicity)
+{
+	m_nArrayLength = capicity + 1;
+	m_nHead = 0;
+	m_nTail = 0;
+	m_pArray = new T[m_nArrayLength];
+	QUEUE_STATS_DO(m_pEnqueueTimes = new uint64_t[m_nArrayLength]);
+}
+
+template <typename T>
+queue<T>::~queue()
+{
+	delete[] m_pArray;
+	m_pArray = nullptr;
+	QUEUE_STATS_DO(delete[] m_pEnqueueTimes);
+}
+
+template <typename T>
+void queue<T>::enqueue(const T& value)
+{
+	// 队列为满判断
+	if ((m_nTail + 1) % m_nArrayLength == m_nHead)
+	{
+		QUEUE_STATS_DO(m_stats.on_full());
+		std::cerr << "队列为满，入队失败" << std::endl;
+		return;
+	}
+
+	m_pArray[m_nTail] = value;
+	QUEUE_STATS_DO(m_pEnqueueTimes[m_nTail] = queue_stats::now());
+	m_nTail = (m_nTail + 1) % m_nArrayLength;
+	QUEUE_STATS_DO(m_stats.on_enqueue(size()));
+}
+
+template <typename T>
+void queue<T>::dequeue()
+{
+	// 队列的空判断
+	if (m_nHead == m_nTail)
+	{
+		QUEUE_STATS_DO(m_stats.on_empty());
+		std::cerr << "队列为空，出队失败" << std::endl;
+		return;
+	}
+
+	QUEUE_STATS_DO(m_stats.on_dequeue(size() - 1, m_pEnqueueTimes[m_nHead]));
+	m_nHead = (m_nHead + 1) % m_nArrayLength;
+}
+
+template <typename T>
+T queue<T>::front() const
+{
+	// 队列为空判断
+	if (m_nHead == m_nTail)
+	{
+		throw std::out_of_range("队列为空，不存在队首的元素。");
+	}
+
+	return m_pArray[m_nHead];
+}
+
+template <typename T>
+queue_spans<T> queue<T>::peek()
+{
+	return make_queue_spans(m_pArray, m_nArrayLength, m_nHead, size());
+}
+
+template <typename T>
+void queue<T>::release(size_t nCount)
+{
+	if (nCount > size())
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+
+#ifdef QUEUE_STATS
+	for (size_t i = 0; i < nCount; ++i)
+		m_stats.on_dequeue(size() - i - 1, m_pEnqueueTimes[(m_nHead + i) % m_nArrayLength]);
+#endif
+	m_nHead = (m_nHead + nCount) % m_nArrayLength;
+}
+
+template <typename T>
+queue_spans<T> queue<T>::reserve(size_t nCount)
+{
+	return make_queue_spans(m_pArray, m_nArrayLength, m_nTail, std::min(nCount, capicity() - size()));
+}
+
+template <typename T>
+void queue<T>::commit(size_t nCount)
+{
+	if (nCount > capicity() - size())
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+
+#ifdef QUEUE_STATS
+	uint64_t _nNow = queue_stats::now();
+	for (size_t i = 0; i < nCount; ++i)
+		m_pEnqueueTimes[(m_nTail + i) % m_nArrayLength] = _nNow;
+#endif
+	m_nTail = (m_nTail + nCount) % m_nArrayLength;
+	QUEUE_STATS_DO(m_stats.on_enqueue(size(), nCount));
+}
+
+template <typename T>
+size_t queue<T>::size() const
+{
+	if (m_nHead <= m_nTail)
+		return m_nTail - m_nHead;
+	else
+		return m_nTail + m_nArrayLength - m_nHead;
+}
+
+template <typename T>
+size_t queue<T>::capicity() const
+{
+	return m_nArrayLength - 1;
+}
+
+template <typename T>
+bool queue<T>::empty() const
+{
+	return m_nHead == m_nTail;
+}
+
+template <typename T>
+bool queue<T>::full() const
+{
+	return (m_nTail + 1) % m_nArrayLength == m_nHead;
+}
+
+/*******************    长度为2的幂的环形队列        *****************/
+template <typename T>
+class ring_queue
+{
+public:
+	ring_queue();
+	ring_queue(size_t nCapicity, bool bGrowable = false);	// 容量向上取为2的幂
+	~ring_queue();
+	bool enqueue(const T& value);						// 入队，队满并且不能增长时返回false
+	size_t enqueue(const T* pValues, size_t nCount);	// 批量入队，返回入队的元素个数
+	void dequeue();										// 出队
+	size_t dequeue(T* pValues, size_t nCount);			// 批量出队，返回出队的元素个数
+	const T& front() const;								// 获取队首元素
+	size_t size() const;								// 队内元素的个数
+	size_t capicity() const;							// 队容量大小
+	bool empty() const;									// 队是否为空
+	bool full() const;									// 队是否为满
+	bool growable() const;								// 队满时是否自动增长
+
+	// 不复制元素的读写，与queue<T>相同; 可增长的队列在reserve()时空位置不够会先增长
+	queue_spans<T> peek();
+	void release(size_t nCount);
+	queue_spans<T> reserve(size_t nCount);
+	void commit(size_t nCount);
+
+private:
+	ring_queue(const ring_queue&);
+	ring_queue& operator=(const ring_queue&);
+
+	static size_t RoundUpToPowerOfTwo(size_t nValue);
+	static void CopyElements(T* pDest, const T* pSource, size_t nCount);
+	// 容量扩大到不小于nMinCapicity, 并把pValues开始的nCount个元素入队
+	void grow(size_t nMinCapicity, const T* pValues = nullptr, size_t nCount = 0);
+
+	size_t m_nMask;						// 数组的长度减1, 数组的长度为2的幂
+	size_t m_nHead;						// 队首元素的序号，一直增加，与m_nMask相与得到下标
+	size_t m_nTail;						// 队尾元素的下一个序号
+	T* m_pArray;
+	bool m_bGrowable;
+};
+
+template <typename T>
+ring_queue<T>::ring_queue()
+{
+	m_nMask = 1024 - 1;
+	m_nHead = 0;
+	m_nTail = 0;
+	m_pArray = new T[m_nMask + 1];
+	m_bGrowable = false;
+}
+
+template <typename T>
+ring_queue<T>::ring_queue(size_t capicity, bool bGrowable)
+{
+	m_nMask = RoundUpToPowerOfTwo(capicity) - 1;
+	m_nHead = 0;
+	m_nTail = 0;
+	m_pArray = new T[m_nMask + 1];
+	m_bGrowable = bGrowable;
+}
+
+template <typename T>
+ring_queue<T>::~ring_queue()
+{
+	delete[] m_pArray;
+	m_pArray = nullptr;
+}
+
+template <typename T>
+bool ring_queue<T>::enqueue(const T& value)
+{
+	// 队列为满判断
+	if (m_nTail - m_nHead > m_nMask)
+	{
+		if (!m_bGrowable)
+			return false;
+		grow(m_nMask + 2, &value, 1);
+		return true;
+	}
+
+	m_pArray[m_nTail & m_nMask] = value;
+	++m_nTail;
+	return true;
+}
+
+// 队尾到数组末尾为第一段，剩下的从数组开头开始为第二段
+template <typename T>
+size_t ring_queue<T>::enqueue(const T* pValues, size_t nCount)
+{
+	if (nCount > m_nMask + 1 - size())
+	{
+		if (m_bGrowable)
+		{
+			grow(size() + nCount, pValues, nCount);
+			return nCount;
+		}
+		nCount = m_nMask + 1 - size();
+	}
+
+	size_t _nIndex = m_nTail & m_nMask;
+	size_t _nFirst = std::min(nCount, m_nMask + 1 - _nIndex);
+	CopyElements(m_pArray + _nIndex, pValues, _nFirst);
+	CopyElements(m_pArray, pValues + _nFirst, nCount - _nFirst);
+	m_nTail += nCount;
+	return nCount;
+}
+
+template <typename T>
+void ring_queue<T>::dequeue()
+{
+	// 队列的空判断
+	if (m_nHead == m_nTail)
+	{
+		std::cerr << "队列为空，出队失败" << std::endl;
+		return;
+	}
+
+	++m_nHead;
+}
+
+template <typename T>
+size_t ring_queue<T>::dequeue(T* pValues, size_t nCount)
+{
+	nCount = std::min(nCount, size());
+	size_t _nIndex = m_nHead & m_nMask;
+	size_t _nFirst = std::min(nCount, m_nMask + 1 - _nIndex);
+	CopyElements(pValues, m_pArray + _nIndex, _nFirst);
+	CopyElements(pValues + _nFirst, m_pArray, nCount - _nFirst);
+	m_nHead += nCount;
+	return nCount;
+}
+
+template <typename T>
+const T& ring_queue<T>::front() const
+{
+	// 队列为空判断
+	if (m_nHead == m_nTail)
+	{
+		throw std::out_of_range("队列为空，不存在队首的元素。");
+	}
+
+	return m_pArray[m_nHead & m_nMask];
+}
+
+template <typename T>
+queue_spans<T> ring_queue<T>::peek()
+{
+	return make_queue_spans(m_pArray, m_nMask + 1, m_nHead & m_nMask, size());
+}
+
+template <typename T>
+void ring_queue<T>::release(size_t nCount)
+{
+	if (nCount > size())
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+	m_nHead += nCount;
+}
+
+template <typename T>
+queue_spans<T> ring_queue<T>::reserve(size_t nCount)
+{
+	if (nCount > m_nMask + 1 - size() && m_bGrowable)
+		grow(size() + nCount);
+	return make_queue_spans(m_pArray, m_nMask + 1, m_nTail & m_nMask, std::min(nCount, m_nMask + 1 - size()));
+}
+
+template <typename T>
+void ring_queue<T>::commit(size_t nCount)
+{
+	if (nCount > m_nMask + 1 - size())
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+	m_nTail += nCount;
+}
+
+template <typename T>
+size_t ring_queue<T>::size() const
+{
+	return m_nTail - m_nHead;
+}
+
+template <typename T>
+size_t ring_queue<T>::capicity() const
+{
+	return m_nMask + 1;
+}
+
+template <typename T>
+bool ring_queue<T>::empty() const
+{
+	return m_nHead == m_nTail;
+}
+
+template <typename T>
+bool ring_queue<T>::full() const
+{
+	return m_nTail - m_nHead > m_nMask;
+}
+
+template <typename T>
+bool ring_queue<T>::growable() const
+{
+	return m_bGrowable;
+}
+
+template <typename T>
+size_t ring_queue<T>::RoundUpToPowerOfTwo(size_t nValue)
+{
+	size_t _nResult = 1;
+	while (_nResult < nValue)
+		_nResult <<= 1;
+	return _nResult;
+}
+
+// 可以按字节拷贝的类型使用memcpy, 其它类型逐个赋值
+template <typename T>
+void ring_queue<T>::CopyElements(T* pDest, const T* pSource, size_t nCount)
+{
+	if (nCount == 0)
+		return;
+	if (std::is_trivially_copyable<T>::value)
+		std::memcpy(static_cast<void*>(pDest), static_cast<const void*>(pSource), nCount * sizeof(T));
+	else
+		std::copy(pSource, pSource + nCount, pDest);
+}
+
+// 新的数组从下标0开始存放原来的元素，原来的元素最多分为两段，新入队的元素接在后面。
+// pValues可能指向队列中的元素(例如enqueue(front())), 所以新元素也要在释放原来的数组之前复制。
+template <typename T>
+void ring_queue<T>::grow(size_t nMinCapicity, const T* pValues, size_t nCount)
+{
+	size_t _nSize = size();
+	size_t _nCapicity = RoundUpToPowerOfTwo(std::max(nMinCapicity, 2 * (m_nMask + 1)));
+	T* _pNewArray = new T[_nCapicity];
+	try
+	{
+		size_t _nIndex = m_nHead & m_nMask;
+		size_t _nFirst = std::min(_nSize, m_nMask + 1 - _nIndex);
+		CopyElements(_pNewArray, m_pArray + _nIndex, _nFirst);
+		CopyElements(_pNewArray + _nFirst, m_pArray, _nSize - _nFirst);
+		CopyElements(_pNewArray + _nSize, pValues, nCount);
+	}
+	catch (...)
+	{
+		delete[] _pNewArray;
+		throw;
+	}
+
+	delete[] m_pArray;
+	m_pArray = _pNewArray;
+	m_nMask = _nCapicity - 1;
+	m_nHead = 0;
+	m_nTail = _nSize + nCount;
+}
+
+/*******************    基于数组来实现双端队列        *****************/
+template <typename T>
+class deque
+{
+public:
+	deque();
+	deque(size_t nCapicity);
+	~deque();
+	void push_front(const T& value);	// 队首入队
+	void pop_front();		  	  		// 队首出队
+	T front() const;		  	  		// 队首元素
+	void push_back(const T& value);		// 队尾入队
+	void pop_back();		  	  		// 队尾出队
+	T back() const;			  	  		// 队尾元素
+	size_t size() const;	 		  	// 队内元素的个数
+	size_t capicity() const;			// 队容量大小
+	bool empty()const;					// 队是否为满
+	bool full() const;					// 队是否为空
+
+	// 不复制元素的读写，与queue<T>相同：从队首读出(peek/release), 在队尾写入(reserve/commit)
+	queue_spans<T> peek();
+	void release(size_t nCount);
+	queue_spans<T> reserve(size_t nCount);
+	void commit(size_t nCount);
+#ifdef QUEUE_STATS
+	const queue_stats& stats() const { return m_stats; }	// 统计信息，其它线程也可以读取
+#endif
+                                                                                         
+private:                                                                                 
+	deque(const deque&);
+	deque& operator=(const deque&);
+
+	size_t m_nArrayLength;          // 底层数组的长度
+	size_t m_nHead;                 // 队首元素的下标
+	size_t m_nTail;                 // 队尾元素的下一个位置的下标，即指向一个为空的位置
+	T* m_pArray;
+#ifdef QUEUE_STATS
+	uint64_t* m_pEnqueueTimes;		// 与m_pArray一一对应，记录每个元素的入队时间
+	queue_stats m_stats;
+#endif
+};
+
+template <typename T>
+deque<T>::deque()
+{
+	m_nArrayLength = 1001;
+	m_nHead = 0;
+	m_nTail = 0;
+	m_pArray = new T[m_nArrayLength];
+	QUEUE_STATS_DO(m_pEnqueueTimes = new uint64_t[m_nArrayLength]);
+}
+
+template <typename T>
+deque<T>::deque(size_t capicity)
+{
+	m_nArrayLength = capicity + 1;
+	m_nHead = 0;
+	m_nTail = 0;
+	m_pArray = new T[m_nArrayLength];
+	QUEUE_STATS_DO(m_pEnqueueTimes = new uint64_t[m_nArrayLength]);
+}
+
+template <typename T>
+deque<T>::~deque()
+{
+	delete[] m_pArray;
+	m_pArray = nullptr;
+	QUEUE_STATS_DO(delete[] m_pEnqueueTimes);
+}
+
+template <typename T>
+void deque<T>::push_front(const T& value)
+{
+	// 队列为满判断
+	if ((m_nTail + 1) % m_nArrayLength == m_nHead)
+	{
+		QUEUE_STATS_DO(m_stats.on_full());
+		std::cerr << "队列为满，本次在队首入队失败" << std::endl;
+		return;
+	}
+
+	m_nHead = (m_nHead  + m_nArrayLength - 1) % m_nArrayLength;
+	m_pArray[m_nHead] = value;
+	QUEUE_STATS_DO(m_pEnqueueTimes[m_nHead] = queue_stats::now());
+	QUEUE_STATS_DO(m_stats.on_enqueue(size()));
+}
+
+template <typename T>
+void deque<T>::pop_front()
+{
+	// 队列为空判断
+	if (m_nHead == m_nTail)
+	{
+		QUEUE_STATS_DO(m_stats.on_empty());
+		std::cerr << "队列为空，本次在队首出队失败。" << std::endl;
+		return;
+	}
+
+	QUEUE_STATS_DO(m_stats.on_dequeue(size() - 1, m_pEnqueueTimes[m_nHead]));
+	m_nHead = (m_nHead + 1) % m_nArrayLength;
+}
+
+template <typename T>
+T deque<T>::front() const
+{
+	// 队列为空时，抛出异常
+	if (m_nHead == m_nTail)
+	{
+		throw std::out_of_range("队列为空，不存在队首元素");
+	}
+
+	return m_pArray[m_nHead];
+}
+
+template <typename T>
+void deque<T>::push_back(const T& value)
+{
+	// 队列为满判断
+	if ((m_nTail + 1) % m_nArrayLength == m_nHead)
+	{
+		QUEUE_STATS_DO(m_stats.on_full());
+		std::cerr << "队列为满，本次在队尾入队失败" << std::endl;
+		return;
+	}
+
+	m_pArray[m_nTail] = value;
+	QUEUE_STATS_DO(m_pEnqueueTimes[m_nTail] = queue_stats::now());
+	m_nTail = (m_nTail + 1) % m_nArrayLength;
+	QUEUE_STATS_DO(m_stats.on_enqueue(size()));
+}
+
+template <typename T>
+void deque<T>::pop_back()
+{
+	// 队列为空判断
+	if (m_nHead == m_nTail)
+	{
+		QUEUE_STATS_DO(m_stats.on_empty());
+		std::cerr << "队列为空，本次在队尾出队失败。" << std::endl;
+		return;
+	}
+
+	m_nTail = (m_nTail + m_nArrayLength - 1) % m_nArrayLength;
+	QUEUE_STATS_DO(m_stats.on_dequeue(size(), m_pEnqueueTimes[m_nTail]));
+}
+
+template <typename T>
+T deque<T>::back() const
+{
+	// 队列为空时，抛出异常
+	if (m_nHead == m_nTail)
+	{
+		throw std::out_of_range("队列为空，不存在队尾元素");
+	}
+
+	size_t _nIndex = (m_nTail + m_nArrayLength - 1) % m_nArrayLength;
+	return m_pArray[_nIndex];
+}
+
+template <typename T>
+queue_spans<T> deque<T>::peek()
+{
+	return make_queue_spans(m_pArray, m_nArrayLength, m_nHead, size());
+}
+
+template <typename T>
+void deque<T>::release(size_t nCount)
+{
+	if (nCount > size())
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+
+#ifdef QUEUE_STATS
+	for (size_t i = 0; i < nCount; ++i)
+		m_stats.on_dequeue(size() - i - 1, m_pEnqueueTimes[(m_nHead + i) % m_nArrayLength]);
+#endif
+	m_nHead = (m_nHead + nCount) % m_nArrayLength;
+}
+
+template <typename T>
+queue_spans<T> deque<T>::reserve(size_t nCount)
+{
+	return make_queue_spans(m_pArray, m_nArrayLength, m_nTail, std::min(nCount, capicity() - size()));
+}
+
+template <typename T>
+void deque<T>::commit(size_t nCount)
+{
+	if (nCount > capicity() - size())
+	{
+		assert(false);
+		throw std::invalid_argument("参数不合法！");
+	}
+
+#ifdef QUEUE_STATS
+	uint64_t _nNow = queue_stats::now();
+	for (size_t i = 0; i < nCount; ++i)
+		m_pEnqueueTimes[(m_nTail + i) % m_nArrayLength] = _nNow;
+#endif
+	m_nTail = (m_nTail + nCount) % m_nArrayLength;
+	QUEUE_STATS_DO(m_stats.on_enqueue(size(), nCount));
+}
+
+template <typename T>
+size_t deque<T>::size() const
+{
+	if (m_nHead <= m_nTail)
+		return m_nTail - m_nHead;
+	else
+		return m_nTail + m_nArrayLength - m_nHead;
+}
+
+template <typename T>
+size_t deque<T>::capicity() const
+{
+	return m_nArrayLength - 1;
+}
+
+template <typename T>
+bool deque<T>::empty() const
+{
+	return m_nHead == m_nTail;
+}
+
+template <typename T>
+bool deque<T>::full() const
+{
+	return (m_nTail + 1) % m_nArrayLength == m_nHead;
+}
+
+/*******************    分块的双端队列        *****************/
+// 元素存放在固定大小(BlockSize个元素, 必须是2的幂)的内存块中，map是一个存放内存块指针的环形数组。
+// 两端入队时只可能申请新的内存块或者让map增长，map增长时只复制内存块的指针，元素一旦入队，
+// 在出队之前不会被移动。
+template <typename T, size_t BlockSize = 512>
+class block_deque
+{
+	template <typename U, typename Deque>
+	class basic_iterator;
+
+public:
+	typedef basic_iterator<T, block_deque> iterator;
+	typedef basic_iterator<const T, const block_deque> const_iterator;
+
+	block_deque();
+	~block_deque();
+	void push_front(const T& value);	// 队首入队
+	void push_front(T&& value);
+	void pop_front();		  	  		// 队首出队
+	T& front();		  	  				// 队首元素
+	const T& front() const;
+	void push_back(const T& value);		// 队尾入队
+	void push_back(T&& value);
+	void pop_back();		  	  		// 队尾出队
+	T& back();			  	  			// 队尾元素
+	const T& back() const;
+	T& operator[](size_t nIndex);		// 第nIndex个元素，不检查下标
+	const T& operator[](size_t nIndex) const;
+	void clear();
+	size_t size() const;	 		  	// 队内元素的个数
+	bool empty() const;					// 队是否为空
+	size_t block_count() const;			// 正在使用的内存块的个数(不包括备用的内存块)
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, m_nSize); }
+	const_iterator begin() const { return const_iterator(this, 0); }
+	const_iterator end() const { return const_iterator(this, m_nSize); }
+
+private:
+	block_deque(const block_deque&);
+	block_deque& operator=(const block_deque&);
+
+	static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0, "BlockSize必须是2的幂");
+
+	struct Block
+	{
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type m_elements[BlockSize];
+		T* Begin() { return reinterpret_cast<T*>(m_elements); }
+	};
+
+	T* address(size_t nIndex) const;
+	Block*& block_at(size_t nBlock) const;	// 从队首所在的内存块开始的第nBlock个内存块
+	size_t used_blocks() const;
+	void add_block_back();
+	void add_block_front();
+	void release_block(Block* pBlock);
+	void grow_map();
+
+	Block** m_ppMap;
+	size_t m_nMapMask;		// map的长度减1, map的长度为2的幂
+	size_t m_nFirstBlock;	// 队首元素所在的内存块在map中的下标
+	size_t m_nOffset;		// 队首元素在它的内存块中的下标
+	size_t m_nSize;
+	Block* m_pSpareBlock;	// 出队时空出来的内存块留作备用，避免在内存块的边界上反复申请释放
+};
+
+// 迭代器只记录下标，解引用时通过operator[]找到元素
+template <typename T, size_t BlockSize>
+template <typename U, typename Deque>
+class block_deque<T, BlockSize>::basic_iterator
+{
+public:
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef typename std::remove_const<U>::type value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef U* pointer;
+	typedef U& reference;
+
+	basic_iterator() : m_pDeque(nullptr), m_nIndex(0) {}
+	basic_iterator(Deque* pDeque, size_t nIndex) : m_pDeque(pDeque), m_nIndex(nIndex) {}
+
+	U& operator*() const { return (*m_pDeque)[m_nIndex]; }
+	U* operator->() const { return &(*m_pDeque)[m_nIndex]; }
+	U& operator[](difference_type n) const { return (*m_pDeque)[m_nIndex + n]; }
+	basic_iterator& operator++() { ++m_nIndex; return *this; }
+	basic_iterator operator++(int) { basic_iterator _old(*this); ++m_nIndex; return _old; }
+	basic_iterator& operator--() { --m_nIndex; return *this; }
+	basic_iterator operator--(int) { basic_iterator _old(*this); --m_nIndex; return _old; }
+	basic_iterator& operator+=(difference_type n) { m_nIndex += n; return *this; }
+	basic_iterator& operator-=(difference_type n) { m_nIndex -= n; return *this; }
+	basic_iterator operator+(difference_type n) const { return basic_iterator(m_pDeque, m_nIndex + n); }
+	basic_iterator operator-(difference_type n) const { return basic_iterator(m_pDeque, m_nIndex - n); }
+	difference_type operator-(const basic_iterator& other) const
+	{
+		return static_cast<difference_type>(m_nIndex) - static_cast<difference_type>(other.m_nIndex);
+	}
+	bool operator==(const basic_iterator& other) const { return m_nIndex == other.m_nIndex; }
+	bool operator!=(const basic_iterator& other) const { return m_nIndex != other.m_nIndex; }
+	bool operator<(const basic_iterator& other) const { return m_nIndex < other.m_nIndex; }
+	bool operator>(const basic_iterator& other) const { return m_nIndex > other.m_nIndex; }
+	bool operator<=(const basic_iterator& other) const { return m_nIndex <= other.m_nIndex; }
+	bool operator>=(const basic_iterator& other) const { return m_nIndex >= other.m_nIndex; }
+
+private:
+	Deque* m_pDeque;
+	size_t m_nIndex;
+};
+
+template <typename T, size_t BlockSize>
+block_deque<T, BlockSize>::block_deque()
+{
+	m_nMapMask = 7;
+	m_ppMap = new Block*[m_nMapMask + 1];
+	m_nFirstBlock = 0;
+	m_nOffset = 0;
+	m_nSize = 0;
+	m_pSpareBlock = nullptr;
+}
+
+template <typename T, size_t BlockSize>
+block_deque<T, BlockSize>::~block_deque()
+{
+	clear();
+	delete m_pSpareBlock;
+	delete[] m_ppMap;
+	m_ppMap = nullptr;
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::push_front(const T& value)
+{
+	push_front(T(value));
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::push_front(T&& value)
+{
+	if (m_nOffset == 0)
+		add_block_front();
+	::new (static_cast<void*>(block_at(0)->Begin() + m_nOffset - 1)) T(std::move(value));
+	--m_nOffset;
+	++m_nSize;
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::pop_front()
+{
+	// 队列为空判断
+	if (m_nSize == 0)
+	{
+		std::cerr << "队列为空，本次在队首出队失败。" << std::endl;
+		return;
+	}
+
+	address(0)->~T();
+	++m_nOffset;
+	--m_nSize;
+	if (m_nSize == 0 || m_nOffset == BlockSize)
+	{
+		release_block(block_at(0));
+		m_nFirstBlock = (m_nFirstBlock + 1) & m_nMapMask;
+		m_nOffset = 0;
+	}
+}
+
+template <typename T, size_t BlockSize>
+T& block_deque<T, BlockSize>::front()
+{
+	// 队列为空时，抛出异常
+	if (m_nSize == 0)
+		throw std::out_of_range("队列为空，不存在队首元素");
+	return *address(0);
+}
+
+template <typename T, size_t BlockSize>
+const T& block_deque<T, BlockSize>::front() const
+{
+	if (m_nSize == 0)
+		throw std::out_of_range("队列为空，不存在队首元素");
+	return *address(0);
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::push_back(const T& value)
+{
+	push_back(T(value));
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::push_back(T&& value)
+{
+	if (((m_nOffset + m_nSize) & (BlockSize - 1)) == 0)
+		add_block_back();
+	::new (static_cast<void*>(address(m_nSize))) T(std::move(value));
+	++m_nSize;
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::pop_back()
+{
+	// 队列为空判断
+	if (m_nSize == 0)
+	{
+		std::cerr << "队列为空，本次在队尾出队失败。" << std::endl;
+		return;
+	}
+
+	--m_nSize;
+	address(m_nSize)->~T();
+	if (m_nSize == 0)
+	{
+		release_block(block_at(0));
+		m_nOffset = 0;
+	}
+	else if (((m_nOffset + m_nSize) & (BlockSize - 1)) == 0)
+	{
+		release_block(block_at((m_nOffset + m_nSize) / BlockSize));
+	}
+}
+
+template <typename T, size_t BlockSize>
+T& block_deque<T, BlockSize>::back()
+{
+	// 队列为空时，抛出异常
+	if (m_nSize == 0)
+		throw std::out_of_range("队列为空，不存在队尾元素");
+	return *address(m_nSize - 1);
+}
+
+template <typename T, size_t BlockSize>
+const T& block_deque<T, BlockSize>::back() const
+{
+	if (m_nSize == 0)
+		throw std::out_of_range("队列为空，不存在队尾元素");
+	return *address(m_nSize - 1);
+}
+
+template <typename T, size_t BlockSize>
+T& block_deque<T, BlockSize>::operator[](size_t nIndex)
+{
+	return *address(nIndex);
+}
+
+template <typename T, size_t BlockSize>
+const T& block_deque<T, BlockSize>::operator[](size_t nIndex) const
+{
+	return *address(nIndex);
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::clear()
+{
+	while (m_nSize > 0)
+		pop_back();
+}
+
+template <typename T, size_t BlockSize>
+size_t block_deque<T, BlockSize>::size() const
+{
+	return m_nSize;
+}
+
+template <typename T, size_t BlockSize>
+bool block_deque<T, BlockSize>::empty() const
+{
+	return m_nSize == 0;
+}
+
+template <typename T, size_t BlockSize>
+size_t block_deque<T, BlockSize>::block_count() const
+{
+	return used_blocks();
+}
+
+// BlockSize是2的幂，除法与取模都是移位与与运算
+template <typename T, size_t BlockSize>
+T* block_deque<T, BlockSize>::address(size_t nIndex) const
+{
+	size_t _nPos = m_nOffset + nIndex;
+	return block_at(_nPos / BlockSize)->Begin() + (_nPos & (BlockSize - 1));
+}
+
+template <typename T, size_t BlockSize>
+typename block_deque<T, BlockSize>::Block*& block_deque<T, BlockSize>::block_at(size_t nBlock) const
+{
+	return m_ppMap[(m_nFirstBlock + nBlock) & m_nMapMask];
+}
+
+// 队列为空时不占用内存块
+template <typename T, size_t BlockSize>
+size_t block_deque<T, BlockSize>::used_blocks() const
+{
+	return m_nSize == 0 ? 0 : (m_nOffset + m_nSize + BlockSize - 1) / BlockSize;
+}
+
+// 优先使用备用的内存块，没有时才申请新的内存块
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::add_block_back()
+{
+	size_t _nUsed = used_blocks();
+	if (_nUsed > m_nMapMask)
+		grow_map();
+	Block* _pBlock = m_pSpareBlock != nullptr ? m_pSpareBlock : new Block;
+	m_pSpareBlock = nullptr;
+	block_at(_nUsed) = _pBlock;
+}
+
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::add_block_front()
+{
+	if (used_blocks() > m_nMapMask)
+		grow_map();
+	Block* _pBlock = m_pSpareBlock != nullptr ? m_pSpareBlock : new Block;
+	m_pSpareBlock = nullptr;
+	m_nFirstBlock = (m_nFirstBlock + m_nMapMask) & m_nMapMask;
+	block_at(0) = _pBlock;
+	m_nOffset = BlockSize;
+}
+
+// 最多只保留一个备用的内存块，滑动窗口这样一端入队一端出队的用法正好循环使用它
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::release_block(Block* pBlock)
+{
+	delete m_pSpareBlock;
+	m_pSpareBlock = pBlock;
+}
+
+// map的长度扩大为两倍，只复制正在使用的内存块的指针
+template <typename T, size_t BlockSize>
+void block_deque<T, BlockSize>::grow_map()
+{
+	size_t _nUsed = used_blocks();
+	size_t _nMapLength = (m_nMapMask + 1) * 2;
+	Block** _ppNewMap = new Block*[_nMapLength];
+	for (size_t i = 0; i < _nUsed; ++i)
+		_ppNewMap[i] = block_at(i);
+
+	delete[] m_ppMap;
+	m_ppMap = _ppNewMap;
+	m_nMapMask = _nMapLength - 1;
+	m_nFirstBlock = 0;
+}
+
+#endif	// QUEUE_H
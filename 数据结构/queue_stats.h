@@ -0,0 +1,213 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月22日 星期四 16时20分09秒
+*   Modifed Time: 2026年10月23日 星期五 11时08分27秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef QUEUE_STATS_H
+#define QUEUE_STATS_H
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// 队列的统计信息：元素在队列中停留的时间(sojourn time)的直方图、队列长度的最大值(高水位)、
+// 入队时队满与出队时队空的次数。只有在编译时定义了QUEUE_STATS时queue.h才使用它，没有定义时
+// queue与deque中没有任何统计的代码和成员。
+//
+// 统计信息只由操作队列的线程修改(队列本身不是线程安全的，多个线程使用时外面有锁，同一时刻只有
+// 一个线程在修改), 任何线程都可以随时调用snapshot()读取。所有的计数都是原子变量，修改时使用
+// relaxed的读出再写入，而不是fetch_add, 在x86上就是普通的读写指令，读取的一方不会阻塞修改的一方。
+//
+/*******************    停留时间的直方图        *****************/
+// 与HdrHistogram相同的对数-线性分桶：小于32的值每个值一个桶; 之后每个2的幂的区间[2^k, 2^(k+1))
+// 再平均分为32个桶，所以任何值的相对误差都不超过1/32(约3%). 最大记录2^44纳秒(约4.9小时),
+// 更大的值记在最后一个桶中。一共1280个桶。
+class latency_histogram
+{
+public:
+	static const int s_nSubBucketBits = 5;
+	static const uint64_t s_nSubBuckets = 1 << s_nSubBucketBits;
+	static const int s_nMaxBits = 44;
+	static const size_t s_nBuckets = s_nSubBuckets * (s_nMaxBits - s_nSubBucketBits + 1);
+
+	latency_histogram()
+	{
+		for (size_t i = 0; i < s_nBuckets; ++i)
+			m_counts[i].store(0, std::memory_order_relaxed);
+		m_nCount.store(0, std::memory_order_relaxed);
+		m_nMax.store(0, std::memory_order_relaxed);
+	}
+
+	void record(uint64_t nValue)
+	{
+		Increase(m_counts[index_of(nValue)]);
+		Increase(m_nCount);
+		if (nValue > m_nMax.load(std::memory_order_relaxed))
+			m_nMax.store(nValue, std::memory_order_relaxed);
+	}
+
+	uint64_t count() const { return m_nCount.load(std::memory_order_relaxed); }
+	uint64_t max() const { return m_nMax.load(std::memory_order_relaxed); }
+
+	// 返回第dQuantile分位数(0到1之间)所在的桶的中间值; 修改的同时读取时结果是近似的
+	uint64_t percentile(double dQuantile) const
+	{
+		uint64_t _nTotal = 0;
+		for (size_t i = 0; i < s_nBuckets; ++i)
+			_nTotal += m_counts[i].load(std::memory_order_relaxed);
+		if (_nTotal == 0)
+			return 0;
+
+		uint64_t _nRank = static_cast<uint64_t>(dQuantile * (_nTotal - 1)) + 1;
+		uint64_t _nSeen = 0;
+		for (size_t i = 0; i < s_nBuckets; ++i)
+		{
+			_nSeen += m_counts[i].load(std::memory_order_relaxed);
+			if (_nSeen >= _nRank)
+				return lower_bound_of(i) + width_of(i) / 2;
+		}
+		return max();
+	}
+
+	static size_t index_of(uint64_t nValue)
+	{
+		if (nValue < s_nSubBuckets)
+			return static_cast<size_t>(nValue);
+		int _nMsb = 63 - __builtin_clzll(nValue);
+		if (_nMsb >= s_nMaxBits)
+			return s_nBuckets - 1;
+		uint64_t _nSub = (nValue >> (_nMsb - s_nSubBucketBits)) - s_nSubBuckets;
+		return static_cast<size_t>(s_nSubBuckets * (_nMsb - s_nSubBucketBits + 1) + _nSub);
+	}
+
+	static uint64_t lower_bound_of(size_t nIndex)
+	{
+		if (nIndex < s_nSubBuckets)
+			return nIndex;
+		size_t _nGroup = nIndex / s_nSubBuckets;
+		return (s_nSubBuckets + nIndex % s_nSubBuckets) << (_nGroup - 1);
+	}
+
+	static uint64_t width_of(size_t nIndex)
+	{
+		return nIndex < s_nSubBuckets ? 1 : uint64_t(1) << (nIndex / s_nSubBuckets - 1);
+	}
+
+private:
+	latency_histogram(const latency_histogram&);
+	latency_histogram& operator=(const latency_histogram&);
+
+	static void Increase(std::atomic<uint64_t>& counter)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	std::atomic<uint64_t> m_counts[s_nBuckets];
+	std::atomic<uint64_t> m_nCount;
+	std::atomic<uint64_t> m_nMax;
+};
+
+/*******************    队列的统计信息        *****************/
+struct queue_stats_snapshot
+{
+	uint64_t nEnqueues;
+	uint64_t nDequeues;
+	uint64_t nFullEvents;		// 队满时入队失败的次数
+	uint64_t nEmptyEvents;		// 队空时出队失败的次数
+	uint64_t nDepth;			// 当前队列的长度
+	uint64_t nHighWater;		// 队列长度的最大值
+	uint64_t nP50;				// 停留时间的分位数与最大值，单位为纳秒
+	uint64_t nP99;
+	uint64_t nP999;
+	uint64_t nMax;
+};
+
+class queue_stats
+{
+public:
+	queue_stats()
+	{
+		m_nEnqueues.store(0, std::memory_order_relaxed);
+		m_nDequeues.store(0, std::memory_order_relaxed);
+		m_nFullEvents.store(0, std::memory_order_relaxed);
+		m_nEmptyEvents.store(0, std::memory_order_relaxed);
+		m_nDepth.store(0, std::memory_order_relaxed);
+		m_nHighWater.store(0, std::memory_order_relaxed);
+	}
+
+	static uint64_t now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// 以下函数由操作队列的线程调用，nDepth为操作之后队列的长度, nCount为一次入队的元素个数
+	void on_enqueue(uint64_t nDepth, uint64_t nCount = 1)
+	{
+		m_nEnqueues.store(m_nEnqueues.load(std::memory_order_relaxed) + nCount, std::memory_order_relaxed);
+		m_nDepth.store(nDepth, std::memory_order_relaxed);
+		if (nDepth > m_nHighWater.load(std::memory_order_relaxed))
+			m_nHighWater.store(nDepth, std::memory_order_relaxed);
+	}
+
+	void on_dequeue(uint64_t nDepth, uint64_t nEnqueueTime)
+	{
+		Increase(m_nDequeues);
+		m_nDepth.store(nDepth, std::memory_order_relaxed);
+		uint64_t _nNow = now();
+		m_sojourn.record(_nNow > nEnqueueTime ? _nNow - nEnqueueTime : 0);
+	}
+
+	void on_full() { Increase(m_nFullEvents); }
+	void on_empty() { Increase(m_nEmptyEvents); }
+
+	// 任何线程都可以调用，只读取原子变量，不会阻塞修改的一方
+	queue_stats_snapshot snapshot() const
+	{
+		queue_stats_snapshot _snapshot;
+		_snapshot.nEnqueues = m_nEnqueues.load(std::memory_order_relaxed);
+		_snapshot.nDequeues = m_nDequeues.load(std::memory_order_relaxed);
+		_snapshot.nFullEvents = m_nFullEvents.load(std::memory_order_relaxed);
+		_snapshot.nEmptyEvents = m_nEmptyEvents.load(std::memory_order_relaxed);
+		_snapshot.nDepth = m_nDepth.load(std::memory_order_relaxed);
+		_snapshot.nHighWater = m_nHighWater.load(std::memory_order_relaxed);
+		_snapshot.nP50 = m_sojourn.percentile(0.5);
+		_snapshot.nP99 = m_sojourn.percentile(0.99);
+		_snapshot.nP999 = m_sojourn.percentile(0.999);
+		_snapshot.nMax = m_sojourn.max();
+		return _snapshot;
+	}
+
+	const latency_histogram& sojourn() const { return m_sojourn; }
+
+private:
+	queue_stats(const queue_stats&);
+	queue_stats& operator=(const queue_stats&);
+
+	static void Increase(std::atomic<uint64_t>& counter)
+	{
+		counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	std::atomic<uint64_t> m_nEnqueues;
+	std::atomic<uint64_t> m_nDequeues;
+	std::atomic<uint64_t> m_nFullEvents;
+	std::atomic<uint64_t> m_nEmptyEvents;
+	std::atomic<uint64_t> m_nDepth;
+	std::atomic<uint64_t> m_nHighWater;
+	latency_histogram m_sojourn;
+};
+
+#endif	// QUEUE_STATS_H
@@ -0,0 +1,502 @@
+/***********************************************************************
+*   Copyright (C) 2019  Yinheyi. <chinayinheyi@163.com>
+*   
+* This program is free software; you can redistribute it and/or modify it under the terms
+* of the GNU General Public License as published by the Free Software Foundation; either 
+* version 2 of the License, or (at your option) any later version.
+
+*   Brief:    
+*   Author: yinheyi
+*   Email: chinayinheyi@163.com
+*   Version: 1.0
+*   Created Time: 2026年10月20日 星期二 13时12分40秒
+*   Modifed Time: 2026年10月20日 星期二 14时05分17秒
+*   Blog: http://www.cnblogs.com/yinheyi
+*   Github: https://github.com/yinheyi
+*   
+***********************************************************************/
+#ifndef STACK_H
+#define STACK_H
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// 基于数组实现的栈, 说明见1-栈.cpp.
+// 模板参数N大于0时，前N个元素存放在栈对象内部的数组中，超过N个元素时才在堆上申请内存。
+// 遍历二叉树/深度优先搜索时使用的栈通常只有几十个元素，定义为局部变量的Stack<T, 64>在整个
+// 过程中都不需要申请内存。N为0时与原来的栈相同，所有的元素都在堆上。
+// SegmentedStack<T>是分段的栈，说明见11-分段栈.cpp.
+//
+/*************************   栈内部的数组    ****************************/
+template <typename T, size_t N>
+struct StackInlineStorage
+{
+	T* Data() { return reinterpret_cast<T*>(m_buffer); }
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type m_buffer[N];
+};
+
+template <typename T>
+struct StackInlineStorage<T, 0>
+{
+	T* Data() { return nullptr; }
+};
+
+/*************************   stack类的定义     ****************************/
+// 定义一个栈的模板类
+template <typename T, size_t N = 0>
+class Stack
+{
+public:
+	Stack();
+	explicit Stack(size_t capicity, bool bGrowable = false);
+	~Stack();
+
+	void Push(const T& Value);
+	void Push(T&& Value);
+	template <typename... Args>
+	void Emplace(Args&&... args);			// 使用参数args直接在栈顶构造元素
+	void Pop();
+	T& Top();
+	const T& Top() const;
+
+	bool Empty() const;
+	bool Full() const;
+	size_t Size() const;
+	size_t Capicity() const;
+	bool Growable() const;
+	bool IsInline() const;					// 元素是否存放在栈对象内部
+
+	void Reserve(size_t capicity);			// 保证容量至少为capicity
+	void ShrinkToFit();						// 可增长的栈释放多余的容量
+
+private:
+	Stack(const Stack&);
+	Stack& operator=(const Stack&);
+
+	T* Allocate(size_t capicity);			// 容量不超过N时使用内部的数组，否则在堆上申请
+	void Deallocate(T* pArray);
+	template <typename... Args>
+	void GrowAndEmplace(Args&&... args);	// 扩大容量并在栈顶构造元素
+	void MoveElementsTo(T* pNewArray);		// 把所有的元素移动到新的内存中
+	void Reallocate(size_t capicity);		// 把元素移动到一块容量为capicity的新内存中
+
+	size_t m_nCapicity;		// 数组最大容量
+	size_t m_nSize;			// 当前数组内包含的元素个数
+	T* m_pArray;			// 一维数组的指针, 只有前m_nSize个位置上构造了元素
+	bool m_bGrowable;		// 栈满时是否自动增长
+	StackInlineStorage<T, N> m_inlineStorage;
+};
+
+/*************************   stack类的的实现     ****************************/
+// 构造与析构函数的定义
+template <typename T, size_t N>
+Stack<T, N>::Stack()
+{
+	// 没有内部数组时默认的容量大小为1000; 有内部数组时默认使用内部的数组，满了之后自动增长.
+	m_nCapicity = N == 0 ? 1000 : N;
+	m_nSize = 0;
+	m_pArray = Allocate(m_nCapicity);
+	m_bGrowable = N != 0;
+}
+
+template <typename T, size_t N>
+Stack<T, N>::Stack(size_t capicity, bool bGrowable)
+{
+	m_nCapicity = capicity < N ? N : capicity;
+	m_nSize = 0;
+	m_pArray = Allocate(m_nCapicity);
+	m_bGrowable = bGrowable;
+}
+
+template <typename T, size_t N>
+Stack<T, N>::~Stack()
+{
+	while (!Empty())
+		Pop();
+	Deallocate(m_pArray);
+	m_pArray = nullptr;
+}
+
+// 入栈/出栈/获取栈顶元素的函数定义
+template <typename T, size_t N>
+void Stack<T, N>::Push(const T& value)
+{
+	Emplace(value);
+}
+
+template <typename T, size_t N>
+void Stack<T, N>::Push(T&& value)
+{
+	Emplace(std::move(value));
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+void Stack<T, N>::Emplace(Args&&... args)
+{
+	// 栈否为满的判断, 可增长的栈把容量扩大为原来的两倍
+	if (m_nSize < m_nCapicity)
+	{
+		::new (static_cast<void*>(m_pArray + m_nSize)) T(std::forward<Args>(args)...);
+		++m_nSize;
+	}
+	else if (m_bGrowable)
+		GrowAndEmplace(std::forward<Args>(args)...);
+	else
+		std::cerr << "栈为满，入栈失败" << std::endl;
+}
+
+// 参数可能引用栈中的元素(例如Push(Top())), 所以先在新内存中构造新元素，再移动原来的元素,
+// 最后才释放原来的内存。
+template <typename T, size_t N>
+template <typename... Args>
+void Stack<T, N>::GrowAndEmplace(Args&&... args)
+{
+	size_t _nNewCapicity = m_nCapicity == 0 ? 8 : 2 * m_nCapicity;
+	T* _pNewArray = Allocate(_nNewCapicity);
+	try
+	{
+		::new (static_cast<void*>(_pNewArray + m_nSize)) T(std::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		Deallocate(_pNewArray);
+		throw;
+	}
+
+	try
+	{
+		MoveElementsTo(_pNewArray);
+	}
+	catch (...)
+	{
+		_pNewArray[m_nSize].~T();
+		Deallocate(_pNewArray);
+		throw;
+	}
+	Deallocate(m_pArray);
+	m_pArray = _pNewArray;
+	m_nCapicity = _nNewCapicity;
+	++m_nSize;
+}
+
+template <typename T, size_t N>
+void Stack<T, N>::Pop()
+{
+	// 栈否为空的判断
+	if (Empty())
+		std::cerr << "栈为空，出栈失败" << std::endl;
+	else
+		m_pArray[--m_nSize].~T();
+}
+
+template <typename T, size_t N>
+T& Stack<T, N>::Top()
+{
+	if (Empty())
+		throw std::out_of_range("栈空，不存在栈顶元素");
+	else
+		return m_pArray[m_nSize - 1];
+}
+
+template <typename T, size_t N>
+const T& Stack<T, N>::Top() const
+{
+	if (Empty())
+		throw std::out_of_range("栈空，不存在栈顶元素");
+	else
+		return m_pArray[m_nSize - 1];
+}
+
+// 栈空/栈满/栈内元素个数的相关函数
+template <typename T, size_t N>
+bool Stack<T, N>::Empty() const
+{
+	return 0 == m_nSize;
+}
+
+template <typename T, size_t N>
+bool Stack<T, N>::Full() const
+{
+	return !m_bGrowable && m_nSize == m_nCapicity;
+}
+
+template <typename T, size_t N>
+size_t Stack<T, N>::Size() const
+{
+	return m_nSize;
+}
+
+template <typename T, size_t N>
+size_t Stack<T, N>::Capicity() const
+{
+	return m_nCapicity;
+}
+
+template <typename T, size_t N>
+bool Stack<T, N>::Growable() const
+{
+	return m_bGrowable;
+}
+
+template <typename T, size_t N>
+bool Stack<T, N>::IsInline() const
+{
+	return N != 0 && m_nCapicity == N;
+}
+
+// 容量相关的函数
+template <typename T, size_t N>
+void Stack<T, N>::Reserve(size_t capicity)
+{
+	if (capicity > m_nCapicity)
+		Reallocate(capicity);
+}
+
+template <typename T, size_t N>
+void Stack<T, N>::ShrinkToFit()
+{
+	// 固定容量的栈的容量就是它的最大容量，不能缩小; 元素个数不超过N时移回内部的数组
+	if (!m_bGrowable || m_nCapicity == N)
+		return;
+	if (m_nSize <= N)
+		Reallocate(N);
+	else if (m_nSize < m_nCapicity)
+		Reallocate(m_nSize);
+}
+
+// 只有容量恰好为N时才使用内部的数组，所以根据容量就可以知道内存是否需要释放
+template <typename T, size_t N>
+T* Stack<T, N>::Allocate(size_t capicity)
+{
+	if (N != 0 && capicity == N)
+		return m_inlineStorage.Data();
+	return static_cast<T*>(::operator new(sizeof(T) * capicity));
+}
+
+template <typename T, size_t N>
+void Stack<T, N>::Deallocate(T* pArray)
+{
+	if (pArray != m_inlineStorage.Data())
+		::operator delete(pArray);
+}
+
+template <typename T, size_t N>
+void Stack<T, N>::Reallocate(size_t capicity)
+{
+	T* _pNewArray = Allocate(capicity);
+	try
+	{
+		MoveElementsTo(_pNewArray);
+	}
+	catch (...)
+	{
+		Deallocate(_pNewArray);
+		throw;
+	}
+	Deallocate(m_pArray);
+	m_pArray = _pNewArray;
+	m_nCapicity = capicity;
+}
+
+// 移动构造函数不会抛出异常时移动元素，否则拷贝元素，拷贝失败时原来的元素保持不变。
+// 成功之后原来的元素都被析构，但是原来的内存由调用者释放。
+template <typename T, size_t N>
+void Stack<T, N>::MoveElementsTo(T* pNewArray)
+{
+	size_t i = 0;
+	try
+	{
+		for (; i < m_nSize; ++i)
+			::new (static_cast<void*>(pNewArray + i)) T(std::move_if_noexcept(m_pArray[i]));
+	}
+	catch (...)
+	{
+		while (i > 0)
+			pNewArray[--i].~T();
+		throw;
+	}
+
+	for (i = 0; i < m_nSize; ++i)
+		m_pArray[i].~T();
+}
+
+/*************************   分段栈的定义     ****************************/
+// 元素存放在一个个固定大小(ChunkSize个元素)的内存块中，内存块之间用指针链接起来。栈满时
+// 链接一个新的内存块，不需要移动已有的元素，元素的地址在出栈之前一直不变。
+template <typename T, size_t ChunkSize = 1024>
+class SegmentedStack
+{
+public:
+	SegmentedStack();
+	~SegmentedStack();
+
+	void Push(const T& value);
+	void Push(T&& value);
+	template <typename... Args>
+	void Emplace(Args&&... args);			// 使用参数args直接在栈顶构造元素
+	void Pop();
+	T& Top();
+	const T& Top() const;
+
+	bool Empty() const;
+	size_t Size() const;
+	size_t ChunkCount() const;				// 正在使用的内存块的个数(不包括备用的内存块)
+
+private:
+	SegmentedStack(const SegmentedStack&);
+	SegmentedStack& operator=(const SegmentedStack&);
+
+	struct Chunk
+	{
+		Chunk* m_pPrev;						// 下面的内存块
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type m_elements[ChunkSize];
+		T* Begin() { return reinterpret_cast<T*>(m_elements); }
+		T* End() { return Begin() + ChunkSize; }
+	};
+
+	void PushChunk();						// 当前的内存块满了，链接一个新的内存块
+	void PopChunk();						// 当前的内存块空了，回到下面的内存块
+
+	Chunk* m_pTopChunk;		// 栈顶所在的内存块
+	Chunk* m_pSpareChunk;	// 备用的内存块，避免在内存块的边界上反复入栈出栈时反复申请释放
+	T* m_pTop;				// 栈顶元素的下一个位置
+	T* m_pBegin;			// 当前内存块的起始位置
+	T* m_pEnd;				// 当前内存块的结束位置
+	size_t m_nSize;
+	size_t m_nChunks;
+};
+
+/*************************   分段栈的实现     ****************************/
+template <typename T, size_t ChunkSize>
+SegmentedStack<T, ChunkSize>::SegmentedStack()
+{
+	m_pTopChunk = nullptr;
+	m_pSpareChunk = nullptr;
+	m_pTop = nullptr;
+	m_pBegin = nullptr;
+	m_pEnd = nullptr;
+	m_nSize = 0;
+	m_nChunks = 0;
+}
+
+template <typename T, size_t ChunkSize>
+SegmentedStack<T, ChunkSize>::~SegmentedStack()
+{
+	while (!Empty())
+		Pop();
+	delete m_pTopChunk;
+	delete m_pSpareChunk;
+}
+
+template <typename T, size_t ChunkSize>
+void SegmentedStack<T, ChunkSize>::Push(const T& value)
+{
+	Emplace(value);
+}
+
+template <typename T, size_t ChunkSize>
+void SegmentedStack<T, ChunkSize>::Push(T&& value)
+{
+	Emplace(std::move(value));
+}
+
+template <typename T, size_t ChunkSize>
+template <typename... Args>
+void SegmentedStack<T, ChunkSize>::Emplace(Args&&... args)
+{
+	if (m_pTop == m_pEnd)
+		PushChunk();
+	::new (static_cast<void*>(m_pTop)) T(std::forward<Args>(args)...);
+	++m_pTop;
+	++m_nSize;
+}
+
+template <typename T, size_t ChunkSize>
+void SegmentedStack<T, ChunkSize>::Pop()
+{
+	// 栈否为空的判断
+	if (Empty())
+	{
+		std::cerr << "栈为空，出栈失败" << std::endl;
+		return;
+	}
+
+	(--m_pTop)->~T();
+	--m_nSize;
+	if (m_pTop == m_pBegin && m_pTopChunk->m_pPrev != nullptr)
+		PopChunk();
+}
+
+template <typename T, size_t ChunkSize>
+T& SegmentedStack<T, ChunkSize>::Top()
+{
+	if (Empty())
+		throw std::out_of_range("栈空，不存在栈顶元素");
+	else
+		return *(m_pTop - 1);
+}
+
+template <typename T, size_t ChunkSize>
+const T& SegmentedStack<T, ChunkSize>::Top() const
+{
+	if (Empty())
+		throw std::out_of_range("栈空，不存在栈顶元素");
+	else
+		return *(m_pTop - 1);
+}
+
+template <typename T, size_t ChunkSize>
+bool SegmentedStack<T, ChunkSize>::Empty() const
+{
+	return 0 == m_nSize;
+}
+
+template <typename T, size_t ChunkSize>
+size_t SegmentedStack<T, ChunkSize>::Size() const
+{
+	return m_nSize;
+}
+
+template <typename T, size_t ChunkSize>
+size_t SegmentedStack<T, ChunkSize>::ChunkCount() const
+{
+	return m_nChunks;
+}
+
+// 优先使用备用的内存块，没有时才申请新的内存块
+template <typename T, size_t ChunkSize>
+void SegmentedStack<T, ChunkSize>::PushChunk()
+{
+	Chunk* _pChunk = m_pSpareChunk;
+	if (_pChunk != nullptr)
+		m_pSpareChunk = nullptr;
+	else
+		_pChunk = new Chunk;
+
+	_pChunk->m_pPrev = m_pTopChunk;
+	m_pTopChunk = _pChunk;
+	m_pBegin = m_pTop = _pChunk->Begin();
+	m_pEnd = _pChunk->End();
+	++m_nChunks;
+}
+
+// 空出来的内存块留作备用，原来备用的内存块释放掉，所以最多只有一个备用的内存块。
+// 最下面的内存块一直保留，栈为空时也不释放。
+template <typename T, size_t ChunkSize>
+void SegmentedStack<T, ChunkSize>::PopChunk()
+{
+	Chunk* _pChunk = m_pTopChunk;
+	m_pTopChunk = _pChunk->m_pPrev;
+	delete m_pSpareChunk;
+	m_pSpareChunk = _pChunk;
+
+	m_pBegin = m_pTopChunk->Begin();
+	m_pEnd = m_pTop = m_pTopChunk->End();
+	--m_nChunks;
+}
+
+#endif	// STACK_H